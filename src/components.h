@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>              // for uint32_t
+
+// Component classes that are enumerated, scheduled and sampled independently.
+typedef uint32_t component_flags_t;
+enum : component_flags_t
+{
+    COMPONENT_ENGINES = 1 << 0,
+    COMPONENT_POWER = 1 << 1,
+    COMPONENT_PSUS = 1 << 2,
+    COMPONENT_MEMORY = 1 << 3,
+    COMPONENT_THERMAL = 1 << 4,
+    COMPONENT_PROCESSES = 1 << 5,
+    COMPONENT_FREQUENCY = 1 << 6,
+    COMPONENT_PCI = 1 << 7,
+    COMPONENT_RAS = 1 << 8,
+    COMPONENT_COUNT = 9,
+    COMPONENT_ALL = (1 << COMPONENT_COUNT) - 1
+};
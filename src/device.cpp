@@ -1,11 +1,17 @@
 #include "device.h"
 #include "helpers.h"
+#include "profile.h"
+#include <algorithm>            // for max, min
+#include <atomic>               // for atomic
+#include <cstdio>               // for snprintf
+#include <cstring>              // for memset
 #include <iostream>             // for cerr, cout
 #include <stdexcept>            // for runtime_error
 
 bool Device::initializeDevice()
 {
     ze_result_t ret;
+    auto start = std::chrono::steady_clock::now();
 
     ret = zesDeviceGetProperties(device, &deviceProperties);
     if (ret != ZE_RESULT_SUCCESS)
@@ -21,6 +27,238 @@ bool Device::initializeDevice()
         return false;
     }
 
+    processMonitor.setPciAddress(getLabel());
+
+    // Recorded by hand since the label needs the PCI address just read.
+    StartupProfile::instance().record("device " + getLabel() + " properties", start, std::chrono::steady_clock::now());
+
+    return true;
+}
+
+void Device::initializeComponents(component_flags_t components, ThreadPool *pool)
+{
+    components &= ~initialized.load(std::memory_order_acquire);
+    if (components == 0)
+    {
+        return;
+    }
+
+    // Each component class is enumerated exactly once, even if several
+    // threads ask at the same time; latecomers wait in call_once.
+    auto initialize = [this](uint32_t bit) {
+        std::call_once(componentOnce[bit], [this, bit]() {
+            if (enumerateComponent(1 << bit))
+            {
+                createHistory(1 << bit);
+            }
+            initialized.fetch_or(1 << bit, std::memory_order_release);
+        });
+    };
+
+    if (pool == nullptr)
+    {
+        for (uint32_t bit = 0; bit < COMPONENT_COUNT; ++bit)
+        {
+            if (components & (1 << bit))
+            {
+                initialize(bit);
+            }
+        }
+        return;
+    }
+
+    // The enumerations don't depend on each other, and each one also primes
+    // its components with an initial stats query, so run them concurrently.
+    TaskGroup group(*pool);
+    for (uint32_t bit = 0; bit < COMPONENT_COUNT; ++bit)
+    {
+        if (components & (1 << bit))
+        {
+            group.run([&initialize, bit]() { initialize(bit); });
+        }
+    }
+    group.wait();
+}
+
+bool Device::enumerateComponent(component_flags_t component)
+{
+    bool ok = true;
+    try
+    {
+        switch (component)
+        {
+        case COMPONENT_ENGINES:
+            ok = enumerateEngines();
+            break;
+        case COMPONENT_POWER:
+            ok = enumeratePowerDomains();
+            break;
+        case COMPONENT_PSUS:
+            ok = enumeratePsus();
+            break;
+        case COMPONENT_MEMORY:
+            ok = enumerateMemoryModules();
+            break;
+        case COMPONENT_THERMAL:
+            ok = enumerateTemperatureSensors();
+            break;
+        case COMPONENT_FREQUENCY:
+            ok = enumerateFrequencyDomains();
+            break;
+        case COMPONENT_PCI:
+            ok = enumeratePciLink();
+            break;
+        case COMPONENT_RAS:
+            ok = enumerateRasErrorSets();
+            break;
+        default:
+            // Processes need no enumeration; requiring them enables sampling.
+            break;
+        }
+    }
+    catch (const std::runtime_error &e)
+    {
+        // Engine/PowerDomain/PSU/FrequencyDomain/RasErrorSet constructors throw if their first query fails.
+        std::cerr << "Device " << getLabel() << ": " << e.what() << std::endl;
+        ok = false;
+    }
+
+    if (!ok)
+    {
+        // Leave the component empty rather than half populated.
+        switch (component)
+        {
+        case COMPONENT_ENGINES:
+            engines.clear();
+            break;
+        case COMPONENT_POWER:
+            powerDomains.clear();
+            break;
+        case COMPONENT_PSUS:
+            psus.clear();
+            break;
+        case COMPONENT_MEMORY:
+            memoryModules.clear();
+            break;
+        case COMPONENT_THERMAL:
+            temperatureMonitor.reset();
+            fans.clear();
+            break;
+        case COMPONENT_FREQUENCY:
+            frequencyDomains.clear();
+            break;
+        case COMPONENT_PCI:
+            pciLink.reset();
+            break;
+        case COMPONENT_RAS:
+            rasErrorSets.clear();
+            break;
+        default:
+            break;
+        }
+    }
+
+    return ok;
+}
+
+namespace
+{
+// Keeps any one history at or under 512KB even for very short periods.
+const size_t MAX_HISTORY_POINTS = 1 << 18;
+
+size_t historyCapacity(std::chrono::milliseconds length, std::chrono::milliseconds period)
+{
+    return std::min<size_t>(length / period, MAX_HISTORY_POINTS);
+}
+} // namespace
+
+void Device::setHistory(std::chrono::seconds length, const std::vector<std::chrono::milliseconds> &statisticsWindows,
+                        const SamplingSchedule &schedule)
+{
+    historyLength = length;
+    this->statisticsWindows = statisticsWindows;
+    enginePeriod = std::max(schedule.getPeriod(SCHEDULE_DISPLAY), schedule.getPeriod(COMPONENT_ENGINES));
+    powerPeriod = schedule.getPeriod(COMPONENT_POWER);
+    temperaturePeriod = schedule.getPeriod(COMPONENT_THERMAL);
+}
+
+void Device::createHistory(component_flags_t component)
+{
+    if (historyLength.count() == 0)
+    {
+        return;
+    }
+
+    switch (component)
+    {
+    case COMPONENT_ENGINES:
+        for (const auto &engine : engines)
+        {
+            engineHistory.emplace_back(
+                std::make_unique<UtilizationHistory>(historyCapacity(historyLength, enginePeriod)));
+            engineStatistics.emplace_back(std::make_unique<MetricStatistics>(statisticsWindows, enginePeriod));
+            engineWindows.push_back(engine->getWindowCount());
+        }
+        break;
+    case COMPONENT_POWER:
+        for (size_t i = 0; i < powerDomains.size(); ++i)
+        {
+            powerHistory.emplace_back(std::make_unique<PowerHistory>(historyCapacity(historyLength, powerPeriod)));
+            powerStatistics.emplace_back(std::make_unique<MetricStatistics>(statisticsWindows, powerPeriod));
+        }
+        break;
+    case COMPONENT_THERMAL:
+        for (uint32_t i = 0; temperatureMonitor && i < temperatureMonitor->getSensorCount(); ++i)
+        {
+            temperatureHistory.emplace_back(
+                std::make_unique<TemperatureHistory>(historyCapacity(historyLength, temperaturePeriod)));
+            temperatureStatistics.emplace_back(
+                std::make_unique<MetricStatistics>(statisticsWindows, temperaturePeriod));
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+const UtilizationHistory *Device::getEngineHistory(uint32_t index) const
+{
+    return isInitialized(COMPONENT_ENGINES) && index < engineHistory.size() ? engineHistory[index].get() : nullptr;
+}
+
+const PowerHistory *Device::getPowerDomainHistory(uint32_t index) const
+{
+    return isInitialized(COMPONENT_POWER) && index < powerHistory.size() ? powerHistory[index].get() : nullptr;
+}
+
+const TemperatureHistory *Device::getTemperatureHistory(uint32_t index) const
+{
+    return isInitialized(COMPONENT_THERMAL) && index < temperatureHistory.size() ? temperatureHistory[index].get() : nullptr;
+}
+
+size_t Device::getHistoryMemoryUsage() const
+{
+    size_t total = 0;
+    for (uint32_t i = 0; getEngineHistory(i) != nullptr; ++i)
+        total += getEngineHistory(i)->getMemoryUsage();
+    for (uint32_t i = 0; getPowerDomainHistory(i) != nullptr; ++i)
+        total += getPowerDomainHistory(i)->getMemoryUsage();
+    for (uint32_t i = 0; getTemperatureHistory(i) != nullptr; ++i)
+        total += getTemperatureHistory(i)->getMemoryUsage();
+    return total;
+}
+
+std::string Device::getLabel() const
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%04x:%02x:%02x.%x", pciProperties.address.domain,
+                  pciProperties.address.bus, pciProperties.address.device, pciProperties.address.function);
+    return buffer;
+}
+
+bool Device::enumerateEngines()
+{
+    StartupProfile::Scope scope("device " + getLabel() + " engines");
     uint32_t count = 0;
     ze_result_t result;
 
@@ -45,10 +283,19 @@ bool Device::initializeDevice()
         for (size_t i = 0; i < count; ++i) 
         {
             engines.emplace_back(std::make_unique<Engine>(engineHandles[i]));
+            engines.back()->setDecimation(engineWindow, engineSmoothing);
         }
     }
 
-    count = 0;
+    return true;
+}
+
+bool Device::enumeratePowerDomains()
+{
+    StartupProfile::Scope scope("device " + getLabel() + " power domains");
+    uint32_t count = 0;
+    ze_result_t result;
+
     result = zesDeviceEnumPowerDomains(device, &count, nullptr);
     if (result != ZE_RESULT_SUCCESS)
     {
@@ -69,11 +316,19 @@ bool Device::initializeDevice()
 
         for (size_t i = 0; i < count; ++i)
         {
-            powerDomains.emplace_back(std::make_unique<PowerDomain>(powerHandles[i]));
+            powerDomains.emplace_back(std::make_unique<PowerDomain>(powerHandles[i], powerWindow));
         }
     }
 
-    count = 0;
+    return true;
+}
+
+bool Device::enumeratePsus()
+{
+    StartupProfile::Scope scope("device " + getLabel() + " power supply units");
+    uint32_t count = 0;
+    ze_result_t result;
+
     result = zesDeviceEnumPsus(device, &count, nullptr);
     if (result != ZE_RESULT_SUCCESS)
     {
@@ -106,11 +361,19 @@ bool Device::initializeDevice()
         }
     }
 
-    count = 0;
+    return true;
+}
+
+bool Device::enumerateMemoryModules()
+{
+    StartupProfile::Scope scope("device " + getLabel() + " memory modules");
+    uint32_t count = 0;
+    ze_result_t result;
+
     result = zesDeviceEnumMemoryModules(device, &count, nullptr);
     if (result != ZE_RESULT_SUCCESS)
     {
-        // Not all hardware supports PSUs
+        // Not all hardware exposes memory modules
         if (result == ZE_RESULT_ERROR_UNSUPPORTED_FEATURE)
         {
             count = 0;
@@ -124,43 +387,484 @@ bool Device::initializeDevice()
 
     if (count > 0)
     {
-        memoryHandles.resize(count);
+        std::unique_ptr<zes_mem_handle_t[]> memoryHandles = std::make_unique<zes_mem_handle_t[]>(count);
+
+        result = zesDeviceEnumMemoryModules(device, &count, memoryHandles.get());
+        if (result != ZE_RESULT_SUCCESS)
+        {
+            std::cerr << "Failed to enumerate memory modules: " << std::hex << result << " (" << ze_error_to_str(result) << ")" << std::endl;
+            return false;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            memoryModules.emplace_back(std::make_unique<MemoryModule>(memoryHandles[i]));
+        }
+    }
+
+    return true;
+}
+
+bool Device::enumerateTemperatureSensors()
+{
+    StartupProfile::Scope scope("device " + getLabel() + " temperature sensors");
+    try
+    {
+        temperatureMonitor = std::make_unique<TemperatureMonitor>(device);
+    }
+    catch (const std::runtime_error &)
+    {
+        return false;
+    }
+    enumerateFans();
+    return true;
+}
+
+void Device::enumerateFans()
+{
+    uint32_t count = 0;
+    ze_result_t result;
+
+    // Fans are extra detail for the thermal view; without them the sensors
+    // are still worth showing.
+    result = zesDeviceEnumFans(device, &count, nullptr);
+    if (result != ZE_RESULT_SUCCESS)
+    {
+        if (result != ZE_RESULT_ERROR_UNSUPPORTED_FEATURE)
+        {
+            std::cerr << "Failed to enumerate fans: " << std::hex << result << " (" << ze_error_to_str(result) << ")" << std::endl;
+        }
+        return;
+    }
+
+    if (count > 0)
+    {
+        std::unique_ptr<zes_fan_handle_t[]> fanHandles = std::make_unique<zes_fan_handle_t[]>(count);
+
+        result = zesDeviceEnumFans(device, &count, fanHandles.get());
+        if (result != ZE_RESULT_SUCCESS)
+        {
+            std::cerr << "Failed to enumerate fans: " << std::hex << result << " (" << ze_error_to_str(result) << ")" << std::endl;
+            return;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            try
+            {
+                fans.emplace_back(std::make_unique<Fan>(fanHandles[i]));
+            }
+            catch (const std::runtime_error &)
+            {
+                // Skip just this fan.
+            }
+        }
+    }
+}
+
+void Device::attributeEnergy(DeviceSnapshot &snapshot)
+{
+    if (!isInitialized(COMPONENT_POWER) || powerDomains.empty())
+    {
+        for (ProcessSample &process : snapshot.processes)
+        {
+            process.energy = -1;
+        }
+        snapshot.idleEnergy = -1;
+        return;
+    }
+
+    // Sub-device domains are already counted in the whole-card domain where
+    // there is one.
+    double deviceEnergy = 0, subdeviceEnergy = 0;
+    bool haveDevice = false;
+    for (const auto &domain : powerDomains)
+    {
+        if (domain->getPowerDomainProperties()->onSubdevice)
+        {
+            subdeviceEnergy += domain->getSessionEnergy();
+        }
+        else
+        {
+            deviceEnergy += domain->getSessionEnergy();
+            haveDevice = true;
+        }
+    }
+
+    // Engine busy time from fdinfo where the driver gives it. Without it,
+    // every process sysman shows on an engine gets an equal share.
+    bool haveUtilization = false;
+    processActivity.resize(processMonitor.getProcessCount());
+    for (uint32_t i = 0; i < processMonitor.getProcessCount(); ++i)
+    {
+        const ProcessInfo *info = processMonitor.getProcessInfo(i);
+        double weight = -1;
+        for (float utilization : info->drm_usage.utilization)
+        {
+            if (info->drm_usage.valid && utilization >= 0)
+            {
+                weight = std::max(weight, 0.0) + utilization;
+            }
+        }
+        haveUtilization |= weight >= 0;
+        processActivity[i] = EnergyAttribution::Activity{info->pid, info->getStartTime(), weight,
+                                                         &info->getProcessName()};
+    }
+    if (!haveUtilization)
+    {
+        for (uint32_t i = 0; i < processMonitor.getProcessCount(); ++i)
+        {
+            processActivity[i].weight = processMonitor.getProcessInfo(i)->getProcessState()->engines != 0 ? 1.0 : 0.0;
+        }
+    }
+
+    energyAttribution.attribute(haveDevice ? deviceEnergy : subdeviceEnergy, snapshot.timestamp, processActivity);
+    for (uint32_t i = 0; i < snapshot.processes.size(); ++i)
+    {
+        snapshot.processes[i].energy = energyAttribution.getProcessEnergy(processActivity[i].pid,
+                                                                          processActivity[i].startTime);
+    }
+    snapshot.idleEnergy = energyAttribution.getIdleEnergy();
+}
+
+bool Device::enumerateFrequencyDomains()
+{
+    StartupProfile::Scope scope("device " + getLabel() + " frequency domains");
+    uint32_t count = 0;
+    ze_result_t result;
+
+    result = zesDeviceEnumFrequencyDomains(device, &count, nullptr);
+    if (result != ZE_RESULT_SUCCESS)
+    {
+        // Not all hardware exposes frequency domains
+        if (result == ZE_RESULT_ERROR_UNSUPPORTED_FEATURE)
+        {
+            count = 0;
+        }
+        else
+        {
+            std::cerr << "Failed to enumerate frequency domains: " << std::hex << result << " (" << ze_error_to_str(result) << ")" << std::endl;
+            return false;
+        }
+    }
+
+    if (count > 0)
+    {
+        std::unique_ptr<zes_freq_handle_t[]> frequencyHandles = std::make_unique<zes_freq_handle_t[]>(count);
 
-        result = zesDeviceEnumMemoryModules(device, &count, memoryHandles.data());
+        result = zesDeviceEnumFrequencyDomains(device, &count, frequencyHandles.get());
         if (result != ZE_RESULT_SUCCESS)
         {
-            std::cerr << "Failed to enumerate power memory modules: " << std::hex << result << " (" << ze_error_to_str(result) << ")" << std::endl;
+            std::cerr << "Failed to enumerate frequency domains: " << std::hex << result << " (" << ze_error_to_str(result) << ")" << std::endl;
             return false;
         }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            frequencyDomains.emplace_back(std::make_unique<FrequencyDomain>(frequencyHandles[i]));
+        }
     }
 
     return true;
 }
 
-const zes_mem_state_t Device::getMemoryState()
+bool Device::enumeratePciLink()
 {
-    if (memoryCached) {
-        return cachedMemoryState;
+    StartupProfile::Scope scope("device " + getLabel() + " PCI link");
+    // The properties were read with the device; the link only adds the
+    // state and counter queries.
+    pciLink = std::make_unique<PciLink>(device, pciProperties);
+    return true;
+}
+
+bool Device::enumerateRasErrorSets()
+{
+    StartupProfile::Scope scope("device " + getLabel() + " RAS error sets");
+    uint32_t count = 0;
+    ze_result_t result;
+
+    result = zesDeviceEnumRasErrorSets(device, &count, nullptr);
+    if (result != ZE_RESULT_SUCCESS)
+    {
+        // Not all hardware (or every driver configuration) exposes RAS
+        if (result == ZE_RESULT_ERROR_UNSUPPORTED_FEATURE)
+        {
+            count = 0;
+        }
+        else
+        {
+            std::cerr << "Failed to enumerate RAS error sets: " << std::hex << result << " (" << ze_error_to_str(result) << ")" << std::endl;
+            return false;
+        }
+    }
+
+    if (count > 0)
+    {
+        std::unique_ptr<zes_ras_handle_t[]> rasHandles = std::make_unique<zes_ras_handle_t[]>(count);
+
+        result = zesDeviceEnumRasErrorSets(device, &count, rasHandles.get());
+        if (result != ZE_RESULT_SUCCESS)
+        {
+            std::cerr << "Failed to enumerate RAS error sets: " << std::hex << result << " (" << ze_error_to_str(result) << ")" << std::endl;
+            return false;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            rasErrorSets.emplace_back(std::make_unique<RasErrorSet>(rasHandles[i]));
+        }
     }
 
-    zes_mem_state_t ret;
-    ret.free = 0;
-    ret.size = 0;
+    return true;
+}
 
-    for (uint32_t i = 0; i < memoryHandles.size(); ++i)
+zes_mem_state_t Device::getMemoryState() const
+{
+    zes_mem_state_t total;
+    std::memset(&total, 0, sizeof(total));
+    total.stype = ZES_STRUCTURE_TYPE_MEM_STATE;
+
+    for (uint32_t i = 0; i < getMemoryModuleCount(); ++i)
+    {
+        total.free += memoryModules[i]->getMemoryState()->free;
+        total.size += memoryModules[i]->getMemoryState()->size;
+    }
+
+    return total;
+}
+
+void Device::sample(uint64_t sequence, component_flags_t components, ThreadPool *pool)
+{
+    initializeComponents(required.load(std::memory_order_relaxed), pool);
+    component_flags_t active = initialized.load(std::memory_order_acquire);
+
+    const DeviceSnapshot &previous = snapshots.peekPublished();
+    // A component that just came up has nothing to carry over.
+    component_flags_t due = (components | ~previous.components) & active;
+
+    // The slot being written is invisible to readers until publish(), and
+    // its vectors keep their capacity from earlier ticks, so carrying values
+    // over is a copy into existing storage.
+    DeviceSnapshot &snapshot = snapshots.beginWrite();
+    snapshot.timestamp = std::chrono::steady_clock::now();
+    snapshot.sequence = sequence;
+    snapshot.components = active;
+    snapshot.sampled = due;
+
+    if (due & COMPONENT_ENGINES)
+    {
+        snapshot.engineUtilization.resize(getEngineCount());
+        // Only engines that completed a window get new statistics.
+        snapshot.engineStatistics = previous.engineStatistics;
+        snapshot.engineStatistics.resize(engineStatistics.size());
+        for (size_t i = 0; i < snapshot.engineUtilization.size(); ++i)
+        {
+            engines[i]->updateStats();
+            snapshot.engineUtilization[i] = engines[i]->getEngineUtilization();
+            // Record once per completed display window, not per fast sample.
+            if (i < engineHistory.size() && engines[i]->getWindowCount() != engineWindows[i])
+            {
+                engineWindows[i] = engines[i]->getWindowCount();
+                engineHistory[i]->push(snapshot.engineUtilization[i]);
+                engineStatistics[i]->add(snapshot.engineUtilization[i]);
+                engineStatistics[i]->summarize(snapshot.engineStatistics[i]);
+            }
+        }
+    }
+    else
+    {
+        snapshot.engineUtilization = previous.engineUtilization;
+        snapshot.engineStatistics = previous.engineStatistics;
+    }
+
+    if (due & COMPONENT_POWER)
+    {
+        snapshot.powerDomains.resize(getPowerDomainCount());
+        snapshot.powerDomainStatistics.resize(powerStatistics.size());
+        for (size_t i = 0; i < snapshot.powerDomains.size(); ++i)
+        {
+            powerDomains[i]->updateStats();
+            PowerSample &domain = snapshot.powerDomains[i];
+            domain.power = powerDomains[i]->getPower();
+            domain.sessionEnergy = powerDomains[i]->getSessionEnergy();
+            if (i < powerHistory.size())
+            {
+                powerHistory[i]->push(domain.power);
+                powerStatistics[i]->add(domain.power);
+                powerStatistics[i]->summarize(snapshot.powerDomainStatistics[i]);
+            }
+        }
+    }
+    else
+    {
+        snapshot.powerDomains = previous.powerDomains;
+        snapshot.powerDomainStatistics = previous.powerDomainStatistics;
+    }
+
+    if (due & COMPONENT_PSUS)
+    {
+        snapshot.psuStates.resize(getPSUCount());
+        for (size_t i = 0; i < snapshot.psuStates.size(); ++i)
+        {
+            psus[i]->updateStats();
+            snapshot.psuStates[i] = *psus[i]->getPSUState();
+        }
+    }
+    else
+    {
+        snapshot.psuStates = previous.psuStates;
+    }
+
+    if (due & COMPONENT_THERMAL)
+    {
+        snapshot.temperatures.resize(getTemperatureCount());
+        snapshot.temperatureSensors.resize(getTemperatureCount());
+        snapshot.temperatureStatistics.resize(temperatureStatistics.size());
+        if (!snapshot.temperatures.empty())
+        {
+            // A failing sensor keeps its last reading and is flagged; the
+            // rest are unaffected.
+            temperatureMonitor->updateTemperatures(snapshot.timestamp);
+            for (uint32_t i = 0; i < snapshot.temperatures.size(); ++i)
+            {
+                snapshot.temperatures[i] = temperatureMonitor->getTemperature(i);
+                TemperatureSample &sensor = snapshot.temperatureSensors[i];
+                sensor.valid = temperatureMonitor->isValid(i);
+                sensor.slope = temperatureMonitor->getSlope(i);
+                sensor.timeToThrottle = temperatureMonitor->getTimeToThrottle(i);
+                if (i < temperatureHistory.size())
+                {
+                    temperatureHistory[i]->push(snapshot.temperatures[i]);
+                    if (sensor.valid)
+                    {
+                        temperatureStatistics[i]->add(snapshot.temperatures[i]);
+                    }
+                    temperatureStatistics[i]->summarize(snapshot.temperatureStatistics[i]);
+                }
+            }
+        }
+
+        snapshot.fans.resize(getFanCount());
+        for (size_t i = 0; i < snapshot.fans.size(); ++i)
+        {
+            fans[i]->updateStats();
+            snapshot.fans[i].speed = fans[i]->getSpeed();
+            snapshot.fans[i].units = fans[i]->getUnits();
+            snapshot.fans[i].percent = fans[i]->getPercent();
+        }
+    }
+    else
+    {
+        snapshot.temperatures = previous.temperatures;
+        snapshot.temperatureSensors = previous.temperatureSensors;
+        snapshot.temperatureStatistics = previous.temperatureStatistics;
+        snapshot.fans = previous.fans;
+    }
+
+    if (due & COMPONENT_MEMORY)
     {
-        zes_mem_state_t memState;
-        ze_result_t result = zesMemoryGetState(memoryHandles[i], &memState);
-        if (result == ZE_RESULT_SUCCESS) {
-            ret.free += memState.free;
-            ret.size += memState.size;
+        snapshot.memoryModules.resize(getMemoryModuleCount());
+        for (size_t i = 0; i < snapshot.memoryModules.size(); ++i)
+        {
+            memoryModules[i]->updateStats();
+            MemorySample &module = snapshot.memoryModules[i];
+            module.state = *memoryModules[i]->getMemoryState();
+            module.readBandwidth = memoryModules[i]->getReadBandwidth();
+            module.writeBandwidth = memoryModules[i]->getWriteBandwidth();
+            module.maxBandwidth = memoryModules[i]->getMaxBandwidth();
         }
+        snapshot.memory = getMemoryState();
+    }
+    else
+    {
+        snapshot.memory = previous.memory;
+        snapshot.memoryModules = previous.memoryModules;
     }
 
-    if (ret.size > 0) {
-        cachedMemoryState = ret;
-        memoryCached = true;
+    if (due & COMPONENT_FREQUENCY)
+    {
+        snapshot.frequencyDomains.resize(getFrequencyDomainCount());
+        for (size_t i = 0; i < snapshot.frequencyDomains.size(); ++i)
+        {
+            frequencyDomains[i]->updateStats();
+            FrequencySample &domain = snapshot.frequencyDomains[i];
+            domain.state = *frequencyDomains[i]->getFrequencyState();
+            domain.throttleFraction = frequencyDomains[i]->getThrottleFraction();
+        }
+    }
+    else
+    {
+        snapshot.frequencyDomains = previous.frequencyDomains;
     }
 
-    return ret;
-}
\ No newline at end of file
+    if (due & COMPONENT_PCI)
+    {
+        snapshot.pci = PciSample();
+        if (pciLink)
+        {
+            pciLink->updateStats();
+            snapshot.pci.state = *pciLink->getPciState();
+            snapshot.pci.speed = pciLink->getSpeed();
+            snapshot.pci.degraded = pciLink->isDegraded();
+            snapshot.pci.rxBandwidth = pciLink->getRxBandwidth();
+            snapshot.pci.txBandwidth = pciLink->getTxBandwidth();
+            snapshot.pci.packetRate = pciLink->getPacketRate();
+            snapshot.pci.replayRate = pciLink->getReplayRate();
+        }
+    }
+    else
+    {
+        snapshot.pci = previous.pci;
+    }
+
+    if (due & COMPONENT_RAS)
+    {
+        snapshot.rasErrorSets.resize(getRasErrorSetCount());
+        for (size_t i = 0; i < snapshot.rasErrorSets.size(); ++i)
+        {
+            rasErrorSets[i]->updateStats();
+            RasSample &set = snapshot.rasErrorSets[i];
+            set.type = rasErrorSets[i]->getRasProperties()->type;
+            set.state = *rasErrorSets[i]->getRasState();
+            set.total = rasErrorSets[i]->getTotal();
+            set.delta = rasErrorSets[i]->getDelta();
+            set.rate = rasErrorSets[i]->getRate();
+            set.rising = rasErrorSets[i]->isRising();
+        }
+    }
+    else
+    {
+        snapshot.rasErrorSets = previous.rasErrorSets;
+    }
+
+    if (!(active & COMPONENT_PROCESSES))
+    {
+        snapshot.processes.clear();
+    }
+    else if (due & COMPONENT_PROCESSES)
+    {
+        processMonitor.updateProcessStats();
+        snapshot.processes.resize(processMonitor.getProcessCount());
+        for (uint32_t i = 0; i < processMonitor.getProcessCount(); ++i)
+        {
+            const ProcessInfo *info = processMonitor.getProcessInfo(i);
+            ProcessSample &process = snapshot.processes[i];
+            process.pid = info->pid;
+            process.name = info->getProcessName();
+            process.command_line = info->getCommandLine();
+            process.used_memory = info->used_memory;
+            process.shared_memory = info->shared_memory;
+            process.engines = info->getProcessState()->engines;
+            process.drm = info->drm_usage;
+        }
+        attributeEnergy(snapshot);
+    }
+    else
+    {
+        snapshot.processes = previous.processes;
+        snapshot.idleEnergy = previous.idleEnergy;
+    }
+
+    snapshot.sampleLatency = std::chrono::steady_clock::now() - snapshot.timestamp;
+    snapshots.publish();
+}
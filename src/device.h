@@ -1,23 +1,45 @@
 #pragma once
 
+#include "components.h"
+#include "energy_attribution.h"
 #include "engine.h"
+#include "fan.h"
+#include "frequency_domain.h"
+#include "history.h"
+#include "memory_module.h"
+#include "pci_link.h"
 #include "power_domain.h"
 #include "process.h"
 #include "psu.h"
+#include "ras_error_set.h"
+#include "schedule.h"
+#include "snapshot.h"
+#include "snapshot_buffer.h"
+#include "statistics.h"
 #include "temperature.h"
+#include "thread_pool.h"
 
 #include <level_zero/ze_api.h>  // for _ze_result_t, ze_result_t, ZE_MAX_DE...
 #include <level_zero/zes_api.h> // for zes_device_handle_t, _zes_structure_...
+#include <atomic>               // for atomic
+#include <chrono>               // for microseconds
 #include <stdexcept>            // for runtime_error
 #include <memory>               // for unique_ptr, allocator, make_unique
+#include <mutex>                // for once_flag
+#include <string>               // for string
 #include <vector>               // for vector
 
+// A Device only reads its device and PCI properties on construction; that is
+// all --list and device lookup need. Everything else is enumerated on first
+// use: consumers require() the components they display and the sampler
+// initializes them, so a session only pays for the sysman calls it needs.
 class Device {
 public:
-    Device(zes_device_handle_t handle) : device(handle), processMonitor(handle), temperatureMonitor(handle), memoryCached(false)
+    // driver is the one handle was enumerated from; it is only needed to
+    // listen for events.
+    Device(zes_device_handle_t handle, zes_driver_handle_t driver = nullptr)
+        : device(handle), driver(driver), processMonitor(handle), required(0), initialized(0)
     {
-        cachedMemoryState.free = 0;
-        cachedMemoryState.size = 0;
         std::memset(&deviceExtProperties, 0, sizeof(deviceExtProperties));
         deviceExtProperties.stype = ZES_STRUCTURE_TYPE_DEVICE_EXT_PROPERTIES;
         std::memset(&deviceProperties, 0, sizeof(deviceProperties));
@@ -28,46 +50,158 @@ public:
 
         if (!initializeDevice())
         {
-            throw std::runtime_error("Failed to initialize engine.");
+            throw std::runtime_error("Failed to initialize device.");
         }
     }
 
     zes_device_handle_t getHandle() const { return device; }
+    zes_driver_handle_t getDriver() const { return driver; }
     const zes_device_properties_t *getDeviceProperties() const { return &deviceProperties; }
     const zes_device_ext_properties_t *getDeviceExtProperties() const { return &deviceExtProperties; }
     const zes_pci_properties_t *getDevicePciProperties() const { return &pciProperties; }
-    uint32_t getEngineCount() const { return engines.size(); }
+
+    // Mark components as needed. Cheap and callable from any thread; the
+    // components are enumerated by the next initializeComponents() call
+    // (the sampler makes one before every tick).
+    void require(component_flags_t components) { required.fetch_or(components, std::memory_order_relaxed); }
+    component_flags_t getRequiredComponents() const { return required.load(std::memory_order_relaxed); }
+    // Enumerate any of components not yet initialized. Different component
+    // classes are enumerated concurrently when a pool is supplied. A
+    // component that fails to enumerate is logged and left empty.
+    void initializeComponents(component_flags_t components, ThreadPool *pool = nullptr);
+    bool isInitialized(component_flags_t components) const
+    {
+        return (initialized.load(std::memory_order_acquire) & components) == components;
+    }
+
+    // Display window and EWMA weight applied to every engine (see
+    // Engine::setDecimation()). Only engines enumerated afterwards pick
+    // them up, so this must be called before engines are initialized.
+    void setEngineDecimation(std::chrono::microseconds window, double alpha)
+    {
+        engineWindow = window;
+        engineSmoothing = alpha;
+    }
+    // Window power is averaged over (see PowerDomain). Must be set before
+    // power domains are initialized.
+    void setPowerWindow(std::chrono::microseconds window) { powerWindow = window; }
+
+    // Component accessors report nothing until the component is initialized.
+    uint32_t getEngineCount() const { return isInitialized(COMPONENT_ENGINES) ? engines.size() : 0; }
     Engine *getEngine(uint32_t index) const { return engines[index].get(); }
-    uint32_t getPowerDomainCount() const { return powerDomains.size(); }
+    uint32_t getPowerDomainCount() const { return isInitialized(COMPONENT_POWER) ? powerDomains.size() : 0; }
     PowerDomain *getPowerDomain(uint32_t index) const { return powerDomains[index].get(); }
-    uint32_t getPSUCount() const { return psus.size(); }
+    uint32_t getPSUCount() const { return isInitialized(COMPONENT_PSUS) ? psus.size() : 0; }
     const PSU *getPSU(uint32_t index) const { return psus[index].get(); }
+    uint32_t getFrequencyDomainCount() const { return isInitialized(COMPONENT_FREQUENCY) ? frequencyDomains.size() : 0; }
+    const FrequencyDomain *getFrequencyDomain(uint32_t index) const { return frequencyDomains[index].get(); }
+    const PciLink *getPciLink() const { return isInitialized(COMPONENT_PCI) ? pciLink.get() : nullptr; }
+    uint32_t getRasErrorSetCount() const { return isInitialized(COMPONENT_RAS) ? rasErrorSets.size() : 0; }
+    const RasErrorSet *getRasErrorSet(uint32_t index) const { return rasErrorSets[index].get(); }
 
     ze_result_t updateProcesses() { return processMonitor.updateProcessStats(); }
+    // Device energy charged to each process while processes and power were
+    // both sampled. Only safe to read once sampling has stopped.
+    const EnergyAttribution &getEnergyAttribution() const { return energyAttribution; }
     uint32_t getProcessCount() const { return processMonitor.getProcessCount(); }
     const ProcessInfo *getProcessInfo(uint32_t index) const { return processMonitor.getProcessInfo(index); }
-    const zes_mem_state_t getMemoryState();
+    uint32_t getMemoryModuleCount() const { return isInitialized(COMPONENT_MEMORY) ? memoryModules.size() : 0; }
+    const MemoryModule *getMemoryModule(uint32_t index) const { return memoryModules[index].get(); }
+    // Free and total memory summed over every module, as of the last sample
+    // (or enumeration).
+    zes_mem_state_t getMemoryState() const;
+
+    ze_result_t updateTemperatures() { return temperatureMonitor ? temperatureMonitor->updateTemperatures() : ZE_RESULT_SUCCESS; }
+    uint32_t getTemperatureCount() const { return isInitialized(COMPONENT_THERMAL) && temperatureMonitor ? temperatureMonitor->getSensorCount() : 0; }
+    double getTemperature(uint32_t index) const { return temperatureMonitor->getTemperature(index); }
+    // Sensor properties, thresholds and trends; nullptr without thermal.
+    const TemperatureMonitor *getTemperatureMonitor() const { return isInitialized(COMPONENT_THERMAL) ? temperatureMonitor.get() : nullptr; }
+    // Fans are enumerated and sampled with the temperature sensors.
+    uint32_t getFanCount() const { return isInitialized(COMPONENT_THERMAL) ? fans.size() : 0; }
+    const Fan *getFan(uint32_t index) const { return fans[index].get(); }
+
+    // Size the per-metric histories so each covers length at the rate its
+    // class is sampled (engines at the display rate), and keep statistics
+    // over each of statisticsWindows (zero meaning the whole session). Must
+    // be called before sampling starts; without it neither is kept.
+    void setHistory(std::chrono::seconds length, const std::vector<std::chrono::milliseconds> &statisticsWindows,
+                    const SamplingSchedule &schedule);
+    // History for one engine, power domain or temperature sensor, or nullptr
+    // if there is none. Safe to read from any thread.
+    const UtilizationHistory *getEngineHistory(uint32_t index) const;
+    const PowerHistory *getPowerDomainHistory(uint32_t index) const;
+    const TemperatureHistory *getTemperatureHistory(uint32_t index) const;
+    size_t getHistoryMemoryUsage() const;
 
-    ze_result_t updateTemperatures() { return temperatureMonitor.updateTemperatures(); }
-    uint32_t getTemperatureCount() { return temperatureMonitor.getSensorCount(); }
-    double getTemperature(uint32_t index) { return temperatureMonitor.getTemperature(index); }
+    // Short "domain:bus:device.function" name used in logs and profiles.
+    std::string getLabel() const;
+
+    // Initialize newly required components, query the initialized ones in
+    // components (plus any initialized since the last sample) and publish a
+    // new snapshot; everything else is carried over from the previous one.
+    // Must only be called from one thread at a time (the Sampler).
+    void sample(uint64_t sequence, component_flags_t components = COMPONENT_ALL, ThreadPool *pool = nullptr);
+    // Latest published snapshot. Any number of threads may read concurrently
+    // without locking; the value stays valid while the Reader is held.
+    SnapshotBuffer<DeviceSnapshot>::Reader getSnapshot() const { return snapshots.read(); }
 
 private:
     zes_device_handle_t device;
+    zes_driver_handle_t driver;
     zes_device_ext_properties_t deviceExtProperties;
     zes_device_properties_t deviceProperties;
     zes_pci_properties_t pciProperties;
-    std::vector<zes_mem_handle_t> memoryHandles;
+    std::vector<std::unique_ptr<MemoryModule>> memoryModules;
     std::vector<std::unique_ptr<Engine>> engines;
+    std::chrono::microseconds engineWindow{0};
+    double engineSmoothing = 1.0;
+    std::chrono::microseconds powerWindow{std::chrono::seconds(1)};
     std::vector<std::unique_ptr<PowerDomain>> powerDomains;
     std::vector<std::unique_ptr<PSU>> psus;
+    std::vector<std::unique_ptr<FrequencyDomain>> frequencyDomains;
+    std::unique_ptr<PciLink> pciLink;
+    std::vector<std::unique_ptr<RasErrorSet>> rasErrorSets;
 
     ProcessMonitor processMonitor;
-    TemperatureMonitor temperatureMonitor;
+    std::unique_ptr<TemperatureMonitor> temperatureMonitor;
+    std::vector<std::unique_ptr<Fan>> fans;
+    EnergyAttribution energyAttribution;
+    // Reused for every attribution so sampling processes doesn't allocate.
+    std::vector<EnergyAttribution::Activity> processActivity;
+
+    SnapshotBuffer<DeviceSnapshot> snapshots;
+
+    std::chrono::milliseconds historyLength{0};
+    std::vector<std::chrono::milliseconds> statisticsWindows;
+    // How often a value is recorded for each class.
+    std::chrono::milliseconds enginePeriod{1000};
+    std::chrono::milliseconds powerPeriod{1000};
+    std::chrono::milliseconds temperaturePeriod{1000};
+    std::vector<std::unique_ptr<UtilizationHistory>> engineHistory;
+    std::vector<std::unique_ptr<PowerHistory>> powerHistory;
+    std::vector<std::unique_ptr<TemperatureHistory>> temperatureHistory;
+    std::vector<std::unique_ptr<MetricStatistics>> engineStatistics;
+    std::vector<std::unique_ptr<MetricStatistics>> powerStatistics;
+    std::vector<std::unique_ptr<MetricStatistics>> temperatureStatistics;
+    // Engine::getWindowCount() as of the last value recorded per engine.
+    std::vector<uint64_t> engineWindows;
 
-    zes_mem_state_t cachedMemoryState;
-    bool memoryCached;
+    std::atomic<component_flags_t> required;
+    std::atomic<component_flags_t> initialized;
+    std::once_flag componentOnce[COMPONENT_COUNT];
 
     bool initializeDevice();
+    bool enumerateComponent(component_flags_t component);
+    void createHistory(component_flags_t component);
+    bool enumerateEngines();
+    bool enumeratePowerDomains();
+    bool enumeratePsus();
+    bool enumerateMemoryModules();
+    bool enumerateTemperatureSensors();
+    void enumerateFans();
+    void attributeEnergy(DeviceSnapshot &snapshot);
+    bool enumerateFrequencyDomains();
+    bool enumeratePciLink();
+    bool enumerateRasErrorSets();
 };
 
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>              // for int32_t
+#include <string>               // for string
+#include <vector>               // for vector
+
+// What distinguishes one component of a device from its siblings: its type
+// (engine group, sensor, frequency domain, ...) if it has one, and the
+// sub-device it is on, or -1 for the whole device.
+struct ComponentLabels
+{
+    std::string type;
+    int32_t subdevice = -1;
+};
+
+// How the exporter and the stream writer identify a device and each of its
+// components. The component vectors are indexed the same way as the
+// corresponding DeviceSnapshot vectors. They are read from the Device once
+// its components are enumerated and never change.
+struct DeviceLabels
+{
+    std::string uuid;
+    std::string bdf;
+    std::string model;
+    std::vector<ComponentLabels> engines;
+    std::vector<ComponentLabels> powerDomains;
+    std::vector<ComponentLabels> temperatures;
+    std::vector<ComponentLabels> memoryModules;
+    std::vector<ComponentLabels> frequencyDomains;
+    std::vector<ComponentLabels> rasErrorSets;
+};
@@ -0,0 +1,91 @@
+#include "energy_attribution.h"
+
+#include <algorithm>            // for min, sort
+
+void EnergyAttribution::attribute(double deviceEnergy, std::chrono::steady_clock::time_point now,
+                                  const std::vector<Activity> &activity)
+{
+    if (!primed)
+    {
+        primed = true;
+        lastEnergy = deviceEnergy;
+        lastTime = now;
+        return;
+    }
+
+    double energy = deviceEnergy - lastEnergy;
+    double seconds = std::chrono::duration<double>(now - lastTime).count();
+    if (energy < 0)
+    {
+        // The device's total was reset; start again from here.
+        lastEnergy = deviceEnergy;
+        lastTime = now;
+        return;
+    }
+    // Energy counters may update less often than this is called. Until the
+    // counter moves, the interval keeps growing, so the energy it finally
+    // reports is spread over all of the time it covers.
+    if (energy == 0 || seconds <= 0)
+    {
+        return;
+    }
+    lastEnergy = deviceEnergy;
+    lastTime = now;
+
+    // The running minimum is only an estimate of idle power, and an
+    // overestimate until the device has been seen idle; it can only fall.
+    double power = energy / seconds;
+    idlePower = idlePower < 0 ? power : std::min(idlePower, power);
+    double idle = std::min(idlePower * seconds, energy);
+
+    double weights = 0;
+    for (const Activity &each : activity)
+    {
+        weights += std::max(each.weight, 0.0);
+    }
+    if (weights <= 0)
+    {
+        idleEnergy += energy;
+        return;
+    }
+
+    idleEnergy += idle;
+    double active = energy - idle;
+    for (const Activity &each : activity)
+    {
+        if (each.weight <= 0)
+        {
+            continue;
+        }
+        Total &total = totals[Key{each.pid, each.startTime}];
+        if (total.pid == 0)
+        {
+            total.pid = each.pid;
+            total.startTime = each.startTime;
+            total.name = each.name != nullptr ? *each.name : std::string();
+        }
+        double share = active * each.weight / weights;
+        total.energy += share;
+        attributedEnergy += share;
+    }
+}
+
+double EnergyAttribution::getProcessEnergy(uint32_t pid, uint64_t startTime) const
+{
+    auto found = totals.find(Key{pid, startTime});
+    return found != totals.end() ? found->second.energy : 0.0;
+}
+
+std::vector<EnergyAttribution::Total> EnergyAttribution::getTotals() const
+{
+    std::vector<Total> result;
+    result.reserve(totals.size());
+    for (const auto &entry : totals)
+    {
+        result.push_back(entry.second);
+    }
+    std::sort(result.begin(), result.end(), [](const Total &a, const Total &b) {
+        return a.energy != b.energy ? a.energy > b.energy : a.pid < b.pid;
+    });
+    return result;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>               // for steady_clock
+#include <cstdint>              // for uint32_t, uint64_t
+#include <functional>           // for hash
+#include <string>               // for string
+#include <unordered_map>        // for unordered_map
+#include <vector>               // for vector
+
+// Splits a device's energy between the processes using it, for chargeback.
+//
+// Each interval's energy is split in two. The idle share is what the device
+// would have used anyway: the lowest power seen so far this session, times
+// the interval. It is kept separate rather than charged to anyone. The rest
+// is shared out in proportion to each process's engine activity over the
+// interval. An interval with no activity at all counts entirely as idle.
+//
+// Totals are kept per process (PID and start time, so a reused PID starts
+// again from zero) for the whole session, including processes that have
+// exited.
+class EnergyAttribution
+{
+public:
+    // One process's activity over the interval being attributed. weight is
+    // in any unit, e.g. summed engine busy percent; only ratios matter.
+    struct Activity
+    {
+        uint32_t pid;
+        uint64_t startTime;
+        double weight;
+        const std::string *name;
+    };
+
+    struct Total
+    {
+        uint32_t pid;
+        uint64_t startTime;
+        std::string name;
+        // Joules.
+        double energy;
+    };
+
+    // deviceEnergy is the device's cumulative energy in joules; the first
+    // call only sets the starting point. Calls where it hasn't changed are
+    // folded into the next interval it has, which is charged by the
+    // activity given with that call.
+    void attribute(double deviceEnergy, std::chrono::steady_clock::time_point now,
+                   const std::vector<Activity> &activity);
+
+    // Joules charged to a process so far, or 0 if it has never been charged.
+    double getProcessEnergy(uint32_t pid, uint64_t startTime) const;
+    double getIdleEnergy() const { return idleEnergy; }
+    // Joules charged to processes, across all of them.
+    double getAttributedEnergy() const { return attributedEnergy; }
+    // Watts assumed to be idle (see above), or -1 before the first interval.
+    double getIdlePower() const { return idlePower; }
+    // Every process charged this session, most energy first.
+    std::vector<Total> getTotals() const;
+
+private:
+    struct Key
+    {
+        uint32_t pid;
+        uint64_t startTime;
+        bool operator==(const Key &other) const { return pid == other.pid && startTime == other.startTime; }
+    };
+    struct KeyHash
+    {
+        size_t operator()(const Key &key) const { return std::hash<uint64_t>()(key.startTime * 31 + key.pid); }
+    };
+
+    bool primed = false;
+    double lastEnergy = 0;
+    std::chrono::steady_clock::time_point lastTime;
+    double idlePower = -1;
+    double idleEnergy = 0;
+    double attributedEnergy = 0;
+    std::unordered_map<Key, Total, KeyHash> totals;
+};
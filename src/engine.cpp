@@ -1,6 +1,8 @@
 #include "engine.h"
 #include <iostream>             // for cerr, cout
 #include "helpers.h"           // for ze_error_to_str
+#include <algorithm>            // for min
+#include <cstdint>              // for UINT64_MAX
 
 bool Engine::initializeEngine()
 {
@@ -14,20 +16,23 @@ bool Engine::initializeEngine()
         return false;
     }
 
-    ret = updateStats();
-    if (ret != ZE_RESULT_SUCCESS)
+    // updateStats() has already logged a failure.
+    if (updateStats() != ZE_RESULT_SUCCESS)
     {
-        std::cerr << "Failed to get activity for engine handle " << engine
-                  << ": error 0x" << std::hex << ret << " (" << ze_error_to_str(ret) << ")" << std::endl;
         return false;
     }
 
     return true;
 }
 
+void Engine::setDecimation(std::chrono::microseconds window, double alpha)
+{
+    this->window = window;
+    this->alpha = alpha;
+}
+
 ze_result_t Engine::updateStats() {
-    uint64_t lastActivetime = stats.activeTime;
-    uint64_t lastTimestamp = stats.timestamp;
+    zes_engine_stats_t previous = stats;
     ze_result_t ret;
 
     ret = zesEngineGetActivity(engine, &stats);
@@ -38,19 +43,46 @@ ze_result_t Engine::updateStats() {
         return ret;
     }
 
-    if ((stats.timestamp - lastTimestamp) > 0)
+    // The first reading only establishes the baseline.
+    if (!primed)
     {
-        utilization = 100 * (stats.activeTime - lastActivetime) /
-                     (stats.timestamp - lastTimestamp);
+        primed = true;
+        return ZE_RESULT_SUCCESS;
     }
-    else
+
+    // Unsigned subtraction already gives the right deltas across a wrap of
+    // the 64-bit counters. A counter that went backwards for any other reason
+    // (a reset, or hardware that wraps at a narrower width) shows up as an
+    // enormous delta; drop that interval and measure from the new values.
+    uint64_t elapsed = stats.timestamp - previous.timestamp;
+    uint64_t active = stats.activeTime - previous.activeTime;
+    if (elapsed == 0)
     {
-        utilization = 0;
+        return ZE_RESULT_SUCCESS;
     }
+    if (elapsed > UINT64_MAX / 2 || active > elapsed + elapsed / 8)
+    {
+        return ZE_RESULT_SUCCESS;
+    }
+    // The two counters aren't latched at exactly the same instant, so a
+    // fully busy engine can read slightly over 100%.
+    active = std::min(active, elapsed);
+
+    history.push({stats.timestamp, (float)(100.0 * (double)active / (double)elapsed)});
 
-    if (utilization > 100) {
-        fprintf(stderr, "stats error: %lu %lu %lu %lu\n", stats.activeTime, lastActivetime, stats.timestamp, lastTimestamp);
+    windowActive += active;
+    windowElapsed += elapsed;
+    if (windowElapsed < (uint64_t)window.count())
+    {
+        return ZE_RESULT_SUCCESS;
     }
 
+    double average = 100.0 * (double)windowActive / (double)windowElapsed;
+    utilization = smoothed ? alpha * average + (1.0 - alpha) * utilization : average;
+    smoothed = true;
+    windowCount++;
+    windowActive = 0;
+    windowElapsed = 0;
+
     return ZE_RESULT_SUCCESS;
 }
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "ring_buffer.h"
+
+#include <chrono>               // for microseconds
 #include <cstring>              // for unique_ptr, allocator, make_unique
 #include <iostream>             // for cerr, cout
 #include <level_zero/ze_api.h>  // for _ze_result_t, ze_result_t, ZE_MAX_DE...
@@ -8,8 +11,23 @@
 #include <stdexcept>            // for runtime_error
 #include <vector>               // for vector
 
+// One activity interval as reported by the device: utilization over the
+// interval ending at timestamp (device clock, microseconds).
+struct EngineSample
+{
+    uint64_t timestamp;
+    float utilization;
+};
+
+// Engine activity is kept at the rate it is sampled (which can be every 10ms
+// or so) in a ring buffer, while getEngineUtilization() reports the average
+// over a longer display window, optionally EWMA smoothed, so the UI doesn't
+// have to redraw at the sampling rate to show something meaningful.
 class Engine {
 public:
+    // About ten seconds of history at the fastest useful rate (10ms).
+    typedef RingBuffer<EngineSample, 1024> History;
+
     Engine(zes_engine_handle_t handle) : engine(handle)
     {
         std::memset(&properties, 0, sizeof(properties));
@@ -23,25 +41,40 @@ public:
     }
 
     zes_engine_handle_t getHandle() const { return engine; }
-    double getEngineUtilization()
-    {
-        ze_result_t ret = updateStats();
-        if (ret != ZE_RESULT_SUCCESS)
-        {
-            std::cerr << "Failed to get activity for engine." << std::endl;
-            return 0;
-        }
-        return utilization;
-    }
+    // Utilization (percent) over the most recently completed display window.
+    // Only the sampler thread calls updateStats(); everyone else reads
+    // snapshots or the history.
+    double getEngineUtilization() const { return utilization; }
+    // Number of display windows completed so far; changes whenever
+    // getEngineUtilization() has a new value.
+    uint64_t getWindowCount() const { return windowCount; }
     const zes_engine_properties_t *getEngineProperties() const { return &properties; }
+    ze_result_t updateStats();
+
+    // Average samples over window (device time) before reporting them, and
+    // then smooth across windows with weight alpha on the newest (1 = off).
+    void setDecimation(std::chrono::microseconds window, double alpha);
+    std::chrono::microseconds getDecimationWindow() const { return window; }
+    double getSmoothing() const { return alpha; }
+    // Every interval measured by updateStats(). Safe to read from any thread.
+    const History &getHistory() const { return history; }
 
 private:    
     zes_engine_handle_t engine;
     zes_engine_stats_t stats;
     zes_engine_properties_t properties;
-    double utilization;
+    double utilization = 0;
+    bool primed = false;
+    bool smoothed = false;
+
+    std::chrono::microseconds window{0};
+    double alpha = 1.0;
+    uint64_t windowActive = 0;
+    uint64_t windowElapsed = 0;
+    uint64_t windowCount = 0;
+
+    History history;
 
     bool initializeEngine();
-    ze_result_t updateStats();
 };
 
@@ -0,0 +1,173 @@
+#include "event_listener.h"
+#include "helpers.h"            // for ze_error_to_str
+
+#include <algorithm>            // for find_if
+#include <iostream>             // for cerr, cout
+
+component_flags_t event_components(zes_event_type_flags_t events)
+{
+    // Anything could have changed across a reset or re-attach.
+    if (events & (ZES_EVENT_TYPE_FLAG_DEVICE_DETACH | ZES_EVENT_TYPE_FLAG_DEVICE_ATTACH |
+                  ZES_EVENT_TYPE_FLAG_DEVICE_RESET_REQUIRED))
+    {
+        return COMPONENT_ALL;
+    }
+
+    component_flags_t components = 0;
+    if (events & ZES_EVENT_TYPE_FLAG_FREQ_THROTTLED)
+        components |= COMPONENT_FREQUENCY;
+    if (events & ZES_EVENT_TYPE_FLAG_ENERGY_THRESHOLD_CROSSED)
+        components |= COMPONENT_POWER;
+    if (events & (ZES_EVENT_TYPE_FLAG_TEMP_CRITICAL | ZES_EVENT_TYPE_FLAG_TEMP_THRESHOLD1 |
+                  ZES_EVENT_TYPE_FLAG_TEMP_THRESHOLD2))
+        components |= COMPONENT_THERMAL;
+    if (events & ZES_EVENT_TYPE_FLAG_MEM_HEALTH)
+        components |= COMPONENT_MEMORY;
+    if (events & (ZES_EVENT_TYPE_FLAG_RAS_CORRECTABLE_ERRORS | ZES_EVENT_TYPE_FLAG_RAS_UNCORRECTABLE_ERRORS))
+        components |= COMPONENT_RAS;
+    if (events & ZES_EVENT_TYPE_FLAG_PCI_LINK_HEALTH)
+        components |= COMPONENT_PCI;
+    return components;
+}
+
+EventListener::EventListener(std::vector<Device *> devices, std::chrono::milliseconds timeout)
+    : devices(std::move(devices)), timeout(timeout), running(false), eventCount(0)
+{
+}
+
+EventListener::~EventListener()
+{
+    stop();
+}
+
+component_flags_t EventListener::registerEvents()
+{
+    size_t registered = 0;
+    for (Device *device : devices)
+    {
+        if (device->getDriver() == nullptr)
+        {
+            continue;
+        }
+
+        ze_result_t ret = zesDeviceEventRegister(device->getHandle(), MONITORED_EVENTS);
+        if (ret != ZE_RESULT_SUCCESS)
+        {
+            // Polling still covers everything; events only make it faster.
+            if (ret != ZE_RESULT_ERROR_UNSUPPORTED_FEATURE)
+            {
+                std::cerr << "Device " << device->getLabel() << ": zesDeviceEventRegister failed: " << std::hex << ret
+                          << std::dec << " (" << ze_error_to_str(ret) << ")" << std::endl;
+            }
+            continue;
+        }
+
+        auto driver = std::find_if(drivers.begin(), drivers.end(),
+                                   [device](const Driver &each) { return each.handle == device->getDriver(); });
+        if (driver == drivers.end())
+        {
+            drivers.push_back(Driver{device->getDriver(), {}, {}, true});
+            driver = drivers.end() - 1;
+        }
+        driver->handles.push_back(device->getHandle());
+        driver->devices.push_back(device);
+        registered++;
+    }
+
+    // Critical temperatures and link health problems arrive as events; what
+    // is left to poll for in those classes changes slowly. Memory usage and
+    // throttling are rates or levels with no event, so they keep their
+    // period.
+    if (registered == 0 || registered != devices.size())
+    {
+        return 0;
+    }
+    return COMPONENT_THERMAL | COMPONENT_PCI;
+}
+
+void EventListener::start(Callback callback, FailureCallback onFailure)
+{
+    if (drivers.empty() || running.exchange(true))
+    {
+        return;
+    }
+    this->callback = std::move(callback);
+    this->onFailure = std::move(onFailure);
+    for (Driver &driver : drivers)
+    {
+        threads.emplace_back(&EventListener::listen, this, std::ref(driver));
+    }
+}
+
+void EventListener::stop()
+{
+    if (running.exchange(false))
+    {
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+        threads.clear();
+    }
+
+    for (Driver &driver : drivers)
+    {
+        for (zes_device_handle_t handle : driver.handles)
+        {
+            zesDeviceEventRegister(handle, 0);
+        }
+    }
+    drivers.clear();
+}
+
+void EventListener::listen(Driver &driver)
+{
+    std::vector<zes_event_type_flags_t> events(driver.handles.size());
+    uint32_t count = (uint32_t)driver.handles.size();
+
+    while (running.load(std::memory_order_relaxed))
+    {
+        uint32_t numDeviceEvents = 0;
+        ze_result_t ret;
+        if (driver.extended)
+        {
+            ret = zesDriverEventListenEx(driver.handle, (uint64_t)timeout.count(), count, driver.handles.data(),
+                                         &numDeviceEvents, events.data());
+            if (ret == ZE_RESULT_ERROR_UNSUPPORTED_FEATURE)
+            {
+                driver.extended = false;
+                continue;
+            }
+        }
+        else
+        {
+            ret = zesDriverEventListen(driver.handle, (uint32_t)timeout.count(), count, driver.handles.data(),
+                                       &numDeviceEvents, events.data());
+        }
+
+        if (ret != ZE_RESULT_SUCCESS)
+        {
+            std::cerr << "zesDriverEventListen failed: " << std::hex << ret << std::dec << " ("
+                      << ze_error_to_str(ret) << "); falling back to polling" << std::endl;
+            if (onFailure)
+            {
+                onFailure();
+            }
+            return;
+        }
+
+        // A timeout returns no events.
+        if (numDeviceEvents == 0)
+        {
+            continue;
+        }
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (events[i] != 0)
+            {
+                eventCount.fetch_add(1, std::memory_order_relaxed);
+                callback(driver.devices[i], events[i]);
+            }
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "components.h"
+#include "device.h"
+
+#include <level_zero/ze_api.h>  // for _ze_result_t, ze_result_t, ZE_MAX_DE...
+#include <level_zero/zes_api.h> // for zes_device_handle_t, _zes_structure_...
+#include <atomic>               // for atomic
+#include <chrono>               // for milliseconds
+#include <cstdint>              // for uint32_t, uint64_t
+#include <functional>           // for function, ref
+#include <thread>               // for thread
+#include <vector>               // for vector
+
+// Sysman events ze-monitor registers for: the state changes worth showing
+// immediately rather than at the next poll.
+constexpr zes_event_type_flags_t MONITORED_EVENTS =
+    ZES_EVENT_TYPE_FLAG_DEVICE_DETACH | ZES_EVENT_TYPE_FLAG_DEVICE_ATTACH | ZES_EVENT_TYPE_FLAG_FREQ_THROTTLED |
+    ZES_EVENT_TYPE_FLAG_ENERGY_THRESHOLD_CROSSED | ZES_EVENT_TYPE_FLAG_TEMP_CRITICAL |
+    ZES_EVENT_TYPE_FLAG_TEMP_THRESHOLD1 | ZES_EVENT_TYPE_FLAG_TEMP_THRESHOLD2 | ZES_EVENT_TYPE_FLAG_MEM_HEALTH |
+    ZES_EVENT_TYPE_FLAG_PCI_LINK_HEALTH | ZES_EVENT_TYPE_FLAG_RAS_CORRECTABLE_ERRORS |
+    ZES_EVENT_TYPE_FLAG_RAS_UNCORRECTABLE_ERRORS | ZES_EVENT_TYPE_FLAG_DEVICE_RESET_REQUIRED;
+
+// Component classes whose values an event may have changed, i.e. what to
+// sample again in response.
+component_flags_t event_components(zes_event_type_flags_t events);
+
+// Waits for sysman events on a thread per driver and reports them as they
+// arrive, so the sampler can refresh just the affected components within
+// milliseconds instead of at their next scheduled poll.
+//
+// Listening uses zesDriverEventListenEx, or zesDriverEventListen on drivers
+// without it, with a short timeout so stop() never waits long.
+class EventListener
+{
+public:
+    // Called from a listener thread with the device an event was raised on
+    // and the events seen.
+    typedef std::function<void(Device *, zes_event_type_flags_t)> Callback;
+    // Called from a listener thread when listening on a driver fails, so
+    // the classes registerEvents() reported as covered need polling again.
+    typedef std::function<void()> FailureCallback;
+
+    explicit EventListener(std::vector<Device *> devices,
+                           std::chrono::milliseconds timeout = std::chrono::milliseconds(100));
+    ~EventListener();
+    EventListener(const EventListener &) = delete;
+    EventListener &operator=(const EventListener &) = delete;
+
+    // Register every device for MONITORED_EVENTS. Devices (or drivers) that
+    // don't support events are skipped. Returns the component classes
+    // covered on every device, which can be polled less often.
+    component_flags_t registerEvents();
+    // Start listening on the drivers of the registered devices.
+    void start(Callback callback, FailureCallback onFailure = nullptr);
+    // Stop listening and unregister.
+    void stop();
+
+    // Events received so far, across every device.
+    uint64_t getEventCount() const { return eventCount.load(std::memory_order_relaxed); }
+
+private:
+    struct Driver
+    {
+        zes_driver_handle_t handle;
+        std::vector<zes_device_handle_t> handles;
+        std::vector<Device *> devices;
+        bool extended;
+    };
+
+    std::vector<Device *> devices;
+    std::chrono::milliseconds timeout;
+    std::vector<Driver> drivers;
+    Callback callback;
+    FailureCallback onFailure;
+    std::atomic<bool> running;
+    std::atomic<uint64_t> eventCount;
+    std::vector<std::thread> threads;
+
+    void listen(Driver &driver);
+};
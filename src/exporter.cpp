@@ -0,0 +1,572 @@
+#include "exporter.h"
+#include "helpers.h"            // for ras_category_to_str
+
+#include <netdb.h>              // for addrinfo, getaddrinfo, freeaddrinfo
+#include <netinet/in.h>         // for sockaddr_in, sockaddr_in6, ntohs
+#include <poll.h>               // for poll, pollfd, POLLIN
+#include <sys/eventfd.h>        // for eventfd, EFD_CLOEXEC, EFD_NONBLOCK
+#include <sys/socket.h>         // for socket, bind, listen, accept4, send
+#include <sys/time.h>           // for timeval
+#include <unistd.h>             // for read, write, close
+#include <algorithm>            // for min
+#include <cerrno>               // for errno, EINTR
+#include <cmath>                // for isfinite
+#include <cstdlib>              // for strtoul
+#include <cstring>              // for strerror
+#include <iostream>             // for cerr
+#include <iterator>             // for back_inserter
+#include <stdexcept>            // for runtime_error
+#include <string_view>          // for string_view
+
+namespace
+{
+// Requests are only a request line and a few headers; anything bigger is
+// not a scraper.
+constexpr size_t MAX_REQUEST_SIZE = 4096;
+// How long a client has to send its request, and to take the response.
+constexpr int RECEIVE_TIMEOUT_MS = 1000;
+constexpr int SEND_TIMEOUT_MS = 5000;
+
+const char BAD_REQUEST[] = "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+const char NOT_FOUND[] = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+const char METHOD_NOT_ALLOWED[] =
+    "HTTP/1.1 405 Method Not Allowed\r\nAllow: GET, HEAD\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+// Nothing has been sampled yet.
+const char UNAVAILABLE[] = "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+
+// Label values are quoted; backslash, quote and newline must be escaped.
+std::string escapeLabel(const std::string &value)
+{
+    std::string escaped;
+    for (char c : value)
+    {
+        switch (c)
+        {
+        case '\\':
+            escaped += "\\\\";
+            break;
+        case '"':
+            escaped += "\\\"";
+            break;
+        case '\n':
+            escaped += "\\n";
+            break;
+        default:
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+std::string renderComponent(const std::string &device, size_t index, const ComponentLabels &labels)
+{
+    std::string rendered = device + ",index=\"" + std::to_string(index) + "\"";
+    if (!labels.type.empty())
+    {
+        rendered += ",type=\"" + escapeLabel(labels.type) + "\"";
+    }
+    if (labels.subdevice >= 0)
+    {
+        rendered += ",subdevice=\"" + std::to_string(labels.subdevice) + "\"";
+    }
+    return rendered;
+}
+
+std::vector<std::string> renderComponents(const std::string &device, const std::vector<ComponentLabels> &components)
+{
+    std::vector<std::string> rendered;
+    for (size_t i = 0; i < components.size(); ++i)
+    {
+        rendered.push_back(renderComponent(device, i, components[i]));
+    }
+    return rendered;
+}
+
+void sendAll(int fd, const char *data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (sent <= 0)
+        {
+            // The scraper went away or stopped reading; it will try again.
+            return;
+        }
+        data += sent;
+        size -= (size_t)sent;
+    }
+}
+} // namespace
+
+bool parse_listen_address(const std::string &spec, std::string &host, uint16_t &port)
+{
+    size_t colon = spec.rfind(':');
+    if (colon == std::string::npos)
+    {
+        return false;
+    }
+    host = spec.substr(0, colon);
+    // [::1]:9100
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']')
+    {
+        host = host.substr(1, host.size() - 2);
+    }
+    else if (host.find(':') != std::string::npos)
+    {
+        return false;
+    }
+
+    const char *digits = spec.c_str() + colon + 1;
+    char *end = nullptr;
+    unsigned long value = strtoul(digits, &end, 10);
+    if (end == digits || *end != '\0' || *digits == '-' || *digits == '+' || value == 0 || value > 65535)
+    {
+        return false;
+    }
+    port = (uint16_t)value;
+    return true;
+}
+
+MetricsExporter::MetricsExporter(std::vector<DeviceLabels> labels)
+    : listenFd(-1), wakeFd(-1), port(0), running(false), scrapeCount(0)
+{
+    for (const DeviceLabels &each : labels)
+    {
+        Rendered rendered;
+        rendered.device = "uuid=\"" + escapeLabel(each.uuid) + "\",bdf=\"" + escapeLabel(each.bdf) + "\"";
+        rendered.info = rendered.device + ",model=\"" + escapeLabel(each.model) + "\"";
+        rendered.engines = renderComponents(rendered.device, each.engines);
+        rendered.powerDomains = renderComponents(rendered.device, each.powerDomains);
+        rendered.temperatures = renderComponents(rendered.device, each.temperatures);
+        rendered.memoryModules = renderComponents(rendered.device, each.memoryModules);
+        rendered.frequencyDomains = renderComponents(rendered.device, each.frequencyDomains);
+        rendered.rasErrorSets = renderComponents(rendered.device, each.rasErrorSets);
+        devices.push_back(std::move(rendered));
+    }
+
+    wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wakeFd < 0)
+    {
+        throw std::runtime_error(std::string("Failed to create exporter wakeup: ") + strerror(errno));
+    }
+}
+
+MetricsExporter::~MetricsExporter()
+{
+    stop();
+    close(wakeFd);
+}
+
+void MetricsExporter::publish(const std::vector<const DeviceSnapshot *> &snapshots)
+{
+    serialize(snapshots);
+
+    pending.clear();
+    fmt::format_to(std::back_inserter(pending),
+                   "HTTP/1.1 200 OK\r\n"
+                   "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                   "Content-Length: {}\r\n"
+                   "Connection: close\r\n\r\n",
+                   body.size());
+    size_t header = pending.size();
+    pending.append(body.data(), body.size());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    response.swap(pending);
+    headerSize = header;
+}
+
+std::string MetricsExporter::getMetrics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return response.substr(headerSize);
+}
+
+void MetricsExporter::serialize(const std::vector<const DeviceSnapshot *> &snapshots)
+{
+    body.clear();
+    auto out = std::back_inserter(body);
+    size_t count = std::min(devices.size(), snapshots.size());
+
+    auto family = [&out](const char *name, const char *type, const char *help) {
+        fmt::format_to(out, "# HELP {} {}\n# TYPE {} {}\n", name, help, name, type);
+    };
+    // Non-finite values are left out rather than spelled the way the
+    // format wants; nothing here should produce one.
+    auto sample = [&out](const char *name, const std::string &labels, double value) {
+        if (std::isfinite(value))
+        {
+            fmt::format_to(out, "{}{{{}}} {}\n", name, labels, value);
+        }
+    };
+    // Every sample of a family has to be listed together, so each family
+    // walks all of the devices.
+    auto each = [&](auto &&write) {
+        for (size_t d = 0; d < count; ++d)
+        {
+            if (snapshots[d] != nullptr)
+            {
+                write(devices[d], *snapshots[d]);
+            }
+        }
+    };
+
+    family("ze_device_info", "gauge", "Device identity; always 1.");
+    each([&](const Rendered &device, const DeviceSnapshot &) { sample("ze_device_info", device.info, 1); });
+
+    family("ze_sample_latency_seconds", "gauge", "Time taken to query every component of the device for the last sample.");
+    each([&](const Rendered &device, const DeviceSnapshot &snapshot) {
+        sample("ze_sample_latency_seconds", device.device, std::chrono::duration<double>(snapshot.sampleLatency).count());
+    });
+
+    family("ze_engine_utilization_ratio", "gauge", "Fraction of time the engine group was busy.");
+    each([&](const Rendered &device, const DeviceSnapshot &snapshot) {
+        size_t n = std::min(device.engines.size(), snapshot.engineUtilization.size());
+        for (size_t i = 0; i < n; ++i)
+        {
+            sample("ze_engine_utilization_ratio", device.engines[i], snapshot.engineUtilization[i] / 100.0);
+        }
+    });
+
+    family("ze_power_watts", "gauge", "Average power drawn by the power domain over its window.");
+    each([&](const Rendered &device, const DeviceSnapshot &snapshot) {
+        size_t n = std::min(device.powerDomains.size(), snapshot.powerDomains.size());
+        for (size_t i = 0; i < n; ++i)
+        {
+            sample("ze_power_watts", device.powerDomains[i], snapshot.powerDomains[i].power);
+        }
+    });
+
+    family("ze_energy_joules_total", "counter", "Energy used by the power domain since ze-monitor started.");
+    each([&](const Rendered &device, const DeviceSnapshot &snapshot) {
+        size_t n = std::min(device.powerDomains.size(), snapshot.powerDomains.size());
+        for (size_t i = 0; i < n; ++i)
+        {
+            sample("ze_energy_joules_total", device.powerDomains[i], snapshot.powerDomains[i].sessionEnergy);
+        }
+    });
+
+    family("ze_temperature_celsius", "gauge", "Temperature sensor reading.");
+    each([&](const Rendered &device, const DeviceSnapshot &snapshot) {
+        size_t n = std::min(device.temperatures.size(), snapshot.temperatures.size());
+        for (size_t i = 0; i < n; ++i)
+        {
+            // A sensor that couldn't be read is left out rather than
+            // reported at its previous value.
+            if (i < snapshot.temperatureSensors.size() && !snapshot.temperatureSensors[i].valid)
+            {
+                continue;
+            }
+            sample("ze_temperature_celsius", device.temperatures[i], snapshot.temperatures[i]);
+        }
+    });
+
+    family("ze_fan_speed_ratio", "gauge", "Fan speed as a fraction of its maximum.");
+    each([&](const Rendered &device, const DeviceSnapshot &snapshot) {
+        for (size_t i = 0; i < snapshot.fans.size(); ++i)
+        {
+            if (snapshot.fans[i].percent >= 0)
+            {
+                fmt::format_to(out, "ze_fan_speed_ratio{{{},index=\"{}\"}} {}\n", device.device, i,
+                               snapshot.fans[i].percent / 100.0);
+            }
+        }
+    });
+
+    family("ze_memory_size_bytes", "gauge", "Size of the memory module.");
+    each([&](const Rendered &device, const DeviceSnapshot &snapshot) {
+        size_t n = std::min(device.memoryModules.size(), snapshot.memoryModules.size());
+        for (size_t i = 0; i < n; ++i)
+        {
+            sample("ze_memory_size_bytes", device.memoryModules[i], (double)snapshot.memoryModules[i].state.size);
+        }
+    });
+
+    family("ze_memory_free_bytes", "gauge", "Free memory in the memory module.");
+    each([&](const Rendered &device, const DeviceSnapshot &snapshot) {
+        size_t n = std::min(device.memoryModules.size(), snapshot.memoryModules.size());
+        for (size_t i = 0; i < n; ++i)
+        {
+            sample("ze_memory_free_bytes", device.memoryModules[i], (double)snapshot.memoryModules[i].state.free);
+        }
+    });
+
+    family("ze_memory_read_bytes_per_second", "gauge", "Memory module read bandwidth.");
+    each([&](const Rendered &device, const DeviceSnapshot &snapshot) {
+        size_t n = std::min(device.memoryModules.size(), snapshot.memoryModules.size());
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (snapshot.memoryModules[i].maxBandwidth > 0)
+            {
+                sample("ze_memory_read_bytes_per_second", device.memoryModules[i],
+                       snapshot.memoryModules[i].readBandwidth);
+            }
+        }
+    });
+
+    family("ze_memory_write_bytes_per_second", "gauge", "Memory module write bandwidth.");
+    each([&](const Rendered &device, const DeviceSnapshot &snapshot) {
+        size_t n = std::min(device.memoryModules.size(), snapshot.memoryModules.size());
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (snapshot.memoryModules[i].maxBandwidth > 0)
+            {
+                sample("ze_memory_write_bytes_per_second", device.memoryModules[i],
+                       snapshot.memoryModules[i].writeBandwidth);
+            }
+        }
+    });
+
+    family("ze_frequency_hertz", "gauge", "Actual frequency of the frequency domain.");
+    each([&](const Rendered &device, const DeviceSnapshot &snapshot) {
+        size_t n = std::min(device.frequencyDomains.size(), snapshot.frequencyDomains.size());
+        for (size_t i = 0; i < n; ++i)
+        {
+            // Negative when the driver doesn't know.
+            if (snapshot.frequencyDomains[i].state.actual >= 0)
+            {
+                sample("ze_frequency_hertz", device.frequencyDomains[i],
+                       snapshot.frequencyDomains[i].state.actual * 1e6);
+            }
+        }
+    });
+
+    family("ze_frequency_throttle_ratio", "gauge", "Fraction of the last interval the frequency domain was throttled.");
+    each([&](const Rendered &device, const DeviceSnapshot &snapshot) {
+        size_t n = std::min(device.frequencyDomains.size(), snapshot.frequencyDomains.size());
+        for (size_t i = 0; i < n; ++i)
+        {
+            sample("ze_frequency_throttle_ratio", device.frequencyDomains[i],
+                   snapshot.frequencyDomains[i].throttleFraction);
+        }
+    });
+
+    family("ze_pci_receive_bytes_per_second", "gauge", "PCIe bytes received by the device.");
+    each([&](const Rendered &device, const DeviceSnapshot &snapshot) {
+        if (snapshot.components & COMPONENT_PCI)
+        {
+            sample("ze_pci_receive_bytes_per_second", device.device, snapshot.pci.rxBandwidth);
+        }
+    });
+
+    family("ze_pci_transmit_bytes_per_second", "gauge", "PCIe bytes sent by the device.");
+    each([&](const Rendered &device, const DeviceSnapshot &snapshot) {
+        if (snapshot.components & COMPONENT_PCI)
+        {
+            sample("ze_pci_transmit_bytes_per_second", device.device, snapshot.pci.txBandwidth);
+        }
+    });
+
+    family("ze_pci_link_degraded", "gauge", "1 if the PCIe link is running below its maximum speed or width.");
+    each([&](const Rendered &device, const DeviceSnapshot &snapshot) {
+        if (snapshot.components & COMPONENT_PCI)
+        {
+            sample("ze_pci_link_degraded", device.device, snapshot.pci.degraded ? 1 : 0);
+        }
+    });
+
+    family("ze_ras_errors_total", "counter", "RAS errors counted by the driver, per error set and category.");
+    each([&](const Rendered &device, const DeviceSnapshot &snapshot) {
+        size_t n = std::min(device.rasErrorSets.size(), snapshot.rasErrorSets.size());
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (uint32_t c = 0; c < ZES_MAX_RAS_ERROR_CATEGORY_COUNT; ++c)
+            {
+                fmt::format_to(out, "ze_ras_errors_total{{{},category=\"{}\"}} {}\n", device.rasErrorSets[i],
+                               ras_category_to_str((zes_ras_error_cat_t)c), snapshot.rasErrorSets[i].state.category[c]);
+            }
+        }
+    });
+}
+
+bool MetricsExporter::start(const std::string &host, uint16_t requestedPort)
+{
+    struct addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+
+    struct addrinfo *addresses = nullptr;
+    std::string service = std::to_string(requestedPort);
+    int ret = getaddrinfo(host.empty() ? nullptr : host.c_str(), service.c_str(), &hints, &addresses);
+    if (ret != 0)
+    {
+        std::cerr << "Exporter address " << host << ":" << requestedPort << ": " << gai_strerror(ret) << std::endl;
+        return false;
+    }
+
+    int error = 0;
+    for (struct addrinfo *address = addresses; address != nullptr; address = address->ai_next)
+    {
+        int fd = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+        if (fd < 0)
+        {
+            error = errno;
+            continue;
+        }
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (bind(fd, address->ai_addr, address->ai_addrlen) != 0 || listen(fd, 16) != 0)
+        {
+            error = errno;
+            close(fd);
+            continue;
+        }
+        listenFd = fd;
+        break;
+    }
+    freeaddrinfo(addresses);
+
+    if (listenFd < 0)
+    {
+        std::cerr << "Exporter can't listen on " << host << ":" << requestedPort << ": " << strerror(error) << std::endl;
+        return false;
+    }
+
+    struct sockaddr_storage bound = {};
+    socklen_t length = sizeof(bound);
+    getsockname(listenFd, (struct sockaddr *)&bound, &length);
+    port = ntohs(bound.ss_family == AF_INET6 ? ((struct sockaddr_in6 *)&bound)->sin6_port
+                                             : ((struct sockaddr_in *)&bound)->sin_port);
+
+    running = true;
+    thread = std::thread(&MetricsExporter::run, this);
+    return true;
+}
+
+void MetricsExporter::stop()
+{
+    if (running.exchange(false))
+    {
+        uint64_t one = 1;
+        if (write(wakeFd, &one, sizeof(one)) != sizeof(one))
+        {
+            // Only fails if a wakeup is already pending.
+        }
+        thread.join();
+    }
+    if (listenFd >= 0)
+    {
+        close(listenFd);
+        listenFd = -1;
+    }
+}
+
+void MetricsExporter::run()
+{
+    struct pollfd fds[2];
+    fds[0].fd = listenFd;
+    fds[0].events = POLLIN;
+    fds[1].fd = wakeFd;
+    fds[1].events = POLLIN;
+    // Reused for every reply so a scrape doesn't allocate.
+    std::string reply;
+
+    while (running)
+    {
+        if (poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            std::cerr << "Exporter poll failed: " << strerror(errno) << std::endl;
+            break;
+        }
+        if (!running)
+        {
+            break;
+        }
+        if (!(fds[0].revents & POLLIN))
+        {
+            continue;
+        }
+
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            continue;
+        }
+        serve(fd, reply);
+        close(fd);
+    }
+}
+
+void MetricsExporter::serve(int fd, std::string &reply)
+{
+    struct timeval timeout = {RECEIVE_TIMEOUT_MS / 1000, (RECEIVE_TIMEOUT_MS % 1000) * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    timeout = {SEND_TIMEOUT_MS / 1000, (SEND_TIMEOUT_MS % 1000) * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    // Only the request line matters, but read up to the end of the headers
+    // so the client isn't reset while still sending them.
+    char request[MAX_REQUEST_SIZE];
+    size_t size = 0;
+    std::string_view received;
+    while (size < sizeof(request))
+    {
+        ssize_t count = read(fd, request + size, sizeof(request) - size);
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count <= 0)
+        {
+            break;
+        }
+        size += (size_t)count;
+        received = std::string_view(request, size);
+        if (received.find("\r\n\r\n") != std::string_view::npos)
+        {
+            break;
+        }
+    }
+
+    size_t lineEnd = received.find("\r\n");
+    if (lineEnd == std::string_view::npos)
+    {
+        sendAll(fd, BAD_REQUEST, sizeof(BAD_REQUEST) - 1);
+        return;
+    }
+    // METHOD SP TARGET SP VERSION
+    std::string_view line = received.substr(0, lineEnd);
+    size_t methodEnd = line.find(' ');
+    size_t targetEnd = methodEnd == std::string_view::npos ? methodEnd : line.find(' ', methodEnd + 1);
+    if (targetEnd == std::string_view::npos)
+    {
+        sendAll(fd, BAD_REQUEST, sizeof(BAD_REQUEST) - 1);
+        return;
+    }
+    std::string_view method = line.substr(0, methodEnd);
+    std::string_view target = line.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+    target = target.substr(0, target.find('?'));
+
+    bool head = method == "HEAD";
+    if (method != "GET" && !head)
+    {
+        sendAll(fd, METHOD_NOT_ALLOWED, sizeof(METHOD_NOT_ALLOWED) - 1);
+        return;
+    }
+    if (target != "/metrics")
+    {
+        sendAll(fd, NOT_FOUND, sizeof(NOT_FOUND) - 1);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        reply.assign(response, 0, head ? headerSize : response.size());
+    }
+    scrapeCount.fetch_add(1, std::memory_order_relaxed);
+    if (reply.empty())
+    {
+        sendAll(fd, UNAVAILABLE, sizeof(UNAVAILABLE) - 1);
+        return;
+    }
+    sendAll(fd, reply.data(), reply.size());
+}
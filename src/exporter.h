@@ -0,0 +1,90 @@
+#pragma once
+
+#include "device_labels.h"
+#include "snapshot.h"
+
+#include <fmt/format.h>         // for memory_buffer
+#include <atomic>               // for atomic
+#include <cstdint>              // for uint16_t, uint64_t
+#include <mutex>                // for mutex
+#include <string>               // for string
+#include <thread>               // for thread
+#include <vector>               // for vector
+
+// Split an --exporter address, [HOST]:PORT, into its parts. HOST may be
+// empty (every address) or a bracketed IPv6 literal.
+bool parse_listen_address(const std::string &spec, std::string &host, uint16_t &port);
+
+// Serves the most recent sample of every device in the Prometheus text
+// exposition format at GET /metrics.
+//
+// The whole response, headers included, is serialized once per sample by
+// publish() into a buffer that is reused from sample to sample. A scrape
+// only copies it out under a lock and writes it, so any number of scrapers
+// cost the devices nothing: no sysman calls and no formatting happen on the
+// scrape path.
+//
+// Connections are handled one at a time on a single thread. Each is given a
+// short time to send its request, so a stalled client can't hold up the
+// others for long.
+class MetricsExporter
+{
+public:
+    explicit MetricsExporter(std::vector<DeviceLabels> devices);
+    ~MetricsExporter();
+    MetricsExporter(const MetricsExporter &) = delete;
+    MetricsExporter &operator=(const MetricsExporter &) = delete;
+
+    // Serialize snapshots, one per device in the order given to the
+    // constructor, and make them what the next scrape returns. Called from
+    // the sampler thread.
+    void publish(const std::vector<const DeviceSnapshot *> &snapshots);
+    // The exposition text of the last publish().
+    std::string getMetrics() const;
+
+    // Bind host:port (all addresses if host is empty; port 0 picks a free
+    // one) and start serving. Returns false, having logged why, if the
+    // address can't be used.
+    bool start(const std::string &host, uint16_t port);
+    void stop();
+    // The port being served, once started.
+    uint16_t getPort() const { return port; }
+    uint64_t getScrapeCount() const { return scrapeCount.load(std::memory_order_relaxed); }
+
+private:
+    // Label sets rendered once, e.g. `uuid="...",bdf="..."`, ready to be
+    // pasted between braces.
+    struct Rendered
+    {
+        std::string device;
+        std::string info;
+        std::vector<std::string> engines;
+        std::vector<std::string> powerDomains;
+        std::vector<std::string> temperatures;
+        std::vector<std::string> memoryModules;
+        std::vector<std::string> frequencyDomains;
+        std::vector<std::string> rasErrorSets;
+    };
+
+    std::vector<Rendered> devices;
+    // Exposition text being built by publish(); only the sampler thread
+    // touches it.
+    fmt::memory_buffer body;
+    // publish() builds the complete response in pending and swaps it with
+    // response under the lock, so the buffers keep their capacity.
+    std::string pending;
+    std::string response;
+    size_t headerSize = 0;
+    mutable std::mutex mutex;
+
+    int listenFd;
+    int wakeFd;
+    uint16_t port;
+    std::atomic<bool> running;
+    std::atomic<uint64_t> scrapeCount;
+    std::thread thread;
+
+    void serialize(const std::vector<const DeviceSnapshot *> &snapshots);
+    void run();
+    void serve(int fd, std::string &reply);
+};
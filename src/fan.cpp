@@ -0,0 +1,54 @@
+#include "fan.h"
+#include "helpers.h"            // for ze_error_to_str
+#include <iostream>             // for cerr, cout
+
+bool Fan::initializeFan()
+{
+    ze_result_t ret;
+
+    ret = zesFanGetProperties(fan, &properties);
+    if (ret != ZE_RESULT_SUCCESS)
+    {
+        std::cerr << "zesFanGetProperties failed: " << std::hex << ret << " (" << ze_error_to_str(ret) << ")" << std::endl;
+        return false;
+    }
+
+    // supportedUnits is a bitfield of 1 << zes_fan_speed_units_t.
+    units = properties.supportedUnits & (1 << ZES_FAN_SPEED_UNITS_RPM) ? ZES_FAN_SPEED_UNITS_RPM
+                                                                        : ZES_FAN_SPEED_UNITS_PERCENT;
+    speed = -1;
+
+    return updateStats() == ZE_RESULT_SUCCESS;
+}
+
+ze_result_t Fan::updateStats()
+{
+    ze_result_t ret;
+
+    ret = zesFanGetState(fan, units, &speed);
+    if (ret != ZE_RESULT_SUCCESS)
+    {
+        std::cerr << "zesFanGetState failed: " << std::hex << ret << " (" << ze_error_to_str(ret) << ")" << std::endl;
+        speed = -1;
+        return ret;
+    }
+
+    return ZE_RESULT_SUCCESS;
+}
+
+double Fan::getPercent() const
+{
+    if (speed < 0)
+    {
+        return -1.0;
+    }
+    if (units == ZES_FAN_SPEED_UNITS_PERCENT)
+    {
+        return speed;
+    }
+    if (properties.maxRPM > 0)
+    {
+        return 100.0 * speed / properties.maxRPM;
+    }
+    return -1.0;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <level_zero/ze_api.h>  // for _ze_result_t, ze_result_t, ZE_MAX_DE...
+#include <level_zero/zes_api.h> // for zes_device_handle_t, _zes_structure_...
+#include <cstdint>              // for int32_t
+#include <cstring>              // for memset
+#include <stdexcept>            // for runtime_error
+
+class Fan {
+public:
+    Fan(zes_fan_handle_t handle) : fan(handle)
+    {
+        std::memset(&properties, 0, sizeof(properties));
+        properties.stype = ZES_STRUCTURE_TYPE_FAN_PROPERTIES;
+
+        if (!initializeFan())
+        {
+            throw std::runtime_error("Failed to initialize fan.");
+        }
+    }
+
+    zes_fan_handle_t getHandle() const { return fan; }
+    const zes_fan_properties_t *getFanProperties() const { return &properties; }
+    ze_result_t updateStats();
+
+    // Speed in getUnits() (RPM where the fan reports it), or -1 if it
+    // can't be measured.
+    int32_t getSpeed() const { return speed; }
+    zes_fan_speed_units_t getUnits() const { return units; }
+    // Speed as a percentage of the maximum, or -1 if unknown.
+    double getPercent() const;
+
+private:
+    zes_fan_handle_t fan;
+    zes_fan_properties_t properties;
+    zes_fan_speed_units_t units;
+    int32_t speed;
+    bool initializeFan();
+};
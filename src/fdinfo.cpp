@@ -0,0 +1,516 @@
+#include "fdinfo.h"
+
+#include <fcntl.h>              // for open, O_RDONLY, O_CLOEXEC
+#include <sys/resource.h>       // for getrlimit, RLIMIT_NOFILE
+#include <unistd.h>             // for pread, readlinkat, close
+#include <algorithm>            // for lower_bound, binary_search, sort, find, max, min
+#include <cstdio>               // for snprintf
+#include <cstdlib>              // for atoi
+#include <atomic>               // for atomic
+#include <cstring>              // for memset, memcmp, memchr, memcpy, strlen
+
+namespace
+{
+struct EngineName
+{
+    const char *name;
+    int engineClass;
+};
+
+const EngineName engine_names[] = {
+    {"render", DRM_ENGINE_RENDER},         {"rcs", DRM_ENGINE_RENDER},
+    {"copy", DRM_ENGINE_COPY},             {"bcs", DRM_ENGINE_COPY},
+    {"video", DRM_ENGINE_VIDEO},           {"vcs", DRM_ENGINE_VIDEO},
+    {"video-enhance", DRM_ENGINE_VIDEO_ENHANCE}, {"vecs", DRM_ENGINE_VIDEO_ENHANCE},
+    {"compute", DRM_ENGINE_COMPUTE},       {"ccs", DRM_ENGINE_COMPUTE},
+};
+
+bool has_prefix(const char *key, size_t length, const char *prefix, size_t prefixLength)
+{
+    return length > prefixLength && std::memcmp(key, prefix, prefixLength) == 0;
+}
+
+// Parse an unsigned decimal at p, followed by an optional KiB/MiB/GiB unit.
+uint64_t parse_value(const char *p, const char *end)
+{
+    uint64_t value = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        value = value * 10 + (uint64_t)(*p++ - '0');
+    }
+    while (p < end && *p == ' ')
+    {
+        p++;
+    }
+    if (end - p >= 3 && p[1] == 'i' && p[2] == 'B')
+    {
+        switch (p[0])
+        {
+        case 'K':
+            return value << 10;
+        case 'M':
+            return value << 20;
+        case 'G':
+            return value << 30;
+        }
+    }
+    return value;
+}
+
+// Descriptors held open by every collector in the process; there is one
+// collector per device, and together they keep to fd_budget().
+std::atomic<size_t> held_fds(0);
+
+// Half of RLIMIT_NOFILE, leaving the rest for everything else.
+size_t fd_budget()
+{
+    static const size_t budget = [] {
+        struct rlimit limit;
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY)
+        {
+            return (size_t)limit.rlim_cur / 2;
+        }
+        return (size_t)512;
+    }();
+    return budget;
+}
+
+// Device memory regions are "local<n>" (i915) or "vram<n>" (xe).
+bool is_device_region(const char *name, size_t length)
+{
+    for (size_t i = 0; i + 5 <= length; ++i)
+    {
+        if (std::memcmp(name + i, "local", 5) == 0)
+            return true;
+    }
+    return length >= 4 && std::memcmp(name, "vram", 4) == 0;
+}
+
+#define PREFIX(X) X, sizeof(X) - 1
+} // namespace
+
+int drm_engine_class_from_name(const char *name, size_t length)
+{
+    for (const EngineName &each : engine_names)
+    {
+        if (std::strlen(each.name) == length && std::memcmp(each.name, name, length) == 0)
+        {
+            return each.engineClass;
+        }
+    }
+    return -1;
+}
+
+const char *drm_engine_class_to_str(int engineClass)
+{
+    switch (engineClass)
+    {
+    case DRM_ENGINE_RENDER:
+        return "RND";
+    case DRM_ENGINE_COPY:
+        return "CPY";
+    case DRM_ENGINE_VIDEO:
+        return "VID";
+    case DRM_ENGINE_VIDEO_ENHANCE:
+        return "VE";
+    case DRM_ENGINE_COMPUTE:
+        return "CMP";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+bool parse_drm_fdinfo(const char *text, size_t length, DrmFdinfo &out)
+{
+    std::memset(&out, 0, sizeof(out));
+    for (int i = 0; i < DRM_ENGINE_CLASS_COUNT; ++i)
+    {
+        out.capacity[i] = 1;
+    }
+
+    uint64_t memory[2] = {0, 0};
+    uint64_t resident[2] = {0, 0};
+    bool haveResident = false;
+
+    const char *end = text + length;
+    for (const char *line = text; line < end;)
+    {
+        const char *eol = (const char *)std::memchr(line, '\n', end - line);
+        if (!eol)
+            eol = end;
+        const char *colon = (const char *)std::memchr(line, ':', eol - line);
+        if (colon && eol - line > 4 && std::memcmp(line, "drm-", 4) == 0)
+        {
+            const char *key = line;
+            size_t keyLength = colon - line;
+            const char *value = colon + 1;
+            while (value < eol && (*value == ' ' || *value == '\t'))
+                value++;
+
+            if (keyLength == sizeof("drm-driver") - 1 && std::memcmp(key, "drm-driver", keyLength) == 0)
+            {
+                out.isDrm = true;
+            }
+            else if (keyLength == sizeof("drm-client-id") - 1 && std::memcmp(key, "drm-client-id", keyLength) == 0)
+            {
+                out.clientId = parse_value(value, eol);
+            }
+            else if (keyLength == sizeof("drm-pdev") - 1 && std::memcmp(key, "drm-pdev", keyLength) == 0)
+            {
+                size_t n = std::min<size_t>(eol - value, sizeof(out.pdev) - 1);
+                std::memcpy(out.pdev, value, n);
+                out.pdev[n] = '\0';
+            }
+            else if (has_prefix(key, keyLength, PREFIX("drm-engine-capacity-")))
+            {
+                size_t prefix = sizeof("drm-engine-capacity-") - 1;
+                int engineClass = drm_engine_class_from_name(key + prefix, keyLength - prefix);
+                if (engineClass >= 0)
+                    out.capacity[engineClass] = std::max<uint32_t>((uint32_t)parse_value(value, eol), 1);
+            }
+            else if (has_prefix(key, keyLength, PREFIX("drm-engine-")))
+            {
+                size_t prefix = sizeof("drm-engine-") - 1;
+                int engineClass = drm_engine_class_from_name(key + prefix, keyLength - prefix);
+                if (engineClass >= 0)
+                {
+                    out.engineTime[engineClass] = parse_value(value, eol);
+                    out.haveEngineTime |= 1u << engineClass;
+                }
+            }
+            else if (has_prefix(key, keyLength, PREFIX("drm-total-cycles-")))
+            {
+                size_t prefix = sizeof("drm-total-cycles-") - 1;
+                int engineClass = drm_engine_class_from_name(key + prefix, keyLength - prefix);
+                if (engineClass >= 0)
+                    out.totalCycles[engineClass] = parse_value(value, eol);
+            }
+            else if (has_prefix(key, keyLength, PREFIX("drm-cycles-")))
+            {
+                size_t prefix = sizeof("drm-cycles-") - 1;
+                int engineClass = drm_engine_class_from_name(key + prefix, keyLength - prefix);
+                if (engineClass >= 0)
+                {
+                    out.cycles[engineClass] = parse_value(value, eol);
+                    out.haveCycles |= 1u << engineClass;
+                }
+            }
+            else if (has_prefix(key, keyLength, PREFIX("drm-resident-")))
+            {
+                size_t prefix = sizeof("drm-resident-") - 1;
+                resident[is_device_region(key + prefix, keyLength - prefix)] += parse_value(value, eol);
+                haveResident = true;
+            }
+            else if (has_prefix(key, keyLength, PREFIX("drm-memory-")))
+            {
+                size_t prefix = sizeof("drm-memory-") - 1;
+                memory[is_device_region(key + prefix, keyLength - prefix)] += parse_value(value, eol);
+            }
+        }
+        line = eol + 1;
+    }
+
+    // Newer drivers report both; drm-memory-* is the older name for the
+    // resident size, so only fall back to it.
+    out.systemResident = haveResident ? resident[0] : memory[0];
+    out.vramResident = haveResident ? resident[1] : memory[1];
+    return out.isDrm;
+}
+
+DrmFdinfoCollector::DrmFdinfoCollector(std::string procRoot, std::string pdev)
+    : procRoot(std::move(procRoot)), pdev(std::move(pdev)), generation(0), timestamp(0)
+{
+}
+
+DrmFdinfoCollector::~DrmFdinfoCollector()
+{
+    for (auto &entry : processes)
+    {
+        closeProcess(*entry.second);
+    }
+}
+
+void DrmFdinfoCollector::begin(uint64_t timestamp)
+{
+    generation++;
+    this->timestamp = timestamp;
+}
+
+const DrmUsage &DrmFdinfoCollector::update(uint32_t pid, uint64_t startTime)
+{
+    std::unique_ptr<Process> &process = processes[pid];
+    if (process && process->startTime != startTime)
+    {
+        closeProcess(*process);
+        process.reset();
+    }
+    if (!process)
+    {
+        process = std::make_unique<Process>();
+        process->pid = pid;
+        process->startTime = startTime;
+        process->scans = 0;
+        process->primed = false;
+        process->previousTime = 0;
+        process->fdDir = nullptr;
+        std::memset(&process->previous, 0, sizeof(process->previous));
+    }
+    if (!process->fdDir)
+    {
+        char path[4096];
+        std::snprintf(path, sizeof(path), "%s/%u/fd", procRoot.c_str(), pid);
+        process->fdDir = opendir(path);
+        held_fds += process->fdDir != nullptr;
+    }
+
+    process->seen = generation;
+    scan(*process);
+    measure(*process);
+
+    // Past the budget, processes read this way close everything again and
+    // reclassify their fds on the next update: slower, but it can't run the
+    // process out of descriptors.
+    if (held_fds.load(std::memory_order_relaxed) > fd_budget())
+    {
+        closeProcess(*process);
+    }
+    return process->usage;
+}
+
+void DrmFdinfoCollector::end()
+{
+    for (auto it = processes.begin(); it != processes.end();)
+    {
+        if (it->second->seen != generation)
+        {
+            closeProcess(*it->second);
+            it = processes.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+size_t DrmFdinfoCollector::getOpenFdCount() const
+{
+    size_t count = 0;
+    for (const auto &entry : processes)
+    {
+        count += entry.second->drmFds.size();
+    }
+    return count;
+}
+
+size_t DrmFdinfoCollector::getHeldFdCount()
+{
+    return held_fds.load(std::memory_order_relaxed);
+}
+
+void DrmFdinfoCollector::closeProcess(Process &process)
+{
+    for (const DrmFd &fd : process.drmFds)
+    {
+        ::close(fd.fdinfo);
+    }
+    held_fds -= process.drmFds.size();
+    process.drmFds.clear();
+    if (process.fdDir)
+    {
+        closedir(process.fdDir);
+        process.fdDir = nullptr;
+        held_fds--;
+    }
+}
+
+void DrmFdinfoCollector::scan(Process &process)
+{
+    if (!process.fdDir)
+    {
+        return;
+    }
+
+    // An fd closed and reopened on a DRM device between two scans keeps its
+    // number, so now and then classify every fd again.
+    if (++process.scans % 16 == 0)
+    {
+        process.otherFds.clear();
+    }
+
+    for (DrmFd &fd : process.drmFds)
+    {
+        fd.listed = false;
+    }
+    listedOther.clear();
+
+    rewinddir(process.fdDir);
+    while (struct dirent *entry = readdir(process.fdDir))
+    {
+        if (entry->d_name[0] == '.')
+        {
+            continue;
+        }
+        int number = std::atoi(entry->d_name);
+
+        auto drm = std::lower_bound(process.drmFds.begin(), process.drmFds.end(), number,
+                                    [](const DrmFd &fd, int number) { return fd.number < number; });
+        if (drm != process.drmFds.end() && drm->number == number)
+        {
+            drm->listed = true;
+            continue;
+        }
+        if (std::binary_search(process.otherFds.begin(), process.otherFds.end(), number))
+        {
+            listedOther.push_back(number);
+            continue;
+        }
+
+        // New fd: it is a DRM client if it refers to a /dev/dri node. Only
+        // clients of this device are kept open; other devices' collectors
+        // hold their own.
+        char link[64];
+        ssize_t length = readlinkat(dirfd(process.fdDir), entry->d_name, link, sizeof(link) - 1);
+        int fdinfo = -1;
+        if (length > 9 && std::memcmp(link, "/dev/dri/", 9) == 0)
+        {
+            char path[4096];
+            std::snprintf(path, sizeof(path), "%s/%u/fdinfo/%s", procRoot.c_str(), process.pid, entry->d_name);
+            fdinfo = ::open(path, O_RDONLY | O_CLOEXEC);
+        }
+        if (fdinfo >= 0 && !pdev.empty() && !isClientOf(fdinfo))
+        {
+            ::close(fdinfo);
+            fdinfo = -1;
+        }
+        if (fdinfo >= 0)
+        {
+            held_fds++;
+            process.drmFds.insert(drm, DrmFd{number, fdinfo, true});
+        }
+        else
+        {
+            listedOther.push_back(number);
+        }
+    }
+
+    // Drop fds that have been closed.
+    for (size_t i = 0; i < process.drmFds.size();)
+    {
+        if (!process.drmFds[i].listed)
+        {
+            ::close(process.drmFds[i].fdinfo);
+            held_fds--;
+            process.drmFds.erase(process.drmFds.begin() + i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    std::sort(listedOther.begin(), listedOther.end());
+    process.otherFds.swap(listedOther);
+}
+
+bool DrmFdinfoCollector::isClientOf(int fdinfo)
+{
+    ssize_t length = pread(fdinfo, buffer, sizeof(buffer) - 1, 0);
+    DrmFdinfo info;
+    if (length <= 0 || !parse_drm_fdinfo(buffer, (size_t)length, info))
+    {
+        return false;
+    }
+    // Drivers that don't report drm-pdev can't be told apart.
+    return !info.pdev[0] || pdev == info.pdev;
+}
+
+void DrmFdinfoCollector::measure(Process &process)
+{
+    Counters current;
+    std::memset(&current, 0, sizeof(current));
+    uint32_t capacity[DRM_ENGINE_CLASS_COUNT] = {1, 1, 1, 1, 1};
+    DrmUsage &usage = process.usage;
+    usage.valid = false;
+    usage.vramResident = 0;
+    usage.systemResident = 0;
+    clients.clear();
+
+    for (size_t i = 0; i < process.drmFds.size();)
+    {
+        DrmFd &fd = process.drmFds[i];
+        ssize_t length = pread(fd.fdinfo, buffer, sizeof(buffer) - 1, 0);
+        DrmFdinfo info;
+        if (length <= 0 || !parse_drm_fdinfo(buffer, (size_t)length, info))
+        {
+            // The fd number now refers to something else.
+            ::close(fd.fdinfo);
+            held_fds--;
+            process.otherFds.insert(std::lower_bound(process.otherFds.begin(), process.otherFds.end(), fd.number),
+                                    fd.number);
+            process.drmFds.erase(process.drmFds.begin() + i);
+            continue;
+        }
+        ++i;
+
+        // Several fds can share one client (dup(), fork()); count it once.
+        if ((!pdev.empty() && info.pdev[0] && pdev != info.pdev) ||
+            std::find(clients.begin(), clients.end(), info.clientId) != clients.end())
+        {
+            continue;
+        }
+        clients.push_back(info.clientId);
+
+        usage.valid = true;
+        usage.vramResident += info.vramResident;
+        usage.systemResident += info.systemResident;
+        for (int c = 0; c < DRM_ENGINE_CLASS_COUNT; ++c)
+        {
+            current.engineTime[c] += info.engineTime[c];
+            current.cycles[c] += info.cycles[c];
+            // Every client counts cycles against the same GPU timestamp.
+            current.totalCycles[c] = std::max(current.totalCycles[c], info.totalCycles[c]);
+            capacity[c] = std::max(capacity[c], info.capacity[c]);
+        }
+        current.haveEngineTime |= info.haveEngineTime;
+        current.haveCycles |= info.haveCycles;
+    }
+
+    uint64_t elapsed = timestamp - process.previousTime;
+    for (int c = 0; c < DRM_ENGINE_CLASS_COUNT; ++c)
+    {
+        uint32_t bit = 1u << c;
+        const Counters &previous = process.previous;
+        double utilization = -1;
+        if (current.haveCycles & bit)
+        {
+            utilization = 0;
+            if (process.primed && (previous.haveCycles & bit) && current.cycles[c] >= previous.cycles[c] &&
+                current.totalCycles[c] > previous.totalCycles[c])
+            {
+                utilization = (double)(current.cycles[c] - previous.cycles[c]) /
+                              (double)(current.totalCycles[c] - previous.totalCycles[c]) * 100.0;
+            }
+        }
+        else if (current.haveEngineTime & bit)
+        {
+            // A client that went away makes the sum go backwards; report that
+            // interval as idle rather than as a huge value.
+            utilization = 0;
+            if (process.primed && (previous.haveEngineTime & bit) && current.engineTime[c] >= previous.engineTime[c] &&
+                elapsed > 0)
+            {
+                utilization = (double)(current.engineTime[c] - previous.engineTime[c]) / (double)elapsed * 100.0;
+            }
+        }
+        if (utilization > 0)
+        {
+            utilization = std::min(utilization / capacity[c], 100.0);
+        }
+        usage.utilization[c] = (float)utilization;
+    }
+
+    process.previous = current;
+    process.previousTime = timestamp;
+    process.primed = true;
+}
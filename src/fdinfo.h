@@ -0,0 +1,155 @@
+#pragma once
+
+#include "paths.h"              // for SystemPaths
+
+#include <dirent.h>             // for DIR
+#include <cstddef>              // for size_t
+#include <cstdint>              // for uint32_t, uint64_t
+#include <memory>               // for unique_ptr
+#include <string>               // for string
+#include <unordered_map>        // for unordered_map
+#include <vector>               // for vector
+
+// Engine classes as named in DRM fdinfo. i915 uses the long names
+// (render, copy, ...) and xe the short ones (rcs, bcs, ...).
+enum drm_engine_class_t
+{
+    DRM_ENGINE_RENDER,
+    DRM_ENGINE_COPY,
+    DRM_ENGINE_VIDEO,
+    DRM_ENGINE_VIDEO_ENHANCE,
+    DRM_ENGINE_COMPUTE,
+    DRM_ENGINE_CLASS_COUNT
+};
+
+// Engine class for an fdinfo key suffix, or -1 if it isn't one we know.
+int drm_engine_class_from_name(const char *name, size_t length);
+// Short column label ("RND", "CPY", ...).
+const char *drm_engine_class_to_str(int engineClass);
+
+// The fields of one /proc/<pid>/fdinfo/<fd> entry that ze-monitor uses.
+// Counters are cumulative, so they only mean something as deltas.
+struct DrmFdinfo
+{
+    // Set when the entry has a drm-driver key, i.e. the fd is a DRM client.
+    bool isDrm;
+    uint64_t clientId;
+    // drm-pdev, e.g. "0000:03:00.0"; empty for drivers that don't report it.
+    char pdev[32];
+    // drm-engine-<class>: busy time in ns.
+    uint64_t engineTime[DRM_ENGINE_CLASS_COUNT];
+    // drm-cycles-<class> and drm-total-cycles-<class>: busy cycles and the
+    // GPU timestamp they are measured against.
+    uint64_t cycles[DRM_ENGINE_CLASS_COUNT];
+    uint64_t totalCycles[DRM_ENGINE_CLASS_COUNT];
+    // drm-engine-capacity-<class>: engines of that class (1 if absent).
+    uint32_t capacity[DRM_ENGINE_CLASS_COUNT];
+    // Bits of (1 << class) present in engineTime / cycles.
+    uint32_t haveEngineTime;
+    uint32_t haveCycles;
+    // Resident bytes in device and system memory, from drm-resident-* or,
+    // for drivers without it, drm-memory-*.
+    uint64_t vramResident;
+    uint64_t systemResident;
+};
+
+// Parse the text of one fdinfo entry. Returns out.isDrm.
+bool parse_drm_fdinfo(const char *text, size_t length, DrmFdinfo &out);
+
+// GPU usage of one process on one device.
+struct DrmUsage
+{
+    // Whether the process has DRM clients on the device at all.
+    bool valid = false;
+    // Percent busy per engine class over the last interval, normalized by
+    // the class's engine count; negative when the driver doesn't report it.
+    float utilization[DRM_ENGINE_CLASS_COUNT] = {-1, -1, -1, -1, -1};
+    uint64_t vramResident = 0;
+    uint64_t systemResident = 0;
+};
+
+// Per-process GPU usage from DRM fdinfo, for the PIDs sysman reports.
+//
+// Each process's fd directory is kept open and rescanned, but only fds not
+// seen before are classified (one readlink each), and only DRM fds have
+// their fdinfo opened, which is then kept open and re-read with pread().
+// A steady process therefore costs one getdents plus one pread per DRM
+// client per update. Only clients of the collector's device are held, and
+// all collectors together hold at most half of RLIMIT_NOFILE; processes
+// beyond that are reopened on every update.
+class DrmFdinfoCollector
+{
+public:
+    // pdev limits the results to clients of one device ("" for all).
+    explicit DrmFdinfoCollector(std::string procRoot = SystemPaths::instance().proc, std::string pdev = "");
+    ~DrmFdinfoCollector();
+    DrmFdinfoCollector(const DrmFdinfoCollector &) = delete;
+    DrmFdinfoCollector &operator=(const DrmFdinfoCollector &) = delete;
+
+    void setDevice(std::string pdev) { this->pdev = std::move(pdev); }
+
+    // An update is begin(), update() for each current process, then end(),
+    // which forgets processes that weren't updated. timestamp is in ns on a
+    // monotonic clock.
+    void begin(uint64_t timestamp);
+    // startTime identifies the process across PID reuse (see
+    // read_process_start_time()).
+    const DrmUsage &update(uint32_t pid, uint64_t startTime);
+    void end();
+
+    // fdinfo files this collector holds open, across every process.
+    size_t getOpenFdCount() const;
+    // Descriptors (fd directories and fdinfo files) held open by every
+    // collector.
+    static size_t getHeldFdCount();
+
+private:
+    struct DrmFd
+    {
+        int number;
+        int fdinfo;
+        bool listed;
+    };
+
+    struct Counters
+    {
+        uint64_t engineTime[DRM_ENGINE_CLASS_COUNT];
+        uint64_t cycles[DRM_ENGINE_CLASS_COUNT];
+        uint64_t totalCycles[DRM_ENGINE_CLASS_COUNT];
+        uint32_t haveEngineTime;
+        uint32_t haveCycles;
+    };
+
+    struct Process
+    {
+        uint32_t pid;
+        uint64_t startTime;
+        DIR *fdDir;
+        // Sorted by fd number.
+        std::vector<DrmFd> drmFds;
+        // Sorted fd numbers known not to be DRM clients.
+        std::vector<int> otherFds;
+        uint32_t scans;
+        bool primed;
+        uint64_t previousTime;
+        Counters previous;
+        DrmUsage usage;
+        uint64_t seen;
+    };
+
+    std::string procRoot;
+    std::string pdev;
+    std::unordered_map<uint32_t, std::unique_ptr<Process>> processes;
+    uint64_t generation;
+    uint64_t timestamp;
+    // Scratch space reused by every update.
+    std::vector<int> listedOther;
+    std::vector<uint64_t> clients;
+    char buffer[8192];
+
+    void closeProcess(Process &process);
+    void scan(Process &process);
+    // Whether an fdinfo file belongs to a client of pdev.
+    bool isClientOf(int fdinfo);
+    void measure(Process &process);
+};
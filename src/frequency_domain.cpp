@@ -0,0 +1,87 @@
+#include "frequency_domain.h"
+#include "helpers.h"            // for ze_error_to_str
+#include <algorithm>            // for min
+#include <cstdint>              // for UINT64_MAX
+#include <iostream>             // for cerr, cout
+
+bool FrequencyDomain::initializeFrequencyDomain()
+{
+    ze_result_t ret;
+
+    ret = zesFrequencyGetProperties(frequency, &properties);
+    if (ret != ZE_RESULT_SUCCESS)
+    {
+        std::cerr << "zesFrequencyGetProperties failed: " << std::hex << ret << " (" << ze_error_to_str(ret) << ")" << std::endl;
+        return false;
+    }
+
+    // Throttle time counters are optional; the throttle reasons in the state
+    // are still useful without them.
+    ret = zesFrequencyGetThrottleTime(frequency, &throttleTime);
+    throttleTimeSupported = ret == ZE_RESULT_SUCCESS;
+
+    ret = zesFrequencyGetState(frequency, &state);
+    if (ret != ZE_RESULT_SUCCESS)
+    {
+        std::cerr << "zesFrequencyGetState failed: " << std::hex << ret << " (" << ze_error_to_str(ret) << ")" << std::endl;
+        return false;
+    }
+
+    if (!throttleTimeSupported)
+    {
+        throttleFraction = state.throttleReasons != 0 ? 1.0 : 0.0;
+    }
+
+    return true;
+}
+
+ze_result_t FrequencyDomain::updateStats()
+{
+    ze_result_t ret;
+
+    ret = zesFrequencyGetState(frequency, &state);
+    if (ret != ZE_RESULT_SUCCESS)
+    {
+        std::cerr << "zesFrequencyGetState failed: " << std::hex << ret << " (" << ze_error_to_str(ret) << ")" << std::endl;
+        return ret;
+    }
+
+    if (throttleTimeSupported)
+    {
+        return updateThrottleTime();
+    }
+
+    throttleFraction = state.throttleReasons != 0 ? 1.0 : 0.0;
+    return ZE_RESULT_SUCCESS;
+}
+
+ze_result_t FrequencyDomain::updateThrottleTime()
+{
+    zes_freq_throttle_time_t previous = throttleTime;
+    ze_result_t ret;
+
+    ret = zesFrequencyGetThrottleTime(frequency, &throttleTime);
+    if (ret != ZE_RESULT_SUCCESS)
+    {
+        std::cerr << "zesFrequencyGetThrottleTime failed: " << std::hex << ret << " (" << ze_error_to_str(ret) << ")" << std::endl;
+        return ret;
+    }
+
+    // Both values are in microseconds. As with the memory bandwidth
+    // counters, a timestamp that went backwards means a reset, so that
+    // interval is skipped.
+    uint64_t elapsed = throttleTime.timestamp - previous.timestamp;
+    if (elapsed == 0)
+    {
+        return ZE_RESULT_SUCCESS;
+    }
+    uint64_t throttled = throttleTime.throttleTime - previous.throttleTime;
+    if (elapsed > UINT64_MAX / 2 || throttled > UINT64_MAX / 2)
+    {
+        throttleFraction = 0;
+        return ZE_RESULT_SUCCESS;
+    }
+
+    throttleFraction = std::min((double)throttled / (double)elapsed, 1.0);
+    return ZE_RESULT_SUCCESS;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <level_zero/ze_api.h>  // for _ze_result_t, ze_result_t, ZE_MAX_DE...
+#include <level_zero/zes_api.h> // for zes_device_handle_t, _zes_structure_...
+#include <cstring>              // for memset
+#include <stdexcept>            // for runtime_error
+
+// One frequency domain (GPU, memory or media): its current, requested,
+// efficient and TDP frequencies, why it is being throttled and, where the
+// driver keeps a throttle time counter, how much of each interval was spent
+// throttled.
+class FrequencyDomain {
+public:
+    FrequencyDomain(zes_freq_handle_t handle) : frequency(handle)
+    {
+        std::memset(&properties, 0, sizeof(properties));
+        properties.stype = ZES_STRUCTURE_TYPE_FREQ_PROPERTIES;
+        std::memset(&state, 0, sizeof(state));
+        state.stype = ZES_STRUCTURE_TYPE_FREQ_STATE;
+        std::memset(&throttleTime, 0, sizeof(throttleTime));
+
+        if (!initializeFrequencyDomain())
+        {
+            throw std::runtime_error("Failed to initialize frequency domain.");
+        }
+    }
+
+    zes_freq_handle_t getHandle() const { return frequency; }
+    const zes_freq_properties_t *getFrequencyProperties() const { return &properties; }
+    // Frequencies are in MHz; any the driver doesn't know are negative.
+    const zes_freq_state_t *getFrequencyState() const { return &state; }
+    ze_result_t updateStats();
+
+    bool isThrottleTimeSupported() const { return throttleTimeSupported; }
+    // Fraction (0 to 1) of the interval between the last two updateStats()
+    // calls that the domain spent throttled. Without a throttle time counter
+    // this is 1 if the latest state reports any throttle reason and 0 if not.
+    double getThrottleFraction() const { return throttleFraction; }
+
+private:
+    zes_freq_handle_t frequency;
+    zes_freq_properties_t properties;
+    zes_freq_state_t state;
+    zes_freq_throttle_time_t throttleTime;
+    bool throttleTimeSupported = false;
+    double throttleFraction = 0;
+
+    bool initializeFrequencyDomain();
+    ze_result_t updateThrottleTime();
+};
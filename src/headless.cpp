@@ -0,0 +1,17 @@
+#include "headless.h"
+
+void prepare_headless(const std::vector<Device *> &devices, ThreadPool &pool, component_flags_t components,
+                      std::chrono::milliseconds power_window, std::chrono::milliseconds display_period,
+                      double smoothing)
+{
+    TaskGroup group(pool);
+    for (Device *device : devices)
+    {
+        // Both only reach components enumerated after they are set.
+        device->setPowerWindow(power_window);
+        device->setEngineDecimation(display_period, smoothing);
+        device->require(components);
+        group.run([device, &pool, components]() { device->initializeComponents(components, &pool); });
+    }
+    group.wait();
+}
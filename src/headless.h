@@ -0,0 +1,26 @@
+#pragma once
+
+#include "components.h"
+#include "device.h"
+#include "thread_pool.h"
+
+#include <chrono>               // for milliseconds
+#include <vector>               // for vector
+
+// What --exporter samples: everything that has a metric. Processes are left
+// out: scanning /proc is the most expensive thing ze-monitor does and has no
+// metric here.
+constexpr component_flags_t EXPORTER_COMPONENTS = COMPONENT_ENGINES | COMPONENT_POWER | COMPONENT_MEMORY |
+                                                  COMPONENT_THERMAL | COMPONENT_FREQUENCY | COMPONENT_PCI |
+                                                  COMPONENT_RAS;
+// What --stream samples. Process energy is apportioned from the device's,
+// so processes need power too.
+constexpr component_flags_t STREAM_COMPONENTS =
+    COMPONENT_ENGINES | COMPONENT_POWER | COMPONENT_MEMORY | COMPONENT_THERMAL | COMPONENT_PROCESSES;
+
+// Enumerate components on every device for a run without the UI. Engines
+// are averaged over display_period and smoothed as in the UI, and power over
+// power_window. Must happen before the labels for the output are read.
+void prepare_headless(const std::vector<Device *> &devices, ThreadPool &pool, component_flags_t components,
+                      std::chrono::milliseconds power_window, std::chrono::milliseconds display_period,
+                      double smoothing);
@@ -1,4 +1,5 @@
 #include "helpers.h"
+#include "paths.h"
 #include <array> // Optional: If using std::array for UUID representation
 #include <bitset>
 #include <cstdint>
@@ -19,6 +20,7 @@
 #include <time.h>
 #include <unistd.h>
 #include <unordered_map>
+#include <utility>
 #include <variant>
 
 std::string fit_label(const std::string &label, uint32_t max_width, justify_dir_t justify)
@@ -236,6 +238,190 @@ const char *voltage_status_to_str(zes_psu_voltage_status_t type)
 #undef type_to_str
 }
 
+const char *mem_type_to_str(zes_mem_type_t type)
+{
+// Define a macro to prevent having to type each code twice...
+#define type_to_str(X) \
+    case X:            \
+        return #X;     \
+        break
+
+    switch (type)
+    {
+        type_to_str(ZES_MEM_TYPE_HBM);
+        type_to_str(ZES_MEM_TYPE_DDR);
+        type_to_str(ZES_MEM_TYPE_DDR3);
+        type_to_str(ZES_MEM_TYPE_DDR4);
+        type_to_str(ZES_MEM_TYPE_DDR5);
+        type_to_str(ZES_MEM_TYPE_LPDDR);
+        type_to_str(ZES_MEM_TYPE_LPDDR3);
+        type_to_str(ZES_MEM_TYPE_LPDDR4);
+        type_to_str(ZES_MEM_TYPE_LPDDR5);
+        type_to_str(ZES_MEM_TYPE_SRAM);
+        type_to_str(ZES_MEM_TYPE_L1);
+        type_to_str(ZES_MEM_TYPE_L3);
+        type_to_str(ZES_MEM_TYPE_GRF);
+        type_to_str(ZES_MEM_TYPE_SLM);
+        type_to_str(ZES_MEM_TYPE_GDDR4);
+        type_to_str(ZES_MEM_TYPE_GDDR5);
+        type_to_str(ZES_MEM_TYPE_GDDR5X);
+        type_to_str(ZES_MEM_TYPE_GDDR6);
+        type_to_str(ZES_MEM_TYPE_GDDR6X);
+    default:
+        return "UNKNOWN";
+        break;
+    }
+#undef type_to_str
+}
+
+const char *mem_health_to_str(zes_mem_health_t health)
+{
+    switch (health)
+    {
+    case ZES_MEM_HEALTH_OK:
+        return "OK";
+    case ZES_MEM_HEALTH_DEGRADED:
+        return "DEGRADED";
+    case ZES_MEM_HEALTH_CRITICAL:
+        return "CRITICAL";
+    case ZES_MEM_HEALTH_REPLACE:
+        return "REPLACE";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+const char *freq_domain_to_str(zes_freq_domain_t type)
+{
+    switch (type)
+    {
+    case ZES_FREQ_DOMAIN_GPU:
+        return "GPU";
+    case ZES_FREQ_DOMAIN_MEMORY:
+        return "MEMORY";
+    case ZES_FREQ_DOMAIN_MEDIA:
+        return "MEDIA";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+std::string throttle_reasons_to_str(zes_freq_throttle_reason_flags_t flags)
+{
+    // In a fixed order, so the text doesn't shuffle between redraws.
+    static const std::pair<zes_freq_throttle_reason_flags_t, const char *> reasons[] = {
+        {ZES_FREQ_THROTTLE_REASON_FLAG_AVE_PWR_CAP, "POWER"},
+        {ZES_FREQ_THROTTLE_REASON_FLAG_BURST_PWR_CAP, "BURST"},
+        {ZES_FREQ_THROTTLE_REASON_FLAG_CURRENT_LIMIT, "CURRENT"},
+        {ZES_FREQ_THROTTLE_REASON_FLAG_THERMAL_LIMIT, "THERMAL"},
+        {ZES_FREQ_THROTTLE_REASON_FLAG_PSU_ALERT, "PSU"},
+        {ZES_FREQ_THROTTLE_REASON_FLAG_SW_RANGE, "SW_RANGE"},
+        {ZES_FREQ_THROTTLE_REASON_FLAG_HW_RANGE, "HW_RANGE"}};
+
+    std::string text;
+    for (const auto &[flag, name] : reasons)
+    {
+        if (flags & flag)
+        {
+            if (!text.empty())
+            {
+                text += " ";
+            }
+            text += name;
+        }
+    }
+
+    return text;
+}
+
+const char *ras_category_to_str(zes_ras_error_cat_t category)
+{
+    switch (category)
+    {
+    case ZES_RAS_ERROR_CAT_RESET:
+        return "RESET";
+    case ZES_RAS_ERROR_CAT_PROGRAMMING_ERRORS:
+        return "PROGRAMMING";
+    case ZES_RAS_ERROR_CAT_DRIVER_ERRORS:
+        return "DRIVER";
+    case ZES_RAS_ERROR_CAT_COMPUTE_ERRORS:
+        return "COMPUTE";
+    case ZES_RAS_ERROR_CAT_NON_COMPUTE_ERRORS:
+        return "NON_COMPUTE";
+    case ZES_RAS_ERROR_CAT_CACHE_ERRORS:
+        return "CACHE";
+    case ZES_RAS_ERROR_CAT_DISPLAY_ERRORS:
+        return "DISPLAY";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+const char *temp_sensor_to_str(zes_temp_sensors_t type)
+{
+    switch (type)
+    {
+    case ZES_TEMP_SENSORS_GLOBAL:
+        return "GLOBAL";
+    case ZES_TEMP_SENSORS_GPU:
+        return "GPU";
+    case ZES_TEMP_SENSORS_MEMORY:
+        return "MEMORY";
+    case ZES_TEMP_SENSORS_GLOBAL_MIN:
+        return "GLOBAL_MIN";
+    case ZES_TEMP_SENSORS_GPU_MIN:
+        return "GPU_MIN";
+    case ZES_TEMP_SENSORS_MEMORY_MIN:
+        return "MEMORY_MIN";
+    case ZES_TEMP_SENSORS_GPU_BOARD:
+        return "GPU_BOARD";
+    case ZES_TEMP_SENSORS_GPU_BOARD_MIN:
+        return "GPU_BOARD_MIN";
+    case ZES_TEMP_SENSORS_VOLTAGE_REGULATOR:
+        return "VOLTAGE_REG";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+const char *power_level_to_str(zes_power_level_t level)
+{
+    switch (level)
+    {
+    case ZES_POWER_LEVEL_SUSTAINED:
+        return "SUSTAINED";
+    case ZES_POWER_LEVEL_BURST:
+        return "BURST";
+    case ZES_POWER_LEVEL_PEAK:
+        return "PEAK";
+    case ZES_POWER_LEVEL_INSTANTANEOUS:
+        return "INSTANTANEOUS";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+const char *pci_link_status_to_str(zes_pci_link_status_t status)
+{
+    switch (status)
+    {
+    case ZES_PCI_LINK_STATUS_GOOD:
+        return "GOOD";
+    case ZES_PCI_LINK_STATUS_QUALITY_ISSUES:
+        return "QUALITY ISSUES";
+    case ZES_PCI_LINK_STATUS_STABILITY_ISSUES:
+        return "STABILITY ISSUES";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+std::string pci_speed_to_str(const zes_pci_speed_t &speed)
+{
+    return "Gen" + (speed.gen > 0 ? std::to_string(speed.gen) : std::string("?")) + " x" +
+           (speed.width > 0 ? std::to_string(speed.width) : std::string("?"));
+}
+
 std::string engine_flags_to_str(zes_engine_type_flags_t flags)
 {
     std::ostringstream oss;
@@ -280,9 +466,21 @@ pciid_t get_pci_id_for_render_node(const std::string &render_path)
     }
 
     int minor_number = minor(sb.st_rdev);
+    if (!S_ISCHR(sb.st_mode))
+    {
+        // Not a device node, as in a fake tree; the minor of renderD<N> is N.
+        std::smatch match;
+        std::string name = fs::path(render_path).filename();
+        if (!std::regex_match(name, match, std::regex("renderD([0-9]+)")))
+        {
+            return result;
+        }
+        minor_number = std::stoi(match[1]);
+    }
 
     // Look through the /sys/class/drm directory for the corresponding device
-    for (const auto &entry : fs::directory_iterator("/sys/class/drm"))
+    std::error_code error;
+    for (const auto &entry : fs::directory_iterator(SystemPaths::instance().sys + "/class/drm", error))
     {
         std::string drm_name = entry.path().filename();
 
@@ -49,5 +49,16 @@ zes_uuid_t uuid_from_string(const std::string &str);
 const char *ze_error_to_str(ze_result_t ret);
 const char *engine_type_to_str(zes_engine_group_t type);
 const char *voltage_status_to_str(zes_psu_voltage_status_t type);
+const char *mem_type_to_str(zes_mem_type_t type);
+const char *mem_health_to_str(zes_mem_health_t health);
+const char *freq_domain_to_str(zes_freq_domain_t type);
+// Space separated short names ("POWER THERMAL"), empty if not throttled.
+std::string throttle_reasons_to_str(zes_freq_throttle_reason_flags_t flags);
+const char *ras_category_to_str(zes_ras_error_cat_t category);
+const char *temp_sensor_to_str(zes_temp_sensors_t type);
+const char *power_level_to_str(zes_power_level_t level);
+const char *pci_link_status_to_str(zes_pci_link_status_t status);
+// "Gen4 x16", with "?" for whatever the driver doesn't know.
+std::string pci_speed_to_str(const zes_pci_speed_t &speed);
 std::string engine_flags_to_str(zes_engine_type_flags_t flags);
 pciid_t get_pci_id_for_render_node(const std::string &render_path);
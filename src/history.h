@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>            // for min, max
+#include <atomic>               // for atomic, atomic_thread_fence
+#include <cmath>                // for lround
+#include <cstdint>              // for uint16_t, int16_t, uint64_t
+#include <memory>               // for unique_ptr, make_unique
+#include <type_traits>          // for is_integral, make_unsigned
+#include <vector>               // for vector
+
+// Compact encodings for MetricHistory. Each one maps a displayed value to a
+// small fixed-point integer and back, clamping anything out of range.
+
+// Utilization percent as permille (0.1% steps) in 16 bits.
+struct PermilleEncoding
+{
+    typedef uint16_t Stored;
+    static Stored encode(double percent) { return (Stored)std::lround(std::min(std::max(percent, 0.0), 100.0) * 10.0); }
+    static double decode(Stored value) { return value / 10.0; }
+};
+
+// Temperature in tenths of a degree Celsius, -3276.8 to 3276.7.
+struct DeciDegreeEncoding
+{
+    typedef int16_t Stored;
+    static Stored encode(double celsius) { return (Stored)std::lround(std::min(std::max(celsius, -3276.8), 3276.7) * 10.0); }
+    static double decode(Stored value) { return value / 10.0; }
+};
+
+// Power in tenths of a watt, up to 6553.5W.
+struct DeciWattEncoding
+{
+    typedef uint16_t Stored;
+    static Stored encode(double watts) { return (Stored)std::lround(std::min(std::max(watts, 0.0), 6553.5) * 10.0); }
+    static double decode(Stored value) { return value / 10.0; }
+};
+
+// Fixed-capacity history of one metric, stored in the compact form given by
+// Encoding and packed several values to a 64-bit word, so hours of history
+// for every engine, sensor and power domain fit in a few MB.
+//
+// Like RingBuffer, there is a single writer (the sampler) and any number of
+// lock-free readers; values are kept in relaxed atomic words and a reader
+// drops whatever the writer may have overwritten while it was copying.
+template <typename Encoding>
+class MetricHistory
+{
+    typedef typename Encoding::Stored Stored;
+    typedef typename std::make_unsigned<Stored>::type Bits;
+    static_assert(std::is_integral<Stored>::value && sizeof(Stored) <= 4, "Stored values must be small integers");
+
+public:
+    explicit MetricHistory(size_t capacity)
+        : capacity(std::max<size_t>(capacity, 1)), claimed(0), committed(0),
+          words(std::make_unique<std::atomic<uint64_t>[]>((this->capacity + PER_WORD - 1) / PER_WORD))
+    {
+        for (size_t i = 0; i < (this->capacity + PER_WORD - 1) / PER_WORD; ++i)
+        {
+            words[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    size_t getCapacity() const { return capacity; }
+    // Total number of values ever pushed.
+    uint64_t getCount() const { return committed.load(std::memory_order_acquire); }
+    size_t getMemoryUsage() const { return sizeof(*this) + (capacity + PER_WORD - 1) / PER_WORD * sizeof(uint64_t); }
+
+    // Writer only: append a value, overwriting the oldest once full.
+    void push(double value)
+    {
+        uint64_t index = committed.load(std::memory_order_relaxed);
+        claimed.store(index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        size_t slot = index % capacity;
+        unsigned shift = (slot % PER_WORD) * BITS;
+        std::atomic<uint64_t> &word = words[slot / PER_WORD];
+        // Only this thread writes, so a plain load/modify/store is enough.
+        uint64_t packed = word.load(std::memory_order_relaxed);
+        packed &= ~(MASK << shift);
+        packed |= (uint64_t)(Bits)Encoding::encode(value) << shift;
+        word.store(packed, std::memory_order_relaxed);
+
+        committed.store(index + 1, std::memory_order_release);
+    }
+
+    // Decode up to max of the most recent values, oldest first, into out
+    // (replacing its contents). Returns the number of values.
+    size_t read(std::vector<double> &out, size_t max) const
+    {
+        uint64_t end = committed.load(std::memory_order_acquire);
+        size_t count = (size_t)std::min<uint64_t>({end, (uint64_t)capacity, (uint64_t)max});
+        uint64_t begin = end - count;
+
+        out.resize(count);
+        for (uint64_t index = begin; index < end; ++index)
+        {
+            size_t slot = index % capacity;
+            uint64_t packed = words[slot / PER_WORD].load(std::memory_order_relaxed);
+            Bits bits = (Bits)((packed >> ((slot % PER_WORD) * BITS)) & MASK);
+            out[index - begin] = Encoding::decode((Stored)bits);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t overwritten = claimed.load(std::memory_order_relaxed);
+        if (overwritten > capacity && overwritten - capacity > begin)
+        {
+            size_t torn = (size_t)std::min<uint64_t>(overwritten - capacity - begin, count);
+            out.erase(out.begin(), out.begin() + torn);
+        }
+        return out.size();
+    }
+
+private:
+    static constexpr unsigned BITS = sizeof(Stored) * 8;
+    static constexpr size_t PER_WORD = 64 / BITS;
+    static constexpr uint64_t MASK = (BITS == 64) ? ~0ull : ((1ull << BITS) - 1);
+
+    size_t capacity;
+    std::atomic<uint64_t> claimed;
+    std::atomic<uint64_t> committed;
+    std::unique_ptr<std::atomic<uint64_t>[]> words;
+};
+
+typedef MetricHistory<PermilleEncoding> UtilizationHistory;
+typedef MetricHistory<DeciDegreeEncoding> TemperatureHistory;
+typedef MetricHistory<DeciWattEncoding> PowerHistory;
@@ -0,0 +1,92 @@
+#include "memory_module.h"
+#include "helpers.h"            // for ze_error_to_str
+#include <cstdint>              // for UINT64_MAX
+#include <iostream>             // for cerr, cout
+
+bool MemoryModule::initializeMemoryModule()
+{
+    ze_result_t ret;
+
+    ret = zesMemoryGetProperties(memory, &properties);
+    if (ret != ZE_RESULT_SUCCESS)
+    {
+        std::cerr << "zesMemoryGetProperties failed: " << std::hex << ret << " (" << ze_error_to_str(ret) << ")" << std::endl;
+        return false;
+    }
+
+    // Not all hardware exposes bandwidth counters; usage is still useful
+    // without them.
+    ret = zesMemoryGetBandwidth(memory, &bandwidth);
+    bandwidthSupported = ret == ZE_RESULT_SUCCESS;
+    bandwidthPrimed = bandwidthSupported;
+
+    ret = zesMemoryGetState(memory, &state);
+    if (ret != ZE_RESULT_SUCCESS)
+    {
+        std::cerr << "zesMemoryGetState failed: " << std::hex << ret << " (" << ze_error_to_str(ret) << ")" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+ze_result_t MemoryModule::updateStats()
+{
+    ze_result_t ret;
+
+    ret = zesMemoryGetState(memory, &state);
+    if (ret != ZE_RESULT_SUCCESS)
+    {
+        std::cerr << "zesMemoryGetState failed: " << std::hex << ret << " (" << ze_error_to_str(ret) << ")" << std::endl;
+        return ret;
+    }
+
+    if (bandwidthSupported)
+    {
+        return updateBandwidth();
+    }
+
+    return ZE_RESULT_SUCCESS;
+}
+
+ze_result_t MemoryModule::updateBandwidth()
+{
+    zes_mem_bandwidth_t previous = bandwidth;
+    ze_result_t ret;
+
+    ret = zesMemoryGetBandwidth(memory, &bandwidth);
+    if (ret != ZE_RESULT_SUCCESS)
+    {
+        std::cerr << "zesMemoryGetBandwidth failed: " << std::hex << ret << " (" << ze_error_to_str(ret) << ")" << std::endl;
+        return ret;
+    }
+
+    if (!bandwidthPrimed)
+    {
+        bandwidthPrimed = true;
+        return ZE_RESULT_SUCCESS;
+    }
+
+    // Counters are cumulative bytes and the timestamp is in microseconds.
+    // Unsigned deltas handle a 64-bit wrap; a timestamp that went backwards
+    // means the counters were reset, so skip that interval.
+    uint64_t elapsed = bandwidth.timestamp - previous.timestamp;
+    if (elapsed == 0)
+    {
+        return ZE_RESULT_SUCCESS;
+    }
+    if (elapsed > UINT64_MAX / 2)
+    {
+        readBandwidth = 0;
+        writeBandwidth = 0;
+        return ZE_RESULT_SUCCESS;
+    }
+
+    uint64_t read = bandwidth.readCounter - previous.readCounter;
+    uint64_t write = bandwidth.writeCounter - previous.writeCounter;
+    double seconds = (double)elapsed / 1000000.0;
+    readBandwidth = read > UINT64_MAX / 2 ? 0.0 : (double)read / seconds;
+    writeBandwidth = write > UINT64_MAX / 2 ? 0.0 : (double)write / seconds;
+
+    return ZE_RESULT_SUCCESS;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <level_zero/ze_api.h>  // for _ze_result_t, ze_result_t, ZE_MAX_DE...
+#include <level_zero/zes_api.h> // for zes_device_handle_t, _zes_structure_...
+#include <cstring>              // for memset
+#include <memory>               // for unique_ptr, allocator, make_unique
+#include <stdexcept>            // for runtime_error
+#include <vector>               // for vector
+
+// One memory module: its live state (free/size/health) and, where the
+// driver supports it, read/write bandwidth derived from the module's
+// cumulative byte counters.
+class MemoryModule {
+public:
+    MemoryModule(zes_mem_handle_t handle) : memory(handle)
+    {
+        std::memset(&properties, 0, sizeof(properties));
+        properties.stype = ZES_STRUCTURE_TYPE_MEM_PROPERTIES;
+        std::memset(&state, 0, sizeof(state));
+        state.stype = ZES_STRUCTURE_TYPE_MEM_STATE;
+        std::memset(&bandwidth, 0, sizeof(bandwidth));
+
+        if (!initializeMemoryModule())
+        {
+            throw std::runtime_error("Failed to initialize memory module.");
+        }
+    }
+
+    zes_mem_handle_t getHandle() const { return memory; }
+    const zes_mem_properties_t *getMemoryProperties() const { return &properties; }
+    const zes_mem_state_t *getMemoryState() const { return &state; }
+    ze_result_t updateStats();
+
+    bool isBandwidthSupported() const { return bandwidthSupported; }
+    // Bytes per second over the interval between the last two updateStats()
+    // calls; zero until there have been two.
+    double getReadBandwidth() const { return readBandwidth; }
+    double getWriteBandwidth() const { return writeBandwidth; }
+    // Bytes per second the module can currently sustain, as reported by the
+    // driver (0 if unknown).
+    double getMaxBandwidth() const { return (double)bandwidth.maxBandwidth; }
+
+private:
+    zes_mem_handle_t memory;
+    zes_mem_properties_t properties;
+    zes_mem_state_t state;
+    zes_mem_bandwidth_t bandwidth;
+    bool bandwidthSupported = false;
+    bool bandwidthPrimed = false;
+    double readBandwidth = 0;
+    double writeBandwidth = 0;
+
+    bool initializeMemoryModule();
+    ze_result_t updateBandwidth();
+};
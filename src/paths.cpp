@@ -0,0 +1,7 @@
+#include "paths.h"
+
+SystemPaths &SystemPaths::instance()
+{
+    static SystemPaths paths;
+    return paths;
+}
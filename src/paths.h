@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>               // for string
+
+// Roots of the kernel filesystems ze-monitor reads. They default to the real
+// ones; --procfs-root and --sysfs-root point them at another tree, such as
+// the generated fixtures the tests use on machines without a GPU.
+struct SystemPaths
+{
+    std::string proc = "/proc";
+    std::string sys = "/sys";
+
+    // The process-wide paths. Set them before creating any Device: process
+    // collectors take their root when they are constructed.
+    static SystemPaths &instance();
+};
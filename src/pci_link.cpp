@@ -0,0 +1,111 @@
+#include "pci_link.h"
+#include "helpers.h"            // for ze_error_to_str
+#include <cstdint>              // for UINT64_MAX
+#include <iostream>             // for cerr, cout
+
+void PciLink::initializePciLink()
+{
+    stateSupported = zesDevicePciGetState(device, &state) == ZE_RESULT_SUCCESS;
+    statsSupported = zesDevicePciGetStats(device, &stats) == ZE_RESULT_SUCCESS;
+    statsPrimed = statsSupported;
+}
+
+ze_result_t PciLink::updateStats()
+{
+    ze_result_t ret;
+
+    if (stateSupported)
+    {
+        ret = zesDevicePciGetState(device, &state);
+        if (ret != ZE_RESULT_SUCCESS)
+        {
+            std::cerr << "zesDevicePciGetState failed: " << std::hex << ret << " (" << ze_error_to_str(ret) << ")" << std::endl;
+            return ret;
+        }
+    }
+
+    if (statsSupported)
+    {
+        return updateCounters();
+    }
+
+    return ZE_RESULT_SUCCESS;
+}
+
+ze_result_t PciLink::updateCounters()
+{
+    zes_pci_stats_t previous = stats;
+    ze_result_t ret;
+
+    ret = zesDevicePciGetStats(device, &stats);
+    if (ret != ZE_RESULT_SUCCESS)
+    {
+        std::cerr << "zesDevicePciGetStats failed: " << std::hex << ret << " (" << ze_error_to_str(ret) << ")" << std::endl;
+        return ret;
+    }
+
+    if (!statsPrimed)
+    {
+        statsPrimed = true;
+        return ZE_RESULT_SUCCESS;
+    }
+
+    // Same rules as the memory bandwidth counters: the timestamp is in
+    // microseconds, unsigned deltas handle a wrap and a timestamp that went
+    // backwards means a reset.
+    uint64_t elapsed = stats.timestamp - previous.timestamp;
+    if (elapsed == 0)
+    {
+        return ZE_RESULT_SUCCESS;
+    }
+    if (elapsed > UINT64_MAX / 2)
+    {
+        rxBandwidth = 0;
+        txBandwidth = 0;
+        packetRate = 0;
+        replayRate = 0;
+        return ZE_RESULT_SUCCESS;
+    }
+
+    double seconds = (double)elapsed / 1000000.0;
+    auto rate = [seconds](uint64_t current, uint64_t last) {
+        uint64_t delta = current - last;
+        return delta > UINT64_MAX / 2 ? 0.0 : (double)delta / seconds;
+    };
+    if (properties.haveBandwidthCounters)
+    {
+        rxBandwidth = rate(stats.rxCounter, previous.rxCounter);
+        txBandwidth = rate(stats.txCounter, previous.txCounter);
+    }
+    if (properties.havePacketCounters)
+    {
+        packetRate = rate(stats.packetCounter, previous.packetCounter);
+    }
+    if (properties.haveReplayCounters)
+    {
+        replayRate = rate(stats.replayCounter, previous.replayCounter);
+    }
+
+    return ZE_RESULT_SUCCESS;
+}
+
+zes_pci_speed_t PciLink::getSpeed() const
+{
+    if (stateSupported)
+    {
+        return state.speed;
+    }
+    if (statsSupported)
+    {
+        return stats.speed;
+    }
+    return zes_pci_speed_t{-1, -1, -1};
+}
+
+bool PciLink::isDegraded() const
+{
+    zes_pci_speed_t current = getSpeed();
+    const zes_pci_speed_t &max = properties.maxSpeed;
+    return (current.gen > 0 && max.gen > 0 && current.gen < max.gen) ||
+           (current.width > 0 && max.width > 0 && current.width < max.width);
+}
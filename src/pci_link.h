@@ -0,0 +1,62 @@
+#pragma once
+
+#include <level_zero/ze_api.h>  // for _ze_result_t, ze_result_t, ZE_MAX_DE...
+#include <level_zero/zes_api.h> // for zes_device_handle_t, _zes_structure_...
+#include <cstring>              // for memset
+
+// The device's PCIe link: its current speed and health from
+// zesDevicePciGetState and, where the driver keeps the counters, receive and
+// transmit bandwidth and packet and replay rates from zesDevicePciGetStats.
+//
+// Either query may be unsupported. The link is still created so the maximum
+// speed from the PCI properties can be shown; what is missing reads as
+// unknown.
+class PciLink {
+public:
+    PciLink(zes_device_handle_t handle, const zes_pci_properties_t &properties)
+        : device(handle), properties(properties)
+    {
+        std::memset(&state, 0, sizeof(state));
+        state.stype = ZES_STRUCTURE_TYPE_PCI_STATE;
+        std::memset(&stats, 0, sizeof(stats));
+
+        initializePciLink();
+    }
+
+    zes_device_handle_t getHandle() const { return device; }
+    const zes_pci_properties_t *getPciProperties() const { return &properties; }
+    const zes_pci_state_t *getPciState() const { return &state; }
+    ze_result_t updateStats();
+
+    bool isStateSupported() const { return stateSupported; }
+    bool isStatsSupported() const { return statsSupported; }
+    // Current generation, width and bandwidth; fields the driver doesn't
+    // know are negative.
+    zes_pci_speed_t getSpeed() const;
+    // Whether the link trained below what it is capable of, e.g. x4 instead
+    // of x16 or Gen3 instead of Gen4. False when either side is unknown.
+    bool isDegraded() const;
+
+    // Rates over the interval between the last two updateStats() calls,
+    // zero until there have been two. Bandwidths are bytes per second.
+    double getRxBandwidth() const { return rxBandwidth; }
+    double getTxBandwidth() const { return txBandwidth; }
+    double getPacketRate() const { return packetRate; }
+    double getReplayRate() const { return replayRate; }
+
+private:
+    zes_device_handle_t device;
+    zes_pci_properties_t properties;
+    zes_pci_state_t state;
+    zes_pci_stats_t stats;
+    bool stateSupported = false;
+    bool statsSupported = false;
+    bool statsPrimed = false;
+    double rxBandwidth = 0;
+    double txBandwidth = 0;
+    double packetRate = 0;
+    double replayRate = 0;
+
+    void initializePciLink();
+    ze_result_t updateCounters();
+};
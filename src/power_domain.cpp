@@ -1,4 +1,7 @@
 #include "power_domain.h"
+#include "helpers.h"            // for ze_error_to_str
+#include <algorithm>            // for max
+#include <cstdint>              // for UINT32_MAX, UINT64_MAX
 #include <iostream>             // for cerr, cout
 
 bool PowerDomain::initializePowerDomain() {
@@ -17,12 +20,21 @@ bool PowerDomain::initializePowerDomain() {
         return false;
     }
 
+    // Limits are extra detail; power is still worth showing without them.
+    updateLimits();
+
     return true;
 }
 
+void PowerDomain::restart()
+{
+    points.clear();
+    points.push_back(Point{counter.timestamp, sessionEnergy});
+    watts = 0;
+}
+
 ze_result_t PowerDomain::updateStats() {
-    uint64_t lastEnergy = counter.energy;
-    uint64_t lastTimestamp = counter.timestamp;
+    zes_power_energy_counter_t previous = counter;
     ze_result_t ret;
 
     ret = zesPowerGetEnergyCounter(power, &counter);
@@ -31,16 +43,120 @@ ze_result_t PowerDomain::updateStats() {
         std::cerr << "Failed to get energy counter." << std::endl;
         return ret;
     }
+    wide = wide || counter.energy > UINT32_MAX;
 
-    if ((counter.timestamp - lastTimestamp) > 0)
+    if (!primed)
     {
-        energy = (counter.energy - lastEnergy) /
-                (counter.timestamp - lastTimestamp);
+        primed = true;
+        restart();
+        return ZE_RESULT_SUCCESS;
     }
-    else
+
+    // Unsigned deltas handle a 64 bit wrap. A timestamp that went backwards
+    // means the counters were reset.
+    uint64_t elapsed = counter.timestamp - previous.timestamp;
+    if (elapsed == 0)
     {
-        energy = 0;
+        return ZE_RESULT_SUCCESS;
+    }
+    if (elapsed > UINT64_MAX / 2)
+    {
+        restart();
+        return ZE_RESULT_SUCCESS;
     }
 
+    uint64_t energy = counter.energy - previous.energy;
+    if (energy > UINT64_MAX / 2)
+    {
+        // Some hardware keeps a 32 bit counter, which at a few hundred
+        // watts wraps every few seconds. It is only taken for a wrap if the
+        // counter has never been wider and the energy that implies could
+        // have been drawn in the time; anything else was reset.
+        energy = ((uint64_t)UINT32_MAX + 1 - previous.energy) + counter.energy;
+        if (wide || (double)energy > (double)elapsed * getPowerCeiling())
+        {
+            restart();
+            return ZE_RESULT_SUCCESS;
+        }
+    }
+
+    sessionEnergy += energy;
+    points.push_back(Point{counter.timestamp, sessionEnergy});
+    // Keep one point at or before the start of the window so the whole
+    // window is measured.
+    uint64_t span = (uint64_t)window.count();
+    while (points.size() > 2 && counter.timestamp - points[1].timestamp >= span)
+    {
+        points.pop_front();
+    }
+
+    // Microjoules per microsecond is watts.
+    const Point &first = points.front();
+    const Point &last = points.back();
+    watts = (double)(last.energy - first.energy) / (double)(last.timestamp - first.timestamp);
+
     return ZE_RESULT_SUCCESS;
 }
+
+ze_result_t PowerDomain::updateLimits()
+{
+    uint32_t count = 0;
+    ze_result_t ret;
+
+    ret = zesPowerGetLimitsExt(power, &count, nullptr);
+    if (ret == ZE_RESULT_SUCCESS && count > 0)
+    {
+        limits.resize(count);
+        for (zes_power_limit_ext_desc_t &limit : limits)
+        {
+            std::memset(&limit, 0, sizeof(limit));
+            limit.stype = ZES_STRUCTURE_TYPE_POWER_LIMIT_EXT_DESC;
+        }
+        ret = zesPowerGetLimitsExt(power, &count, limits.data());
+        limits.resize(ret == ZE_RESULT_SUCCESS ? count : 0);
+    }
+    else
+    {
+        limits.clear();
+    }
+
+    if (ret != ZE_RESULT_SUCCESS && ret != ZE_RESULT_ERROR_UNSUPPORTED_FEATURE)
+    {
+        std::cerr << "zesPowerGetLimitsExt failed: " << std::hex << ret << " (" << ze_error_to_str(ret) << ")" << std::endl;
+    }
+    return ret;
+}
+
+double PowerDomain::getPowerCeiling() const
+{
+    // Twice the highest limit leaves room for bursts above it. Without any
+    // limits, no single domain draws anywhere near 2 kW.
+    double highest = properties.maxLimit > 0 ? properties.maxLimit / 1000.0 : 0;
+    for (const zes_power_limit_ext_desc_t &limit : limits)
+    {
+        if (limit.limitUnit == ZES_LIMIT_UNIT_POWER && limit.limit > 0)
+        {
+            highest = std::max(highest, limit.limit / 1000.0);
+        }
+    }
+    return highest > 0 ? 2 * highest : 2000;
+}
+
+double PowerDomain::getLimit(zes_power_level_t level) const
+{
+    double lowest = -1;
+    for (const zes_power_limit_ext_desc_t &limit : limits)
+    {
+        // Limits in milliamps can't be compared with power.
+        if (limit.level != level || !limit.enabled || limit.limitUnit != ZES_LIMIT_UNIT_POWER || limit.limit <= 0)
+        {
+            continue;
+        }
+        double value = limit.limit / 1000.0;
+        if (lowest < 0 || value < lowest)
+        {
+            lowest = value;
+        }
+    }
+    return lowest;
+}
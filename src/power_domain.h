@@ -1,6 +1,8 @@
 #pragma once
 
+#include <chrono>               // for microseconds, seconds
 #include <cstring>              // for unique_ptr, allocator, make_unique
+#include <deque>                // for deque
 #include <iostream>             // for cerr, cout
 #include <level_zero/ze_api.h>  // for _ze_result_t, ze_result_t, ZE_MAX_DE...
 #include <level_zero/zes_api.h> // for zes_device_handle_t, _zes_structure_...
@@ -10,7 +12,11 @@
 
 class PowerDomain {
 public:
-    PowerDomain(zes_pwr_handle_t handle) : power(handle)
+    // Power is averaged over the counter readings in the last window, or
+    // between the last two readings if the window is shorter than the
+    // sampling period.
+    PowerDomain(zes_pwr_handle_t handle, std::chrono::microseconds window = std::chrono::seconds(1))
+        : power(handle), window(window)
     {
         std::memset(&properties, 0, sizeof(properties));
         properties.stype = ZES_STRUCTURE_TYPE_POWER_PROPERTIES;
@@ -23,24 +29,44 @@ public:
     }
 
     zes_pwr_handle_t getHandle() const { return power; }
-    double getPowerDomainEnergy()
-    {
-        ze_result_t ret = updateStats();
-        if (ret != ZE_RESULT_SUCCESS)
-        {
-            std::cerr << "Failed to get activity for engine." << std::endl;
-            return 0;
-        }
-        return energy;
-    }
+    // Watts over the window, as of the most recent updateStats() call.
+    double getPower() const { return watts; }
+    // Joules used since the domain was initialized.
+    double getSessionEnergy() const { return sessionEnergy / 1e6; }
     const zes_power_properties_t *getPowerDomainProperties() const { return &properties; }
+    ze_result_t updateStats();
+
+    // Limits as read by updateLimits(); empty if the driver has none.
+    const std::vector<zes_power_limit_ext_desc_t> &getLimits() const { return limits; }
+    // The lowest enabled power limit at level in watts, or -1 if there is
+    // none.
+    double getLimit(zes_power_level_t level) const;
+    ze_result_t updateLimits();
+
+private:
+    struct Point
+    {
+        // Microseconds, from the counter.
+        uint64_t timestamp;
+        // Microjoules since the session started, unwrapped.
+        uint64_t energy;
+    };
 
-private:    
     zes_pwr_handle_t power;
+    std::chrono::microseconds window;
     zes_power_properties_t properties;
     zes_power_energy_counter_t counter;
-    double energy;
+    std::vector<zes_power_limit_ext_desc_t> limits;
+    bool primed = false;
+    // Set once the counter has read above UINT32_MAX, which rules out a
+    // 32 bit counter.
+    bool wide = false;
+    uint64_t sessionEnergy = 0;
+    double watts = 0;
+    // Oldest first, spanning at least window once there are enough.
+    std::deque<Point> points;
     bool initializePowerDomain();
-    ze_result_t updateStats();
+    void restart();
+    // Most power the domain could plausibly draw, in watts.
+    double getPowerCeiling() const;
 };
-
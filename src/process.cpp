@@ -1,36 +1,227 @@
 #include "process.h"
 #include "helpers.h"
 
-ze_result_t ProcessMonitor::updateProcessStats()
+#include <fcntl.h>              // for open, O_RDONLY, O_CLOEXEC
+#include <sys/stat.h>           // for stat
+#include <unistd.h>             // for read, close
+#include <chrono>               // for steady_clock, nanoseconds
+#include <cstdio>               // for snprintf
+#include <cstdlib>              // for strtoull
+#include <cstring>              // for strchr, strrchr
+
+uint64_t read_process_start_time(uint32_t pid, const std::string &procRoot)
 {
-    zes_process_state_t processes[_MAX_PROCESS];
-    uint32_t count = _MAX_PROCESS;
+    // Read into a fixed buffer rather than through streams: this runs for
+    // every GPU process on every refresh.
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/%u/stat", procRoot.c_str(), pid);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return 0;
+    char buffer[512];
+    ssize_t length = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (length <= 0)
+        return 0;
+    buffer[length] = '\0';
 
-    ze_result_t ret = zesDeviceProcessesGetState(device, &count, processes);
-    if (ret != ZE_RESULT_SUCCESS && ret != ZE_RESULT_ERROR_INVALID_SIZE)
+    // comm (field 2) is in parentheses and may itself contain spaces or
+    // parentheses, so count fields from the last ')'. That is followed by
+    // state (field 3); starttime is field 22.
+    char *field = strrchr(buffer, ')');
+    if (!field)
+        return 0;
+    for (int i = 2; i < 22 && field; ++i)
     {
-        std::cerr << "Unable to get process information (ret " << std::hex << ret << "): " << ze_error_to_str(ret) << std::endl;
-        return ZE_RESULT_ERROR_UNSUPPORTED_FEATURE;
+        field = strchr(field + 1, ' ');
     }
+    return field ? strtoull(field + 1, nullptr, 10) : 0;
+}
 
-    if (ret == ZE_RESULT_ERROR_INVALID_SIZE)
+// Read a whole /proc file into out; false if it couldn't be opened.
+static bool read_proc_file(const char *path, std::string &out)
+{
+    out.clear();
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    char buffer[4096];
+    ssize_t length;
+    while ((length = read(fd, buffer, sizeof(buffer))) > 0)
+    {
+        out.append(buffer, length);
+    }
+    close(fd);
+    return true;
+}
+
+std::shared_ptr<const ProcessMetadata> ProcessMetadataCache::lookup(uint32_t pid, uint64_t startTime)
+{
+    auto found = index.find(pid);
+    if (found != index.end())
     {
-        count = std::min(count, _MAX_PROCESS);
-        ret = zesDeviceProcessesGetState(device, &count, processes);
-        if (ret != ZE_RESULT_SUCCESS)
+        if ((*found->second)->startTime == startTime)
         {
-            std::cerr << "Retry failed to get process info (ret " << std::hex << ret << "): " << ze_error_to_str(ret) << std::endl;
+            entries.splice(entries.begin(), entries, found->second);
+            return *found->second;
+        }
+        // The PID was reused.
+        entries.erase(found->second);
+        index.erase(found);
+    }
+
+    loads++;
+    auto metadata = std::make_shared<ProcessMetadata>();
+    metadata->pid = pid;
+    metadata->startTime = startTime;
+
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/%u", procRoot.c_str(), pid);
+    struct stat status;
+    if (stat(path, &status) == 0)
+    {
+        metadata->uid = status.st_uid;
+    }
+
+    snprintf(path, sizeof(path), "%s/%u/comm", procRoot.c_str(), pid);
+    if (read_proc_file(path, metadata->name))
+    {
+        while (!metadata->name.empty() && metadata->name.back() == '\n')
+            metadata->name.pop_back();
+    }
+    else
+    {
+        metadata->name = "N/A";
+    }
+
+    snprintf(path, sizeof(path), "%s/%u/cmdline", procRoot.c_str(), pid);
+    if (!read_proc_file(path, metadata->commandLine))
+    {
+        metadata->commandLine = "N/A";
+    }
+    for (char &c : metadata->commandLine)
+    {
+        if (c == '\0')
+            c = ' '; // Replace null terminators with spaces
+    }
+    while (!metadata->commandLine.empty() && metadata->commandLine.back() == ' ')
+        metadata->commandLine.pop_back();
+    if (metadata->commandLine.empty())
+    {
+        metadata->commandLine = "[" + metadata->name + "]";
+    }
+
+    entries.push_front(std::move(metadata));
+    index[pid] = entries.begin();
+    if (entries.size() > capacity)
+    {
+        index.erase(entries.back()->pid);
+        entries.pop_back();
+    }
+    return entries.front();
+}
+
+ze_result_t ProcessMonitor::fetchProcessStates(uint32_t &count)
+{
+    // The buffer persists across updates and only ever grows, so once it
+    // has reached the device's working set this allocates nothing. A count
+    // of zero just asks the driver how many processes there are.
+    for (int attempt = 0; attempt < 4; ++attempt)
+    {
+        count = (uint32_t)states.size();
+        ze_result_t ret = zesDeviceProcessesGetState(device, &count, states.empty() ? nullptr : states.data());
+        bool tooSmall = ret == ZE_RESULT_ERROR_INVALID_SIZE || (ret == ZE_RESULT_SUCCESS && count > states.size());
+        if (ret != ZE_RESULT_SUCCESS && !tooSmall)
+        {
+            std::cerr << "Unable to get process information (ret " << std::hex << ret << "): " << ze_error_to_str(ret) << std::endl;
             return ZE_RESULT_ERROR_UNSUPPORTED_FEATURE;
         }
+        if (!tooSmall)
+        {
+            return ZE_RESULT_SUCCESS;
+        }
+        // Leave room for processes that start before the retry.
+        states.resize(count + count / 4 + 16);
+    }
+
+    std::cerr << "Retry failed to get process info: process count kept growing" << std::endl;
+    return ZE_RESULT_ERROR_UNSUPPORTED_FEATURE;
+}
+
+ze_result_t ProcessMonitor::updateProcessStats()
+{
+    uint32_t count = 0;
+    ze_result_t ret = fetchProcessStates(count);
+    if (ret != ZE_RESULT_SUCCESS)
+    {
+        return ret;
     }
 
-    // TODO: Walk looking for matching pids in new array and only update the
-    // zes_process_state_t fields; don't re-look up the process info
+    generation++;
     processInfo.clear();
+    fdinfo.begin(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now().time_since_epoch())
+                      .count());
     for (size_t i = 0; i < count; ++i)
     {
-        processInfo.emplace_back(std::make_unique<ProcessInfo>(processes[i]));
+        uint32_t pid = states[i].processId;
+        auto &info = tracked[pid];
+        // A PID the driver keeps reporting almost always belongs to the same
+        // process, so its start time is only read again every
+        // START_TIME_REVALIDATION updates, staggered by PID, to catch reuse.
+        uint64_t startTime;
+        if (info && (pid + generation) % START_TIME_REVALIDATION != 0)
+        {
+            startTime = info->getStartTime();
+        }
+        else
+        {
+            startTime = read_process_start_time(pid, procRoot);
+            startTimeReads++;
+        }
+        if (info && info->getStartTime() == startTime)
+        {
+            info->update(states[i]);
+        }
+        else
+        {
+            // New, or the PID now belongs to a different process. Records of
+            // exited processes are reused before allocating new ones.
+            if (info)
+            {
+                pool.push_back(std::move(info));
+            }
+            if (pool.empty())
+            {
+                info = std::make_unique<ProcessInfo>(states[i], metadata.lookup(pid, startTime));
+            }
+            else
+            {
+                info = std::move(pool.back());
+                pool.pop_back();
+                info->reset(states[i], metadata.lookup(pid, startTime));
+            }
+        }
+        info->seen = generation;
+        info->drm_usage = fdinfo.update(pid, startTime);
+        processInfo.push_back(info.get());
+    }
+    fdinfo.end();
+
+    // Retire processes the driver no longer reports.
+    for (auto it = tracked.begin(); it != tracked.end();)
+    {
+        if (it->second->seen != generation)
+        {
+            it->second->metadata.reset();
+            pool.push_back(std::move(it->second));
+            it = tracked.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
     }
 
     return ZE_RESULT_SUCCESS;
-}
\ No newline at end of file
+}
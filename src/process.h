@@ -1,73 +1,156 @@
 #pragma once
 
+#include "fdinfo.h"           // for DrmFdinfoCollector, DrmUsage
+#include "paths.h"            // for SystemPaths
+
 #include <level_zero/ze_api.h>  // for _ze_result_t, ze_result_t, ZE_MAX_DE...
 #include <level_zero/zes_api.h> // for zes_device_handle_t, _zes_structure_...
-#include <fstream>              // for basic_ostream, operator<<, endl, bas...
-#include <stdexcept>            // for runtime_error
+#include <sys/types.h>          // for uid_t
+#include <algorithm>            // for max
 #include <iostream>             // for cerr, cout
-#include <memory>               // for unique_ptr, allocator, make_unique
-#include <sstream>              // for basic_ostringstream
+#include <list>                 // for list
+#include <memory>               // for unique_ptr, shared_ptr, make_unique
+#include <string>               // for string
+#include <unordered_map>        // for unordered_map
 #include <vector>               // for vector
 
+// Start time of pid in clock ticks since boot (field 22 of
+// /proc/<pid>/stat), or 0 if it can't be read. Together with the PID this
+// identifies a process even once the PID has been reused.
+uint64_t read_process_start_time(uint32_t pid, const std::string &procRoot = SystemPaths::instance().proc);
+
+// What ze-monitor shows about a process beyond the driver's values. It is
+// read from /proc once, when the process is first seen, and never changes.
+struct ProcessMetadata
+{
+    uint32_t pid = 0;
+    uint64_t startTime = 0;
+    uid_t uid = (uid_t)-1;
+    // /proc/<pid>/cmdline with the separators turned into spaces, or the
+    // name in brackets for processes without one (as ps does).
+    std::string commandLine;
+    // /proc/<pid>/comm
+    std::string name;
+};
+
+// Bounded cache of ProcessMetadata keyed by PID and start time, evicting the
+// least recently used entry once full. Entries are shared so a ProcessInfo
+// keeps its metadata even after the cache has moved on.
+class ProcessMetadataCache
+{
+public:
+    explicit ProcessMetadataCache(size_t capacity = 4096, std::string procRoot = SystemPaths::instance().proc)
+        : capacity(std::max<size_t>(capacity, 1)), loads(0), procRoot(std::move(procRoot))
+    {
+    }
+
+    // Metadata for pid, reading /proc only if it isn't cached or the PID now
+    // belongs to a process with a different start time.
+    std::shared_ptr<const ProcessMetadata> lookup(uint32_t pid, uint64_t startTime);
+
+    size_t getSize() const { return entries.size(); }
+    size_t getCapacity() const { return capacity; }
+    // Number of lookups that had to read /proc.
+    uint64_t getLoadCount() const { return loads; }
+
+private:
+    typedef std::list<std::shared_ptr<const ProcessMetadata>> Entries;
+
+    size_t capacity;
+    uint64_t loads;
+    std::string procRoot;
+    // Most recently used first.
+    Entries entries;
+    std::unordered_map<uint32_t, Entries::iterator> index;
+};
+
 class ProcessInfo
 {
 public:
-    explicit ProcessInfo(zes_process_state_t state) : state(state)
+    ProcessInfo(const zes_process_state_t &state, std::shared_ptr<const ProcessMetadata> metadata)
+    {
+        reset(state, std::move(metadata));
+    }
+
+    // Reuse this record for a different process.
+    void reset(const zes_process_state_t &state, std::shared_ptr<const ProcessMetadata> metadata)
     {
+        this->metadata = std::move(metadata);
         pid = state.processId;
-        command_line = getCommandLine();
+        update(state);
+    }
+
+    // Refresh the values that change while a process runs.
+    void update(const zes_process_state_t &state)
+    {
+        this->state = state;
         used_memory = state.memSize;
         shared_memory = state.sharedSize;
-        // engine_flags = ... ; // need to set from state.engines
-        engine_flags = "RENDER COMPUTE"; // placeholder
     }
 
     const zes_process_state_t *getProcessState() const { return &state; }
-    std::string getProcessName() const { return readFile("/proc/" + std::to_string(state.processId) + "/comm"); }
-    std::string getCommandLine() const
-    {
-        std::string cmdline = readFile("/proc/" + std::to_string(state.processId) + "/cmdline");
-        for (char &c : cmdline)
-        {
-            if (c == '\0')
-                c = ' '; // Replace null terminators with spaces
-        }
-        return cmdline;
-    }
+    uint64_t getStartTime() const { return metadata->startTime; }
+    uid_t getUid() const { return metadata->uid; }
+    const std::string &getProcessName() const { return metadata->name; }
+    const std::string &getCommandLine() const { return metadata->commandLine; }
 
     uint32_t pid;
-    std::string command_line;
     uint64_t used_memory;
     uint64_t shared_memory;
-    std::string engine_flags;
+    // Per engine class utilization and memory residency from DRM fdinfo.
+    DrmUsage drm_usage;
 
 private:
     zes_process_state_t state;
-
-    static std::string readFile(const std::string &path)
-    {
-        std::ifstream file(path);
-        if (!file)
-            return "N/A";
-        std::ostringstream buffer;
-        buffer << file.rdbuf();
-        return buffer.str();
-    }
+    std::shared_ptr<const ProcessMetadata> metadata;
+    // ProcessMonitor::updateProcessStats() pass that last reported this
+    // process.
+    uint64_t seen = 0;
+    friend class ProcessMonitor;
 };
 
+// Tracks the processes using a device across updates. Each process is
+// keyed by PID and start time, so a refresh only updates the driver's
+// per-process values for processes it already knows, looks up metadata and
+// the start time for new ones and drops the ones that have exited. Records and the buffer the
+// driver fills are reused, so polling a steady set of processes allocates
+// nothing however many there are.
 class ProcessMonitor
 {
 public:
-    explicit ProcessMonitor(zes_device_handle_t handle) : device(handle)
+    explicit ProcessMonitor(zes_device_handle_t handle, std::string procRoot = SystemPaths::instance().proc)
+        : device(handle), procRoot(procRoot), metadata(4096, procRoot), fdinfo(procRoot), generation(0)
     {
     }
 
     ze_result_t updateProcessStats();
+    // PCI address ("0000:03:00.0") of the device, so that fdinfo usage only
+    // counts clients of this device.
+    void setPciAddress(std::string address) { fdinfo.setDevice(std::move(address)); }
+    // Size of the buffer zesDeviceProcessesGetState fills.
+    size_t getBufferCapacity() const { return states.size(); }
+    // Processes from the last update, in the order the driver reported them.
     uint32_t getProcessCount() const { return processInfo.size(); }
-    const ProcessInfo *getProcessInfo(uint32_t index) const { return processInfo[index].get(); }
+    const ProcessInfo *getProcessInfo(uint32_t index) const { return processInfo[index]; }
+    // Number of times a process start time has been read from procfs.
+    uint64_t getStartTimeReadCount() const { return startTimeReads; }
+
+    // A tracked process has its start time read again once in this many
+    // updates.
+    static constexpr uint64_t START_TIME_REVALIDATION = 16;
 
 private:
     zes_device_handle_t device;
-    std::vector<std::unique_ptr<ProcessInfo>> processInfo;
-    static const uint32_t _MAX_PROCESS = 2048;
+    std::string procRoot;
+    std::unordered_map<uint32_t, std::unique_ptr<ProcessInfo>> tracked;
+    std::vector<ProcessInfo *> processInfo;
+    // Records of exited processes, ready for reuse.
+    std::vector<std::unique_ptr<ProcessInfo>> pool;
+    std::vector<zes_process_state_t> states;
+    ProcessMetadataCache metadata;
+    DrmFdinfoCollector fdinfo;
+    uint64_t generation;
+    uint64_t startTimeReads = 0;
+
+    ze_result_t fetchProcessStates(uint32_t &count);
 };
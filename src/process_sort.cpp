@@ -0,0 +1,108 @@
+#include "process_sort.h"
+
+#include <algorithm>            // for partial_sort, max, min
+#include <numeric>              // for iota
+
+namespace
+{
+// Memory is compared in whole MiB, so allocator noise doesn't reorder rows.
+uint64_t memory_key(uint64_t bytes)
+{
+    return bytes >> 20;
+}
+} // namespace
+
+const char *process_sort_key_to_str(ProcessSortKey key)
+{
+    switch (key)
+    {
+    case ProcessSortKey::MEMORY:
+        return "memory";
+    case ProcessSortKey::SHARED:
+        return "shared";
+    case ProcessSortKey::UTILIZATION:
+        return "utilization";
+    case ProcessSortKey::PID:
+        return "PID";
+    case ProcessSortKey::NAME:
+        return "name";
+    }
+    return "unknown";
+}
+
+ProcessSortKey next_process_sort_key(ProcessSortKey key)
+{
+    switch (key)
+    {
+    case ProcessSortKey::MEMORY:
+        return ProcessSortKey::SHARED;
+    case ProcessSortKey::SHARED:
+        return ProcessSortKey::UTILIZATION;
+    case ProcessSortKey::UTILIZATION:
+        return ProcessSortKey::PID;
+    case ProcessSortKey::PID:
+        return ProcessSortKey::NAME;
+    case ProcessSortKey::NAME:
+        return ProcessSortKey::MEMORY;
+    }
+    return ProcessSortKey::MEMORY;
+}
+
+int process_utilization(const ProcessSample &process)
+{
+    if (!process.drm.valid)
+    {
+        return -1;
+    }
+    float busiest = -1;
+    for (float utilization : process.drm.utilization)
+    {
+        busiest = std::max(busiest, utilization);
+    }
+    return busiest < 0 ? -1 : (int)busiest;
+}
+
+void select_top_processes(const std::vector<ProcessSample> &processes, ProcessSortKey key, size_t count,
+                          std::vector<uint32_t> &order)
+{
+    order.resize(processes.size());
+    std::iota(order.begin(), order.end(), 0);
+    auto middle = order.begin() + std::min(count, order.size());
+
+    auto by = [&processes](auto rank) {
+        return [&processes, rank](uint32_t a, uint32_t b) {
+            const ProcessSample &left = processes[a];
+            const ProcessSample &right = processes[b];
+            int compare = rank(left, right);
+            return compare != 0 ? compare < 0 : left.pid < right.pid;
+        };
+    };
+    auto descending = [](auto left, auto right) { return left > right ? -1 : left < right ? 1 : 0; };
+
+    switch (key)
+    {
+    case ProcessSortKey::MEMORY:
+        std::partial_sort(order.begin(), middle, order.end(), by([&](const ProcessSample &a, const ProcessSample &b) {
+                              return descending(memory_key(a.used_memory), memory_key(b.used_memory));
+                          }));
+        break;
+    case ProcessSortKey::SHARED:
+        std::partial_sort(order.begin(), middle, order.end(), by([&](const ProcessSample &a, const ProcessSample &b) {
+                              return descending(memory_key(a.shared_memory), memory_key(b.shared_memory));
+                          }));
+        break;
+    case ProcessSortKey::UTILIZATION:
+        std::partial_sort(order.begin(), middle, order.end(), by([&](const ProcessSample &a, const ProcessSample &b) {
+                              return descending(process_utilization(a), process_utilization(b));
+                          }));
+        break;
+    case ProcessSortKey::PID:
+        std::partial_sort(order.begin(), middle, order.end(),
+                          by([](const ProcessSample &, const ProcessSample &) { return 0; }));
+        break;
+    case ProcessSortKey::NAME:
+        std::partial_sort(order.begin(), middle, order.end(),
+                          by([](const ProcessSample &a, const ProcessSample &b) { return a.name.compare(b.name); }));
+        break;
+    }
+}
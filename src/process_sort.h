@@ -0,0 +1,36 @@
+#pragma once
+
+#include "snapshot.h"           // for ProcessSample
+
+#include <cstddef>              // for size_t
+#include <cstdint>              // for uint32_t
+#include <vector>               // for vector
+
+// Columns the process views can be sorted by.
+enum class ProcessSortKey
+{
+    MEMORY,
+    SHARED,
+    UTILIZATION,
+    PID,
+    NAME
+};
+
+const char *process_sort_key_to_str(ProcessSortKey key);
+// The key after key, wrapping around; what the sort key binding steps to.
+ProcessSortKey next_process_sort_key(ProcessSortKey key);
+
+// Busiest engine class of a process as a whole percent, or -1 if fdinfo
+// gave nothing for it.
+int process_utilization(const ProcessSample &process);
+
+// Replace order with the indices of processes ranked by key: largest first
+// for amounts, smallest first for PID and name. Only the first count are
+// guaranteed to be in order (a partial sort, so the cost is O(n log count)
+// rather than sorting everything), which is all a screen of rows needs.
+//
+// Utilization is compared at the displayed resolution, memory in whole MiB,
+// and every tie falls back to the PID, so the order is total and rows don't
+// swap places between ticks over differences that aren't visible.
+void select_top_processes(const std::vector<ProcessSample> &processes, ProcessSortKey key, size_t count,
+                          std::vector<uint32_t> &order);
@@ -0,0 +1,51 @@
+#include "profile.h"
+
+#include <algorithm>            // for sort
+#include <map>                  // for map
+
+StartupProfile::Scope::Scope(std::string phase) : phase(std::move(phase)), start(std::chrono::steady_clock::now())
+{
+}
+
+StartupProfile::Scope::~Scope()
+{
+    StartupProfile::instance().record(phase, start, std::chrono::steady_clock::now());
+}
+
+StartupProfile &StartupProfile::instance()
+{
+    static StartupProfile profile;
+    return profile;
+}
+
+void StartupProfile::record(const std::string &phase, std::chrono::steady_clock::time_point start,
+                            std::chrono::steady_clock::time_point end)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    phases.push_back({phase, start - origin, end - start, std::this_thread::get_id()});
+}
+
+void StartupProfile::report(FILE *out) const
+{
+    std::vector<Phase> sorted;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sorted = phases;
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Phase &a, const Phase &b) { return a.offset < b.offset; });
+
+    // Number threads in order of first appearance; easier to read than ids.
+    std::map<std::thread::id, uint32_t> threads;
+    for (const Phase &phase : sorted)
+    {
+        threads.emplace(phase.thread, threads.size());
+    }
+
+    fprintf(out, "Startup profile:\n");
+    fprintf(out, "  %10s %10s %6s  %s\n", "START(ms)", "TIME(ms)", "THREAD", "PHASE");
+    for (const Phase &phase : sorted)
+    {
+        fprintf(out, "  %10.3f %10.3f %6u  %s\n", phase.offset.count() / 1e6, phase.duration.count() / 1e6,
+                threads[phase.thread], phase.name.c_str());
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>               // for steady_clock, nanoseconds
+#include <cstdio>               // for FILE
+#include <mutex>                // for mutex
+#include <string>               // for string
+#include <thread>               // for thread::id
+#include <vector>               // for vector
+
+// Records how long each startup phase took (zesInit, driver discovery, and
+// every per-device enumeration) so `--startup-profile` can show where time
+// goes. Phases may be recorded from any thread; overlapping phases show up
+// with overlapping start offsets.
+class StartupProfile
+{
+public:
+    // Times the enclosing block and records it as one phase.
+    class Scope
+    {
+    public:
+        explicit Scope(std::string phase);
+        ~Scope();
+
+    private:
+        std::string phase;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    static StartupProfile &instance();
+
+    void record(const std::string &phase, std::chrono::steady_clock::time_point start,
+                std::chrono::steady_clock::time_point end);
+    void report(FILE *out) const;
+
+private:
+    struct Phase
+    {
+        std::string name;
+        std::chrono::nanoseconds offset;
+        std::chrono::nanoseconds duration;
+        std::thread::id thread;
+    };
+
+    StartupProfile() : origin(std::chrono::steady_clock::now()) {}
+
+    std::chrono::steady_clock::time_point origin;
+    mutable std::mutex mutex;
+    std::vector<Phase> phases;
+};
@@ -25,12 +25,12 @@ public:
     zes_psu_handle_t getHandle() const { return psu; }
     const zes_psu_state_t *getPSUState() const { return &state; }
     const zes_psu_properties_t *getPSUProperties() const { return &properties; }
+    ze_result_t updateStats();
 
 private:    
     zes_psu_handle_t psu;
     zes_psu_properties_t properties;
     zes_psu_state_t state;
     bool initializePSU();
-    ze_result_t updateStats();
 };
 
@@ -0,0 +1,112 @@
+#include "ras_error_set.h"
+#include "helpers.h"            // for ze_error_to_str
+#include <algorithm>            // for max
+#include <iostream>             // for cerr, cout
+#include <ratio>                // for ratio
+
+namespace
+{
+uint64_t stateTotal(const zes_ras_state_t &state)
+{
+    uint64_t total = 0;
+    for (uint64_t count : state.category)
+    {
+        total += count;
+    }
+    return total;
+}
+} // namespace
+
+bool RasErrorSet::initializeRasErrorSet()
+{
+    ze_result_t ret;
+
+    ret = zesRasGetProperties(ras, &properties);
+    if (ret != ZE_RESULT_SUCCESS)
+    {
+        std::cerr << "zesRasGetProperties failed: " << std::hex << ret << " (" << ze_error_to_str(ret) << ")" << std::endl;
+        return false;
+    }
+
+    // Read without clearing: other tools may be watching the same counters.
+    ret = zesRasGetState(ras, false, &state);
+    if (ret != ZE_RESULT_SUCCESS)
+    {
+        std::cerr << "zesRasGetState failed: " << std::hex << ret << " (" << ze_error_to_str(ret) << ")" << std::endl;
+        return false;
+    }
+
+    total = stateTotal(state);
+    history.push_back(Point{std::chrono::steady_clock::now(), 0});
+    return true;
+}
+
+ze_result_t RasErrorSet::updateStats(std::chrono::steady_clock::time_point now)
+{
+    ze_result_t ret;
+
+    ret = zesRasGetState(ras, false, &state);
+    if (ret != ZE_RESULT_SUCCESS)
+    {
+        std::cerr << "zesRasGetState failed: " << std::hex << ret << " (" << ze_error_to_str(ret) << ")" << std::endl;
+        return ret;
+    }
+
+    // Counters only go down if someone cleared them, in which case all of
+    // the current count is new.
+    uint64_t current = stateTotal(state);
+    delta = current >= total ? current - total : current;
+    total = current;
+    errors += delta;
+
+    if (!history.empty() && now < history.back().time)
+    {
+        // Keep the history ordered even if the caller's clock lags.
+        now = history.back().time;
+    }
+    history.push_back(Point{now, errors});
+    // Keep one point at or before the start of the window so the whole
+    // window can be measured.
+    while (history.size() > 2 && history[1].time <= now - window)
+    {
+        history.pop_front();
+    }
+
+    return ZE_RESULT_SUCCESS;
+}
+
+uint64_t RasErrorSet::errorsSince(std::chrono::steady_clock::time_point time) const
+{
+    // The newest point at or before time; errors after it are "since".
+    uint64_t before = history.front().errors;
+    for (const Point &point : history)
+    {
+        if (point.time > time)
+        {
+            break;
+        }
+        before = point.errors;
+    }
+    return errors - before;
+}
+
+double RasErrorSet::getRate() const
+{
+    auto now = history.back().time;
+    auto start = std::max(history.front().time, now - window);
+    double hours = std::chrono::duration<double, std::ratio<3600>>(now - start).count();
+    if (hours <= 0)
+    {
+        return 0.0;
+    }
+    return (double)errorsSince(start) / hours;
+}
+
+bool RasErrorSet::isRising() const
+{
+    auto now = history.back().time;
+    auto middle = now - window / 2;
+    uint64_t newer = errorsSince(middle);
+    uint64_t older = errorsSince(now - window) - newer;
+    return newer > older;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <level_zero/ze_api.h>  // for _ze_result_t, ze_result_t, ZE_MAX_DE...
+#include <level_zero/zes_api.h> // for zes_device_handle_t, _zes_structure_...
+#include <chrono>               // for steady_clock, minutes
+#include <cstdint>              // for uint64_t
+#include <cstring>              // for memset
+#include <deque>                // for deque
+#include <stdexcept>            // for runtime_error
+
+// One RAS error set: the correctable or the uncorrectable error counters of
+// a device or sub-device, per category. Counters are never cleared; each
+// update records how many errors are new and keeps enough history to give
+// an error rate over a trailing window and to tell whether it is climbing.
+class RasErrorSet {
+public:
+    RasErrorSet(zes_ras_handle_t handle, std::chrono::steady_clock::duration window = std::chrono::minutes(10))
+        : ras(handle), window(window)
+    {
+        std::memset(&properties, 0, sizeof(properties));
+        properties.stype = ZES_STRUCTURE_TYPE_RAS_PROPERTIES;
+        std::memset(&state, 0, sizeof(state));
+        state.stype = ZES_STRUCTURE_TYPE_RAS_STATE;
+
+        if (!initializeRasErrorSet())
+        {
+            throw std::runtime_error("Failed to initialize RAS error set.");
+        }
+    }
+
+    zes_ras_handle_t getHandle() const { return ras; }
+    const zes_ras_properties_t *getRasProperties() const { return &properties; }
+    // Counts per zes_ras_error_cat_t since the driver started counting.
+    const zes_ras_state_t *getRasState() const { return &state; }
+    ze_result_t updateStats(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+    // Errors across every category.
+    uint64_t getTotal() const { return total; }
+    // Errors that are new since the previous update.
+    uint64_t getDelta() const { return delta; }
+    // Errors per hour over the trailing window (or as much of it as has
+    // been seen).
+    double getRate() const;
+    // More errors in the newer half of the window than in the older half.
+    bool isRising() const;
+
+private:
+    struct Point
+    {
+        std::chrono::steady_clock::time_point time;
+        // Running count of errors seen by this session.
+        uint64_t errors;
+    };
+
+    zes_ras_handle_t ras;
+    std::chrono::steady_clock::duration window;
+    zes_ras_properties_t properties;
+    zes_ras_state_t state;
+    uint64_t total = 0;
+    uint64_t delta = 0;
+    uint64_t errors = 0;
+    // Oldest first, covering at least window.
+    std::deque<Point> history;
+
+    bool initializeRasErrorSet();
+    uint64_t errorsSince(std::chrono::steady_clock::time_point time) const;
+};
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>            // for min
+#include <array>                // for array
+#include <atomic>               // for atomic, atomic_thread_fence
+#include <cstdint>              // for uint64_t
+#include <cstring>              // for memcpy
+#include <type_traits>          // for is_trivially_copyable
+#include <vector>               // for vector
+
+// Fixed-capacity history of the most recent Capacity values of T, written by
+// one thread (the sampler) and read by any number of others without locks.
+//
+// Values are stored as relaxed atomic words, and a second counter is bumped
+// before a slot is overwritten, so a reader can tell which of the values it
+// copied may have been overwritten underneath it and drop them (the same
+// idea as a seqlock, applied to the whole ring).
+template <typename T, size_t Capacity>
+class RingBuffer
+{
+    static_assert(std::is_trivially_copyable<T>::value, "RingBuffer values are copied as raw words");
+    static_assert(Capacity > 0, "RingBuffer needs at least one slot");
+
+public:
+    RingBuffer() : claimed(0), committed(0)
+    {
+        for (auto &slot : slots)
+        {
+            for (auto &word : slot.words)
+            {
+                word.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+    // Writer only: append a value, overwriting the oldest once full.
+    void push(const T &value)
+    {
+        uint64_t index = committed.load(std::memory_order_relaxed);
+        claimed.store(index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        uint64_t words[WORDS] = {};
+        std::memcpy(words, &value, sizeof(T));
+        Slot &slot = slots[index % Capacity];
+        for (size_t i = 0; i < WORDS; ++i)
+        {
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        committed.store(index + 1, std::memory_order_release);
+    }
+
+    // Total number of values ever pushed.
+    uint64_t getCount() const { return committed.load(std::memory_order_acquire); }
+
+    // Copy up to max of the most recent values, oldest first, into out
+    // (replacing its contents). Returns the number copied.
+    size_t read(std::vector<T> &out, size_t max = Capacity) const
+    {
+        uint64_t end = committed.load(std::memory_order_acquire);
+        size_t count = (size_t)std::min<uint64_t>({end, (uint64_t)Capacity, (uint64_t)max});
+        uint64_t begin = end - count;
+
+        out.resize(count);
+        for (uint64_t index = begin; index < end; ++index)
+        {
+            uint64_t words[WORDS];
+            const Slot &slot = slots[index % Capacity];
+            for (size_t i = 0; i < WORDS; ++i)
+            {
+                words[i] = slot.words[i].load(std::memory_order_relaxed);
+            }
+            std::memcpy(&out[index - begin], words, sizeof(T));
+        }
+
+        // Anything the writer started overwriting while we copied may be
+        // torn; drop those from the front.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t overwritten = claimed.load(std::memory_order_relaxed);
+        if (overwritten > Capacity && overwritten - Capacity > begin)
+        {
+            size_t torn = (size_t)std::min<uint64_t>(overwritten - Capacity - begin, count);
+            out.erase(out.begin(), out.begin() + torn);
+        }
+        return out.size();
+    }
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    struct Slot
+    {
+        std::atomic<uint64_t> words[WORDS];
+    };
+
+    // claimed: index + 1 of the slot currently (or last) being written.
+    // committed: number of values completely written.
+    std::atomic<uint64_t> claimed;
+    std::atomic<uint64_t> committed;
+    std::array<Slot, Capacity> slots;
+};
@@ -0,0 +1,200 @@
+#include "sampler.h"
+#include "helpers.h"
+
+#include <algorithm>            // for max, min
+#include <cerrno>               // for errno, EINTR
+#include <cstring>              // for strerror
+#include <poll.h>               // for poll, pollfd, POLLIN
+#include <stdexcept>            // for runtime_error
+#include <sys/eventfd.h>        // for eventfd, EFD_CLOEXEC, EFD_NONBLOCK
+#include <sys/timerfd.h>        // for timerfd_create, timerfd_settime
+#include <unistd.h>             // for read, write, close
+
+namespace
+{
+// The sampler thread works through the batch too, so one device needs no
+// extra workers and N devices need N - 1.
+size_t samplerThreadCount(size_t deviceCount)
+{
+    size_t hardware = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    return std::min(deviceCount > 0 ? deviceCount - 1 : 0, hardware);
+}
+} // namespace
+
+Sampler::Sampler(std::vector<Device *> devices, const SamplingSchedule &schedule)
+    : devices(std::move(devices)), schedule(schedule), timerFd(-1), wakeFd(-1), running(false),
+      requested(0), scheduleChanged(false), sequence(0), nodeLatency(0),
+      pool(samplerThreadCount(this->devices.size()))
+{
+    wheel.add(schedule);
+
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (timerFd < 0 || wakeFd < 0)
+    {
+        int error = errno;
+        if (timerFd >= 0)
+            close(timerFd);
+        if (wakeFd >= 0)
+            close(wakeFd);
+        throw std::runtime_error(std::string("Failed to create sampler timer: ") + strerror(error));
+    }
+}
+
+Sampler::~Sampler()
+{
+    stop();
+    close(timerFd);
+    close(wakeFd);
+}
+
+void Sampler::start(std::function<void()> onSample)
+{
+    this->onSample = std::move(onSample);
+    sampleAll(COMPONENT_ALL);
+    if (!startTimer())
+    {
+        throw std::runtime_error(std::string("Failed to start sampler timer: ") + strerror(errno));
+    }
+
+    running = true;
+    thread = std::thread(&Sampler::run, this);
+}
+
+bool Sampler::startTimer()
+{
+    // The kernel re-arms a periodic timerfd from the previous expiration, not
+    // from when we get around to reading it, so ticks never drift.
+    auto resolution = schedule.getResolution();
+    struct itimerspec spec = {};
+    spec.it_interval.tv_sec = resolution.count() / 1000;
+    spec.it_interval.tv_nsec = (resolution.count() % 1000) * 1000000;
+    spec.it_value = spec.it_interval;
+    return timerfd_settime(timerFd, 0, &spec, nullptr) == 0;
+}
+
+void Sampler::stop()
+{
+    if (!running.exchange(false))
+    {
+        return;
+    }
+    wake();
+    thread.join();
+
+    struct itimerspec spec = {};
+    timerfd_settime(timerFd, 0, &spec, nullptr);
+}
+
+void Sampler::requestSample(component_flags_t components)
+{
+    requested.fetch_or(components & COMPONENT_ALL, std::memory_order_relaxed);
+    wake();
+}
+
+void Sampler::setSchedule(const SamplingSchedule &schedule)
+{
+    {
+        std::lock_guard<std::mutex> lock(scheduleMutex);
+        pendingSchedule = schedule;
+    }
+    scheduleChanged = true;
+    wake();
+}
+
+void Sampler::wake()
+{
+    uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) != sizeof(one))
+    {
+        // The counter can only fail to increment if it would overflow, in
+        // which case a wakeup is already pending.
+    }
+}
+
+void Sampler::sampleAll(component_flags_t components)
+{
+    auto start = std::chrono::steady_clock::now();
+    uint64_t tick = ++sequence;
+
+    TaskGroup group(pool);
+    for (Device *device : devices)
+    {
+        group.run([this, device, tick, components]() { device->sample(tick, components, &pool); });
+    }
+    group.wait();
+
+    nodeLatency.store((std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+}
+
+void Sampler::run()
+{
+    struct pollfd fds[2];
+    fds[0].fd = timerFd;
+    fds[0].events = POLLIN;
+    fds[1].fd = wakeFd;
+    fds[1].events = POLLIN;
+
+    while (running)
+    {
+        if (poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            std::cerr << "Sampler poll failed: " << strerror(errno) << std::endl;
+            break;
+        }
+        if (!running)
+        {
+            break;
+        }
+
+        component_flags_t due = 0;
+        uint64_t count;
+        if ((fds[0].revents & POLLIN) && read(timerFd, &count, sizeof(count)) == sizeof(count))
+        {
+            // count > 1 means a slow tick overran. Every missed tick still
+            // advances the wheel so each class stays on its own phase, but
+            // whatever came due is sampled only once.
+            for (uint64_t i = 0; i < count; ++i)
+            {
+                due |= wheel.advance();
+            }
+        }
+        if ((fds[1].revents & POLLIN) && read(wakeFd, &count, sizeof(count)) == sizeof(count))
+        {
+            component_flags_t extra = requested.exchange(0, std::memory_order_relaxed);
+            if (extra != 0)
+            {
+                due |= extra | SCHEDULE_DISPLAY;
+            }
+        }
+        if (scheduleChanged.exchange(false))
+        {
+            // Every class starts its new period from now.
+            {
+                std::lock_guard<std::mutex> lock(scheduleMutex);
+                schedule = pendingSchedule;
+            }
+            wheel = TimerWheel();
+            wheel.add(schedule);
+            if (!startTimer())
+            {
+                std::cerr << "Failed to restart sampler timer: " << strerror(errno) << std::endl;
+            }
+        }
+
+        if (due & COMPONENT_ALL)
+        {
+            sampleAll(due & COMPONENT_ALL);
+        }
+        // Consumers only hear about samples at the display rate; faster
+        // engine samples land in each Engine's history in between.
+        if ((due & SCHEDULE_DISPLAY) && onSample)
+        {
+            onSample();
+        }
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "device.h"
+#include "schedule.h"
+#include "thread_pool.h"
+
+#include <atomic>               // for atomic
+#include <chrono>               // for milliseconds, steady_clock
+#include <functional>           // for function
+#include <mutex>                // for mutex
+#include <thread>               // for thread
+#include <vector>               // for vector
+
+// Owns the sampling schedule for a set of devices. All sysman polling happens
+// on the sampler thread; consumers only ever read the most recently published
+// DeviceSnapshot (see Device::getSnapshot()), so a slow driver call can never
+// stall the UI.
+//
+// Devices are sampled in parallel on a small work-stealing pool, so the time
+// to produce a full-node sample tracks the slowest device rather than the sum
+// of all of them.
+//
+// Each component class runs on its own period from a SamplingSchedule. The
+// thread sleeps on a periodic CLOCK_MONOTONIC timerfd ticking at the
+// schedule's resolution, and a TimerWheel decides which classes are due on
+// each tick; classes that aren't due are carried over in the snapshot.
+class Sampler
+{
+public:
+    Sampler(std::vector<Device *> devices, const SamplingSchedule &schedule);
+    ~Sampler();
+
+    // Take one full sample synchronously (so a snapshot is always available)
+    // and then start the background thread. onSample is invoked from the
+    // sampler thread at the schedule's display rate.
+    void start(std::function<void()> onSample = nullptr);
+    void stop();
+    // Take an extra sample of components as soon as possible, e.g. because
+    // a view just required components that aren't in the current snapshot
+    // yet, or a sysman event says their values changed. Consumers are told
+    // about the sample as if the display period had come round. Safe to call
+    // from any thread; the regular schedule is unaffected.
+    void requestSample(component_flags_t components = COMPONENT_ALL);
+    // Switch to another schedule, e.g. to poll the classes sysman events
+    // were covering at their usual periods again once events stop arriving.
+    // Safe to call from any thread; takes effect from the next wakeup.
+    void setSchedule(const SamplingSchedule &schedule);
+
+    size_t getDeviceCount() const { return devices.size(); }
+    Device *getDevice(size_t index) const { return devices[index]; }
+    // Wall time of the most recent tick across all devices.
+    std::chrono::nanoseconds getNodeLatency() const { return std::chrono::nanoseconds(nodeLatency.load(std::memory_order_relaxed)); }
+
+private:
+    std::vector<Device *> devices;
+    SamplingSchedule schedule;
+    TimerWheel wheel;
+    std::function<void()> onSample;
+
+    // timerfd for the tick and eventfd used to wake the thread early.
+    int timerFd;
+    int wakeFd;
+    std::atomic<bool> running;
+    // Components asked for by requestSample() since the last wakeup.
+    std::atomic<component_flags_t> requested;
+    // Schedule given to setSchedule(), for the sampler thread to pick up.
+    std::mutex scheduleMutex;
+    SamplingSchedule pendingSchedule;
+    std::atomic<bool> scheduleChanged;
+    std::thread thread;
+    uint64_t sequence;
+    std::atomic<int64_t> nodeLatency;
+    ThreadPool pool;
+
+    void sampleAll(component_flags_t components);
+    // Arm the timerfd at the schedule's resolution.
+    bool startTimer();
+    void wake();
+    void run();
+};
@@ -0,0 +1,255 @@
+#include "schedule.h"
+
+#include <algorithm>            // for max, min
+#include <cmath>                // for llround
+#include <cstring>              // for strcmp
+#include <numeric>              // for gcd
+#include <regex>                // for regex, regex_match, smatch
+
+namespace
+{
+const char *componentNames[SCHEDULE_CLASS_COUNT] = {"engines", "power", "psu", "memory", "thermal", "processes", "frequency", "pci", "ras", "display"};
+
+// A few obvious alternate spellings, and the class each stands for.
+const char *componentAliases[][2] = {
+    {"engine", "engines"},    {"psus", "psu"},         {"mem", "memory"}, {"temperature", "thermal"},
+    {"process", "processes"}, {"freq", "frequency"}, {"pcie", "pci"},
+};
+
+int componentIndex(const std::string &name)
+{
+    const char *canonical = name.c_str();
+    for (const auto &alias : componentAliases)
+    {
+        if (name == alias[0])
+        {
+            canonical = alias[1];
+            break;
+        }
+    }
+    for (uint32_t i = 0; i < SCHEDULE_CLASS_COUNT; ++i)
+    {
+        if (std::strcmp(canonical, componentNames[i]) == 0)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+std::string durationToString(std::chrono::milliseconds period)
+{
+    if (period.count() % 1000 == 0)
+    {
+        return std::to_string(period.count() / 1000) + "s";
+    }
+    return std::to_string(period.count()) + "ms";
+}
+} // namespace
+
+bool SamplingSchedule::parseDuration(const std::string &text, std::chrono::milliseconds &period)
+{
+    std::regex duration_regex("^([0-9]+(\\.[0-9]+)?)(ms|s|m|h)?$");
+    std::smatch matches;
+    if (!std::regex_match(text, matches, duration_regex))
+    {
+        return false;
+    }
+
+    double value = std::stod(matches[1]);
+    if (matches[3] == "s")
+    {
+        value *= 1000.0;
+    }
+    else if (matches[3] == "m")
+    {
+        value *= 60 * 1000.0;
+    }
+    else if (matches[3] == "h")
+    {
+        value *= 60 * 60 * 1000.0;
+    }
+    long long ms = std::llround(value);
+    if (ms < 1)
+    {
+        return false;
+    }
+    period = std::chrono::milliseconds(ms);
+    return true;
+}
+
+SamplingSchedule::SamplingSchedule(std::chrono::milliseconds period) : configured(0)
+{
+    periods.fill(period);
+}
+
+bool SamplingSchedule::parse(const std::string &spec, std::string &error)
+{
+    auto parsed = periods;
+    component_flags_t parsedConfigured = configured;
+    size_t start = 0;
+    do
+    {
+        size_t end = spec.find(',', start);
+        std::string entry = spec.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        start = end == std::string::npos ? end : end + 1;
+
+        std::chrono::milliseconds period;
+        size_t equals = entry.find('=');
+        if (equals == std::string::npos)
+        {
+            if (!parseDuration(entry, period))
+            {
+                error = "invalid interval '" + entry + "'";
+                return false;
+            }
+            parsed.fill(period);
+            parsedConfigured = (1 << SCHEDULE_CLASS_COUNT) - 1;
+            continue;
+        }
+
+        std::string name = entry.substr(0, equals);
+        int index = componentIndex(name);
+        if (index < 0)
+        {
+            error = "unknown metric '" + name + "'";
+            return false;
+        }
+        if (!parseDuration(entry.substr(equals + 1), period))
+        {
+            error = "invalid interval '" + entry.substr(equals + 1) + "' for " + name;
+            return false;
+        }
+        parsed[index] = period;
+        parsedConfigured |= 1 << index;
+    } while (start != std::string::npos);
+
+    periods = parsed;
+    configured = parsedConfigured;
+    return true;
+}
+
+void SamplingSchedule::setPeriod(component_flags_t components, std::chrono::milliseconds period)
+{
+    for (uint32_t i = 0; i < SCHEDULE_CLASS_COUNT; ++i)
+    {
+        if (components & (1 << i))
+        {
+            periods[i] = period;
+        }
+    }
+    configured |= components;
+}
+
+void SamplingSchedule::relax(component_flags_t components, std::chrono::milliseconds period)
+{
+    for (uint32_t i = 0; i < SCHEDULE_CLASS_COUNT; ++i)
+    {
+        if ((components & (1 << i)) && !(configured & (1 << i)))
+        {
+            periods[i] = std::max(periods[i], period);
+        }
+    }
+}
+
+std::chrono::milliseconds SamplingSchedule::getPeriod(component_flags_t component) const
+{
+    for (uint32_t i = 0; i < SCHEDULE_CLASS_COUNT; ++i)
+    {
+        if (component & (1 << i))
+        {
+            return periods[i];
+        }
+    }
+    return periods[0];
+}
+
+std::chrono::milliseconds SamplingSchedule::getResolution() const
+{
+    const std::chrono::milliseconds::rep floor = 10;
+    std::chrono::milliseconds::rep divisor = 0;
+    std::chrono::milliseconds::rep shortest = periods[0].count();
+    for (const auto &period : periods)
+    {
+        divisor = std::gcd(divisor, period.count());
+        shortest = std::min(shortest, period.count());
+    }
+    return std::chrono::milliseconds(std::max(divisor, std::min(shortest, floor)));
+}
+
+std::string SamplingSchedule::toString() const
+{
+    std::string text;
+    for (uint32_t i = 0; i < SCHEDULE_CLASS_COUNT; ++i)
+    {
+        if (i > 0)
+        {
+            text += ",";
+        }
+        text += componentNames[i];
+        text += "=" + durationToString(periods[i]);
+    }
+    return text;
+}
+
+TimerWheel::TimerWheel(size_t slots) : slots(std::max<size_t>(slots, 1)), tick(0)
+{
+}
+
+void TimerWheel::add(component_flags_t components, uint64_t periodTicks)
+{
+    Timer timer;
+    timer.components = components;
+    timer.period = std::max<uint64_t>(periodTicks, 1);
+    insert(timer);
+}
+
+void TimerWheel::add(const SamplingSchedule &schedule)
+{
+    auto resolution = schedule.getResolution().count();
+    for (uint32_t i = 0; i < SCHEDULE_CLASS_COUNT; ++i)
+    {
+        auto period = schedule.getPeriod(1 << i).count();
+        // Round to the nearest whole tick.
+        add(1 << i, (period + resolution / 2) / resolution);
+    }
+}
+
+void TimerWheel::insert(const Timer &timer)
+{
+    // A timer due in d ticks lands in slot (tick + d) % N and is passed over
+    // (d - 1) / N times before the visit on which it fires.
+    Timer scheduled = timer;
+    scheduled.rounds = (timer.period - 1) / slots.size();
+    slots[(tick + timer.period) % slots.size()].push_back(scheduled);
+}
+
+component_flags_t TimerWheel::advance()
+{
+    ++tick;
+    auto &slot = slots[tick % slots.size()];
+    component_flags_t due = 0;
+
+    fired.clear();
+    for (size_t i = 0; i < slot.size();)
+    {
+        if (slot[i].rounds > 0)
+        {
+            --slot[i].rounds;
+            ++i;
+            continue;
+        }
+        due |= slot[i].components;
+        fired.push_back(slot[i]);
+        slot[i] = slot.back();
+        slot.pop_back();
+    }
+
+    // Re-armed only after the scan; a period that is a multiple of the
+    // wheel size lands back in this same slot.
+    for (const Timer &timer : fired)
+    {
+        insert(timer);
+    }
+    return due;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "components.h"
+
+#include <array>                // for array
+#include <chrono>               // for milliseconds
+#include <cstdint>              // for uint64_t
+#include <string>               // for string
+#include <vector>               // for vector
+
+// Besides the component classes, the schedule has a display period: how often
+// consumers are told a new sample is ready (and so how often the TUI redraws),
+// and the window that fast engine samples are averaged over for display.
+constexpr component_flags_t SCHEDULE_DISPLAY = 1 << COMPONENT_COUNT;
+constexpr uint32_t SCHEDULE_CLASS_COUNT = COMPONENT_COUNT + 1;
+
+// Sampling period for each component class. Engine activity is bursty and
+// worth polling often, while temperatures, memory and PSU state change slowly
+// and some of those queries are expensive, so each class gets its own period.
+class SamplingSchedule
+{
+public:
+    explicit SamplingSchedule(std::chrono::milliseconds period = std::chrono::milliseconds(1000));
+
+    // Parse an --interval specification: a comma separated list where each
+    // entry is either "name=duration" or a bare duration that applies to
+    // every class. Durations are "<n>ms", "<n>s", "<n>m" or "<n>h"
+    // (fractions allowed) or a plain number of milliseconds. Names are
+    // engines, power, psu, memory, thermal, processes, frequency, pci, ras
+    // and display. On failure, error describes the bad entry and the
+    // schedule is left unchanged.
+    bool parse(const std::string &spec, std::string &error);
+
+    // Parse a single duration in the same format.
+    static bool parseDuration(const std::string &text, std::chrono::milliseconds &period);
+
+    void setPeriod(component_flags_t components, std::chrono::milliseconds period);
+    std::chrono::milliseconds getPeriod(component_flags_t component) const;
+    // Lengthen the period of each of components to at least period, except
+    // for classes given a period through parse() or setPeriod(). Used when
+    // another source (such as sysman events) already reports the changes
+    // that matter, so those classes needn't be polled as often.
+    void relax(component_flags_t components, std::chrono::milliseconds period);
+
+    // Tick length for a TimerWheel driving this schedule: the largest step
+    // that divides every period, but never finer than 10ms unless a period
+    // is itself shorter (other periods are then rounded to whole ticks).
+    std::chrono::milliseconds getResolution() const;
+
+    // Human readable form, e.g. "engines=50ms,power=1s,...".
+    std::string toString() const;
+
+private:
+    std::array<std::chrono::milliseconds, SCHEDULE_CLASS_COUNT> periods;
+    // Classes whose period was set explicitly.
+    component_flags_t configured;
+};
+
+// Hashed timer wheel of periodic timers, each identified by the component
+// mask it fires. Advancing one tick only visits the timers in a single slot,
+// so the cost per tick does not grow with the number or length of periods.
+class TimerWheel
+{
+public:
+    explicit TimerWheel(size_t slots = 256);
+
+    // Add a timer that first fires periodTicks ticks from now and then every
+    // periodTicks ticks after that.
+    void add(component_flags_t components, uint64_t periodTicks);
+    // Build one timer per class (including SCHEDULE_DISPLAY) from a schedule.
+    void add(const SamplingSchedule &schedule);
+
+    // Move forward one tick and return the components of every timer that
+    // fired on it.
+    component_flags_t advance();
+    uint64_t getTick() const { return tick; }
+
+private:
+    struct Timer
+    {
+        component_flags_t components;
+        uint64_t period;
+        // Full trips around the wheel left before the timer is due.
+        uint64_t rounds;
+    };
+
+    std::vector<std::vector<Timer>> slots;
+    std::vector<Timer> fired;
+    uint64_t tick;
+
+    void insert(const Timer &timer);
+};
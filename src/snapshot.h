@@ -0,0 +1,147 @@
+#pragma once
+
+#include "components.h"         // for component_flags_t
+#include "fdinfo.h"             // for DrmUsage
+#include "snapshot_buffer.h"    // for CACHE_LINE_SIZE
+#include "statistics.h"         // for StatisticsSummary
+
+#include <level_zero/ze_api.h>  // for _ze_result_t, ze_result_t, ZE_MAX_DE...
+#include <level_zero/zes_api.h> // for zes_device_handle_t, _zes_structure_...
+#include <chrono>               // for steady_clock
+#include <cstdint>              // for uint32_t, uint64_t
+#include <string>               // for string
+#include <vector>               // for vector
+
+// Per-process values captured at sample time. The command line is copied so
+// that rendering never has to touch /proc.
+struct ProcessSample
+{
+    uint32_t pid;
+    std::string name;
+    std::string command_line;
+    uint64_t used_memory;
+    uint64_t shared_memory;
+    zes_engine_type_flags_t engines;
+    DrmUsage drm;
+    // Joules of device energy charged to the process this session (see
+    // EnergyAttribution), or -1 without power domains.
+    double energy;
+};
+
+// Per-module memory values captured at sample time. Bandwidths are bytes per
+// second and are zero when the module has no bandwidth counters.
+struct MemorySample
+{
+    zes_mem_state_t state;
+    double readBandwidth;
+    double writeBandwidth;
+    double maxBandwidth;
+};
+
+// Per-domain frequency values captured at sample time. throttleFraction is
+// the share of the last interval spent throttled (see
+// FrequencyDomain::getThrottleFraction()).
+struct FrequencySample
+{
+    zes_freq_state_t state;
+    double throttleFraction;
+};
+
+// PCIe link values captured at sample time (see PciLink). Bandwidths are
+// bytes per second and rates are per second.
+struct PciSample
+{
+    zes_pci_state_t state = {};
+    zes_pci_speed_t speed = {-1, -1, -1};
+    bool degraded = false;
+    double rxBandwidth = 0;
+    double txBandwidth = 0;
+    double packetRate = 0;
+    double replayRate = 0;
+};
+
+// Per power domain values captured at sample time (see PowerDomain). power
+// is watts over the domain's window; sessionEnergy is joules since the
+// domain was initialized.
+struct PowerSample
+{
+    double power = 0;
+    double sessionEnergy = 0;
+};
+
+// Per temperature sensor values captured at sample time (see
+// TemperatureMonitor). valid is false if the last read failed, in which case
+// the temperature is the previous reading. slope is °C per second;
+// timeToThrottle is in seconds, negative if the sensor isn't heading there.
+struct TemperatureSample
+{
+    bool valid = false;
+    double slope = 0;
+    double timeToThrottle = -1;
+};
+
+// Per fan values captured at sample time (see Fan). speed is in units, or
+// -1 if unknown; percent is of the maximum, or -1 if unknown.
+struct FanSample
+{
+    int32_t speed = -1;
+    zes_fan_speed_units_t units = ZES_FAN_SPEED_UNITS_RPM;
+    double percent = -1;
+};
+
+// Per RAS error set values captured at sample time (see RasErrorSet). rate
+// is errors per hour over the set's trailing window.
+struct RasSample
+{
+    zes_ras_error_type_t type;
+    zes_ras_state_t state;
+    uint64_t total;
+    uint64_t delta;
+    double rate;
+    bool rising;
+};
+
+// A complete, immutable set of values for one device as of a single sampler
+// tick. Vectors are indexed the same way as the corresponding Device
+// accessors (getEngine(i), getPowerDomain(i), getPSU(i), getTemperature(i),
+// getFrequencyDomain(i)).
+//
+// Devices are sampled concurrently by different workers, so each snapshot
+// starts on its own cache line to keep those writes from false sharing.
+struct alignas(CACHE_LINE_SIZE) DeviceSnapshot
+{
+    std::chrono::steady_clock::time_point timestamp;
+    uint64_t sequence = 0;
+    // Wall time taken to query every component of this device for this tick.
+    std::chrono::nanoseconds sampleLatency{0};
+    // Components that had been initialized at sample time. Vectors for
+    // anything else are empty.
+    component_flags_t components = 0;
+    // Components whose values were refreshed by this tick. The rest were
+    // carried over unchanged from the previous snapshot because their
+    // schedule wasn't due (see SamplingSchedule).
+    component_flags_t sampled = 0;
+
+    std::vector<double> engineUtilization;
+    std::vector<PowerSample> powerDomains;
+    std::vector<zes_psu_state_t> psuStates;
+    std::vector<double> temperatures;
+    // Per sensor, alongside temperatures.
+    std::vector<TemperatureSample> temperatureSensors;
+    std::vector<FanSample> fans;
+    // Per engine, power domain and sensor: one summary per configured
+    // statistics window (see Device::setHistory()). Empty without history.
+    std::vector<std::vector<StatisticsSummary>> engineStatistics;
+    std::vector<std::vector<StatisticsSummary>> powerDomainStatistics;
+    std::vector<std::vector<StatisticsSummary>> temperatureStatistics;
+    // Sum over memoryModules.
+    zes_mem_state_t memory = {};
+    std::vector<MemorySample> memoryModules;
+    std::vector<FrequencySample> frequencyDomains;
+    PciSample pci;
+    std::vector<RasSample> rasErrorSets;
+    std::vector<ProcessSample> processes;
+    // Device energy not charged to any process (see EnergyAttribution), in
+    // joules, or -1 without power domains.
+    double idleEnergy = -1;
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>                // for array
+#include <atomic>               // for atomic, memory_order
+#include <cstddef>              // for size_t
+#include <cstdint>              // for uint32_t
+#include <thread>               // for this_thread::yield
+
+// Size used to pad data touched by different threads so they don't share a
+// cache line. std::hardware_destructive_interference_size is not used since
+// GCC warns that its value is not ABI stable.
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+// Single-writer, multi-reader buffer for publishing complete values of T.
+//
+// The writer fills a slot that no reader can be looking at and then publishes
+// it with a single atomic store, so readers always see a fully written T and
+// never block. A reader "pins" the current slot for as long as it holds a
+// Reader; the writer skips pinned slots when choosing where to write next.
+//
+// With Slots = 3 this is a classic triple buffer; extra slots only matter
+// when several readers hold pins on different old values at the same time.
+template <typename T, size_t Slots = 4>
+class SnapshotBuffer
+{
+    static_assert(Slots >= 3, "SnapshotBuffer needs at least three slots");
+
+public:
+    class Reader
+    {
+    public:
+        Reader(Reader &&other) : buffer(other.buffer), slot(other.slot) { other.buffer = nullptr; }
+        Reader(const Reader &) = delete;
+        Reader &operator=(const Reader &) = delete;
+        Reader &operator=(Reader &&) = delete;
+        ~Reader()
+        {
+            if (buffer)
+            {
+                buffer->pins[slot].count.fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+        const T &operator*() const { return buffer->slots[slot]; }
+        const T *operator->() const { return &buffer->slots[slot]; }
+
+    private:
+        friend class SnapshotBuffer;
+        Reader(const SnapshotBuffer *buffer, uint32_t slot) : buffer(buffer), slot(slot) {}
+
+        const SnapshotBuffer *buffer;
+        uint32_t slot;
+    };
+
+    SnapshotBuffer() : current(0), writeSlot(1)
+    {
+        for (auto &pin : pins)
+        {
+            pin.count.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Pin and return the most recently published value. Lock-free: a reader
+    // only retries if a publish() lands between its two loads of current.
+    Reader read() const
+    {
+        for (;;)
+        {
+            uint32_t slot = current.load(std::memory_order_seq_cst);
+            pins[slot].count.fetch_add(1, std::memory_order_seq_cst);
+            if (current.load(std::memory_order_seq_cst) == slot)
+            {
+                return Reader(this, slot);
+            }
+            pins[slot].count.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    // Writer only: return a slot that is neither published nor pinned. The
+    // contents are whatever was last written there, so callers must
+    // overwrite every field (or copy from peekPublished() first).
+    T &beginWrite()
+    {
+        uint32_t published = current.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            for (uint32_t i = 0; i < Slots; ++i)
+            {
+                if (i != published && pins[i].count.load(std::memory_order_seq_cst) == 0)
+                {
+                    writeSlot = i;
+                    return slots[i];
+                }
+            }
+            // Every spare slot is pinned by a slow reader; wait for one.
+            std::this_thread::yield();
+        }
+    }
+
+    // Writer only: make the slot returned by beginWrite() visible to readers.
+    void publish()
+    {
+        current.store(writeSlot, std::memory_order_seq_cst);
+    }
+
+    // Writer only: the published value. Safe because only the writer ever
+    // modifies slots.
+    const T &peekPublished() const { return slots[current.load(std::memory_order_relaxed)]; }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Pin
+    {
+        std::atomic<uint32_t> count;
+    };
+
+    std::atomic<uint32_t> current;
+    mutable std::array<Pin, Slots> pins;
+    std::array<T, Slots> slots;
+    uint32_t writeSlot;
+};
@@ -0,0 +1,247 @@
+#include "statistics.h"
+
+#include <algorithm>            // for max, min
+#include <cmath>                // for log, ceil, exp, sqrt, pow
+#include <limits>               // for numeric_limits
+
+QuantileSketch::QuantileSketch(double minValue, double maxValue, double accuracy)
+    : minValue(minValue), gamma((1.0 + accuracy) / (1.0 - accuracy)), logGamma(std::log(gamma)), count(0)
+{
+    // Bucket 0 holds "zero"; bucket i > 0 covers
+    // (minValue * gamma^(i-1), minValue * gamma^i].
+    buckets.resize(2 + (size_t)std::ceil(std::log(maxValue / minValue) / logGamma), 0);
+}
+
+size_t QuantileSketch::bucket(double value) const
+{
+    if (!(value > minValue))
+    {
+        return 0;
+    }
+    size_t index = (size_t)std::ceil(std::log(value / minValue) / logGamma);
+    return std::min(std::max<size_t>(index, 1), buckets.size() - 1);
+}
+
+double QuantileSketch::bucketValue(size_t index) const
+{
+    if (index == 0)
+    {
+        return 0.0;
+    }
+    // The point in the bucket with equal relative error to either edge.
+    return minValue * 2.0 * std::pow(gamma, (double)index) / (gamma + 1.0);
+}
+
+void QuantileSketch::add(double value)
+{
+    buckets[bucket(value)]++;
+    count++;
+}
+
+void QuantileSketch::remove(double value)
+{
+    uint32_t &slot = buckets[bucket(value)];
+    if (slot > 0)
+    {
+        slot--;
+        count--;
+    }
+}
+
+double QuantileSketch::quantile(double q) const
+{
+    if (count == 0)
+    {
+        return 0.0;
+    }
+    uint64_t rank = (uint64_t)(std::min(std::max(q, 0.0), 1.0) * (double)(count - 1));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i)
+    {
+        seen += buckets[i];
+        if (seen > rank)
+        {
+            return bucketValue(i);
+        }
+    }
+    return bucketValue(buckets.size() - 1);
+}
+
+SlidingWindow::SlidingWindow(size_t capacity)
+    : capacity(capacity), added(0), mean(0), m2(0), min(std::numeric_limits<double>::max()),
+      max(std::numeric_limits<double>::lowest()), values(capacity), sum(0), sumSquares(0), minQueue(capacity),
+      maxQueue(capacity), minHead(0), minTail(0), maxHead(0), maxTail(0)
+{
+}
+
+void SlidingWindow::add(double value)
+{
+    uint64_t index = added++;
+    sketch.add(value);
+
+    if (capacity == 0)
+    {
+        double delta = value - mean;
+        mean += delta / (double)added;
+        m2 += delta * (value - mean);
+        min = std::min(min, value);
+        max = std::max(max, value);
+        return;
+    }
+
+    if (index >= capacity)
+    {
+        double expired = valueAt(index);
+        sketch.remove(expired);
+        sum -= expired;
+        sumSquares -= expired * expired;
+        // The queues only ever hold indices still in the window.
+        if (minHead < minTail && minQueue[minHead % capacity] + capacity <= index)
+            minHead++;
+        if (maxHead < maxTail && maxQueue[maxHead % capacity] + capacity <= index)
+            maxHead++;
+    }
+
+    values[index % capacity] = value;
+    sum += value;
+    sumSquares += value * value;
+    if (index % capacity == capacity - 1)
+    {
+        sum = 0;
+        sumSquares = 0;
+        for (double v : values)
+        {
+            sum += v;
+            sumSquares += v * v;
+        }
+    }
+
+    while (minHead < minTail && valueAt(minQueue[(minTail - 1) % capacity]) >= value)
+        minTail--;
+    minQueue[minTail++ % capacity] = index;
+    while (maxHead < maxTail && valueAt(maxQueue[(maxTail - 1) % capacity]) <= value)
+        maxTail--;
+    maxQueue[maxTail++ % capacity] = index;
+}
+
+StatisticsSummary SlidingWindow::summarize() const
+{
+    StatisticsSummary summary;
+    if (added == 0)
+    {
+        return summary;
+    }
+
+    if (capacity == 0)
+    {
+        summary.count = added;
+        summary.min = (float)min;
+        summary.max = (float)max;
+        summary.mean = (float)mean;
+        summary.stddev = (float)std::sqrt(m2 / (double)added);
+    }
+    else
+    {
+        uint64_t n = std::min<uint64_t>(added, capacity);
+        double average = sum / (double)n;
+        summary.count = n;
+        summary.min = (float)valueAt(minQueue[minHead % capacity]);
+        summary.max = (float)valueAt(maxQueue[maxHead % capacity]);
+        summary.mean = (float)average;
+        summary.stddev = (float)std::sqrt(std::max(sumSquares / (double)n - average * average, 0.0));
+    }
+
+    // The sketch is only accurate to ~1%, so keep its answers within the
+    // exact range.
+    summary.p50 = std::min(std::max((float)sketch.quantile(0.50), summary.min), summary.max);
+    summary.p95 = std::min(std::max((float)sketch.quantile(0.95), summary.min), summary.max);
+    summary.p99 = std::min(std::max((float)sketch.quantile(0.99), summary.min), summary.max);
+    return summary;
+}
+
+MetricStatistics::MetricStatistics(const std::vector<std::chrono::milliseconds> &windows,
+                                   std::chrono::milliseconds period)
+{
+    for (const auto &window : windows)
+    {
+        this->windows.emplace_back(window.count() == 0 ? 0 : std::max<size_t>(window / period, 1));
+    }
+}
+
+void MetricStatistics::add(double value)
+{
+    for (auto &window : windows)
+    {
+        window.add(value);
+    }
+}
+
+void MetricStatistics::summarize(std::vector<StatisticsSummary> &summaries) const
+{
+    summaries.resize(windows.size());
+    for (size_t i = 0; i < windows.size(); ++i)
+    {
+        summaries[i] = windows[i].summarize();
+    }
+}
+
+LinearTrend::LinearTrend(size_t capacity) : times(std::max<size_t>(capacity, 2)), values(times.size()), added(0)
+{
+}
+
+void LinearTrend::add(double seconds, double value)
+{
+    size_t index = added++ % times.size();
+    times[index] = seconds;
+    values[index] = value;
+}
+
+double LinearTrend::getSlope() const
+{
+    size_t n = getCount();
+    if (n < 2)
+    {
+        return 0.0;
+    }
+
+    // Centre on the means first; the times can be large next to their
+    // spread.
+    double meanTime = 0, meanValue = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        meanTime += times[i];
+        meanValue += values[i];
+    }
+    meanTime /= (double)n;
+    meanValue /= (double)n;
+
+    double covariance = 0, variance = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        double dt = times[i] - meanTime;
+        covariance += dt * (values[i] - meanValue);
+        variance += dt * dt;
+    }
+    return variance > 0 ? covariance / variance : 0.0;
+}
+
+std::string statistics_window_label(std::chrono::milliseconds window)
+{
+    if (window.count() == 0)
+    {
+        return "session";
+    }
+    if (window.count() % (60 * 60 * 1000) == 0)
+    {
+        return std::to_string(window.count() / (60 * 60 * 1000)) + "h";
+    }
+    if (window.count() % (60 * 1000) == 0)
+    {
+        return std::to_string(window.count() / (60 * 1000)) + "m";
+    }
+    if (window.count() % 1000 == 0)
+    {
+        return std::to_string(window.count() / 1000) + "s";
+    }
+    return std::to_string(window.count()) + "ms";
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>            // for min
+#include <chrono>               // for milliseconds
+#include <cstdint>              // for uint32_t, uint64_t
+#include <string>               // for string
+#include <vector>               // for vector
+
+// Summary of one metric over one window, as published in snapshots.
+struct StatisticsSummary
+{
+    uint64_t count = 0;
+    float min = 0;
+    float max = 0;
+    float mean = 0;
+    float stddev = 0;
+    float p50 = 0;
+    float p95 = 0;
+    float p99 = 0;
+};
+
+// Log-bucketed histogram giving quantiles to within a fixed relative error
+// (about 1%) over a wide value range in a few KB, independent of how many
+// values it has seen. Unlike most sketches it also supports remove(), which
+// is what lets SlidingWindow keep one for a moving window.
+class QuantileSketch
+{
+public:
+    // Values at or below minValue count as zero; values above maxValue are
+    // clamped into the top bucket.
+    QuantileSketch(double minValue = 0.01, double maxValue = 100000.0, double accuracy = 0.01);
+
+    void add(double value);
+    void remove(double value);
+    uint64_t getCount() const { return count; }
+    // q in [0, 1]. O(number of buckets).
+    double quantile(double q) const;
+
+private:
+    double minValue;
+    double gamma;
+    double logGamma;
+    std::vector<uint32_t> buckets;
+    uint64_t count;
+
+    size_t bucket(double value) const;
+    double bucketValue(size_t index) const;
+};
+
+// Running statistics over the last `capacity` values (a time window, given
+// that values arrive at a fixed period), or over every value when capacity
+// is zero. add() is O(1) (amortized, for min/max) and memory is fixed once
+// constructed.
+class SlidingWindow
+{
+public:
+    explicit SlidingWindow(size_t capacity);
+
+    void add(double value);
+    StatisticsSummary summarize() const;
+
+private:
+    size_t capacity;
+    uint64_t added;
+    QuantileSketch sketch;
+
+    // Session (capacity == 0): Welford's running mean and variance.
+    double mean;
+    double m2;
+    double min;
+    double max;
+
+    // Windowed: the values themselves, plus sums that are recomputed from
+    // them once per lap so floating point drift can't accumulate.
+    std::vector<double> values;
+    double sum;
+    double sumSquares;
+    // Monotonic queues of value indices for the window min and max; each is
+    // a ring over a fixed array.
+    std::vector<uint64_t> minQueue;
+    std::vector<uint64_t> maxQueue;
+    uint64_t minHead, minTail;
+    uint64_t maxHead, maxTail;
+
+    double valueAt(uint64_t index) const { return values[index % capacity]; }
+};
+
+// Statistics for one metric over several windows at once.
+class MetricStatistics
+{
+public:
+    // windows are durations; period is how often the metric is sampled. A
+    // zero duration means the whole session.
+    MetricStatistics(const std::vector<std::chrono::milliseconds> &windows, std::chrono::milliseconds period);
+
+    void add(double value);
+    // Resize summaries to one entry per window and fill them in.
+    void summarize(std::vector<StatisticsSummary> &summaries) const;
+
+private:
+    std::vector<SlidingWindow> windows;
+};
+
+// Least-squares line through the last `capacity` (time, value) points, for
+// telling which way a metric is heading and how fast.
+class LinearTrend
+{
+public:
+    explicit LinearTrend(size_t capacity);
+
+    // seconds is any monotonic time base, e.g. seconds since start.
+    void add(double seconds, double value);
+    size_t getCount() const { return std::min<uint64_t>(added, times.size()); }
+    // Value units per second; 0 until there are two points spread in time.
+    double getSlope() const;
+
+private:
+    std::vector<double> times;
+    std::vector<double> values;
+    uint64_t added;
+};
+
+// Short label for a window duration ("1m", "30s", "session").
+std::string statistics_window_label(std::chrono::milliseconds window);
@@ -0,0 +1,394 @@
+#include "stream_writer.h"
+#include "process_sort.h"       // for process_utilization
+
+#include <unistd.h>             // for write
+#include <algorithm>            // for min
+#include <cerrno>               // for errno, EINTR
+#include <cstring>              // for strerror
+#include <iostream>             // for cerr
+#include <iterator>             // for back_inserter
+#include <string_view>          // for string_view
+
+namespace
+{
+const char CSV_HEADER[] = "time,sequence,bdf,metric,index,type,subdevice,value\n";
+
+void appendJsonString(fmt::memory_buffer &out, const std::string &value)
+{
+    out.push_back('"');
+    for (char c : value)
+    {
+        switch (c)
+        {
+        case '"':
+            out.append(std::string_view("\\\""));
+            break;
+        case '\\':
+            out.append(std::string_view("\\\\"));
+            break;
+        default:
+            if ((unsigned char)c < 0x20)
+            {
+                fmt::format_to(std::back_inserter(out), "\\u{:04x}", (unsigned)c);
+            }
+            else
+            {
+                out.push_back(c);
+            }
+        }
+    }
+    out.push_back('"');
+}
+
+// Fields with a separator, quote or line break are quoted, with quotes
+// doubled.
+void appendCsvField(fmt::memory_buffer &out, const std::string &value)
+{
+    if (value.find_first_of(",\"\r\n") == std::string::npos)
+    {
+        out.append(value);
+        return;
+    }
+    out.push_back('"');
+    for (char c : value)
+    {
+        if (c == '"')
+        {
+            out.push_back('"');
+        }
+        out.push_back(c);
+    }
+    out.push_back('"');
+}
+
+std::string toString(const fmt::memory_buffer &buffer)
+{
+    return std::string(buffer.data(), buffer.size());
+}
+
+// {"index":0,"type":"GPU","subdevice":1
+std::string jsonComponent(size_t index, const ComponentLabels &labels)
+{
+    fmt::memory_buffer out;
+    fmt::format_to(std::back_inserter(out), "{{\"index\":{}", index);
+    if (!labels.type.empty())
+    {
+        out.append(std::string_view(",\"type\":"));
+        appendJsonString(out, labels.type);
+    }
+    if (labels.subdevice >= 0)
+    {
+        fmt::format_to(std::back_inserter(out), ",\"subdevice\":{}", labels.subdevice);
+    }
+    return toString(out);
+}
+
+// ,0000:03:00.0,engine_utilization,0,COMPUTE,1,
+std::string csvComponent(const std::string &bdf, const char *metric, size_t index, const ComponentLabels &labels)
+{
+    fmt::memory_buffer out;
+    fmt::format_to(std::back_inserter(out), ",{},{},{},", bdf, metric, index);
+    appendCsvField(out, labels.type);
+    out.push_back(',');
+    if (labels.subdevice >= 0)
+    {
+        fmt::format_to(std::back_inserter(out), "{}", labels.subdevice);
+    }
+    out.push_back(',');
+    return toString(out);
+}
+} // namespace
+
+bool parse_stream_format(const std::string &name, StreamFormat &format)
+{
+    if (name == "jsonl")
+    {
+        format = StreamFormat::JSONL;
+        return true;
+    }
+    if (name == "csv")
+    {
+        format = StreamFormat::CSV;
+        return true;
+    }
+    return false;
+}
+
+StreamWriter::StreamWriter(int fd, StreamFormat format, std::vector<DeviceLabels> labels) : fd(fd), format(format)
+{
+    for (const DeviceLabels &each : labels)
+    {
+        Rendered rendered;
+        if (format == StreamFormat::JSONL)
+        {
+            fmt::memory_buffer out;
+            out.append(std::string_view(",\"uuid\":"));
+            appendJsonString(out, each.uuid);
+            out.append(std::string_view(",\"bdf\":"));
+            appendJsonString(out, each.bdf);
+            rendered.device = toString(out);
+            for (size_t i = 0; i < each.engines.size(); ++i)
+            {
+                rendered.engines.push_back(jsonComponent(i, each.engines[i]) + ",\"utilization\":");
+            }
+            for (size_t i = 0; i < each.powerDomains.size(); ++i)
+            {
+                rendered.powerDomains.push_back(jsonComponent(i, each.powerDomains[i]) + ",\"watts\":");
+                rendered.energy.push_back(",\"energy\":");
+            }
+            for (size_t i = 0; i < each.temperatures.size(); ++i)
+            {
+                rendered.temperatures.push_back(jsonComponent(i, each.temperatures[i]) + ",\"celsius\":");
+            }
+        }
+        else
+        {
+            fmt::memory_buffer bdf;
+            appendCsvField(bdf, each.bdf);
+            rendered.device = toString(bdf);
+            for (size_t i = 0; i < each.engines.size(); ++i)
+            {
+                rendered.engines.push_back(csvComponent(rendered.device, "engine_utilization", i, each.engines[i]));
+            }
+            for (size_t i = 0; i < each.powerDomains.size(); ++i)
+            {
+                rendered.powerDomains.push_back(csvComponent(rendered.device, "power_watts", i, each.powerDomains[i]));
+                rendered.energy.push_back(csvComponent(rendered.device, "energy_joules", i, each.powerDomains[i]));
+            }
+            for (size_t i = 0; i < each.temperatures.size(); ++i)
+            {
+                rendered.temperatures.push_back(
+                    csvComponent(rendered.device, "temperature_celsius", i, each.temperatures[i]));
+            }
+            rendered.memorySize = "," + rendered.device + ",memory_size,,,,";
+            rendered.memoryFree = "," + rendered.device + ",memory_free,,,,";
+            rendered.processMemory = "," + rendered.device + ",process_memory,";
+            rendered.processUtilization = "," + rendered.device + ",process_utilization,";
+            rendered.processEnergy = "," + rendered.device + ",process_energy,";
+        }
+        devices.push_back(std::move(rendered));
+    }
+
+    clockOffset = std::chrono::system_clock::now().time_since_epoch() -
+                  std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                      std::chrono::steady_clock::now().time_since_epoch());
+}
+
+bool StreamWriter::write(const std::vector<const DeviceSnapshot *> &snapshots)
+{
+    buffer.clear();
+    if (format == StreamFormat::CSV && !headerWritten)
+    {
+        buffer.append(std::string_view(CSV_HEADER, sizeof(CSV_HEADER) - 1));
+        headerWritten = true;
+    }
+
+    size_t count = std::min(devices.size(), snapshots.size());
+    for (size_t d = 0; d < count; ++d)
+    {
+        if (snapshots[d] == nullptr)
+        {
+            continue;
+        }
+        const DeviceSnapshot &snapshot = *snapshots[d];
+        // Seconds since the epoch.
+        double time = std::chrono::duration<double>(
+                          std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                              snapshot.timestamp.time_since_epoch()) +
+                          clockOffset)
+                          .count();
+        if (format == StreamFormat::JSONL)
+        {
+            formatJson(devices[d], snapshot, time);
+        }
+        else
+        {
+            formatCsv(devices[d], snapshot, time);
+        }
+        recordCount++;
+    }
+
+    const char *data = buffer.data();
+    size_t size = buffer.size();
+    while (size > 0)
+    {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            std::cerr << "Stream write failed: " << strerror(errno) << std::endl;
+            return false;
+        }
+        data += written;
+        size -= (size_t)written;
+    }
+    return true;
+}
+
+void StreamWriter::formatJson(const Rendered &device, const DeviceSnapshot &snapshot, double time)
+{
+    auto out = std::back_inserter(buffer);
+    fmt::format_to(out, "{{\"time\":{:.3f},\"sequence\":{}", time, snapshot.sequence);
+    buffer.append(device.device);
+
+    buffer.append(std::string_view(",\"engines\":["));
+    size_t n = std::min(device.engines.size(), snapshot.engineUtilization.size());
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (i > 0)
+        {
+            buffer.push_back(',');
+        }
+        buffer.append(device.engines[i]);
+        fmt::format_to(out, "{:.1f}}}", snapshot.engineUtilization[i]);
+    }
+
+    buffer.append(std::string_view("],\"temperatures\":["));
+    n = std::min(device.temperatures.size(), snapshot.temperatures.size());
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (i > 0)
+        {
+            buffer.push_back(',');
+        }
+        buffer.append(device.temperatures[i]);
+        if (i < snapshot.temperatureSensors.size() && !snapshot.temperatureSensors[i].valid)
+        {
+            buffer.append(std::string_view("null}"));
+        }
+        else
+        {
+            fmt::format_to(out, "{:.1f}}}", snapshot.temperatures[i]);
+        }
+    }
+
+    buffer.append(std::string_view("],\"power\":["));
+    n = std::min(device.powerDomains.size(), snapshot.powerDomains.size());
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (i > 0)
+        {
+            buffer.push_back(',');
+        }
+        buffer.append(device.powerDomains[i]);
+        fmt::format_to(out, "{:.2f}", snapshot.powerDomains[i].power);
+        buffer.append(device.energy[i]);
+        fmt::format_to(out, "{:.3f}}}", snapshot.powerDomains[i].sessionEnergy);
+    }
+    buffer.push_back(']');
+
+    if (snapshot.components & COMPONENT_MEMORY)
+    {
+        fmt::format_to(out, ",\"memory\":{{\"size\":{},\"free\":{}}}", snapshot.memory.size, snapshot.memory.free);
+    }
+
+    if (snapshot.components & COMPONENT_PROCESSES)
+    {
+        buffer.append(std::string_view(",\"processes\":["));
+        for (size_t i = 0; i < snapshot.processes.size(); ++i)
+        {
+            const ProcessSample &process = snapshot.processes[i];
+            fmt::format_to(out, "{}{{\"pid\":{},\"name\":", i > 0 ? "," : "", process.pid);
+            appendJsonString(buffer, process.name);
+            fmt::format_to(out, ",\"memory\":{},\"utilization\":", process.used_memory);
+            int utilization = process_utilization(process);
+            if (utilization >= 0)
+            {
+                fmt::format_to(out, "{}", utilization);
+            }
+            else
+            {
+                buffer.append(std::string_view("null"));
+            }
+            buffer.append(std::string_view(",\"energy\":"));
+            if (process.energy >= 0)
+            {
+                fmt::format_to(out, "{:.3f}}}", process.energy);
+            }
+            else
+            {
+                buffer.append(std::string_view("null}"));
+            }
+        }
+        buffer.push_back(']');
+    }
+
+    buffer.append(std::string_view("}\n"));
+}
+
+void StreamWriter::formatCsv(const Rendered &device, const DeviceSnapshot &snapshot, double time)
+{
+    auto out = std::back_inserter(buffer);
+    // Every row starts with the time and sequence, so they are formatted
+    // once.
+    char stamp[64];
+    size_t stampLength = fmt::format_to_n(stamp, sizeof(stamp), "{:.3f},{}", time, snapshot.sequence).size;
+    auto row = [&](const std::string &prefix) {
+        buffer.append(stamp, stamp + std::min(stampLength, sizeof(stamp)));
+        buffer.append(prefix);
+    };
+
+    size_t n = std::min(device.engines.size(), snapshot.engineUtilization.size());
+    for (size_t i = 0; i < n; ++i)
+    {
+        row(device.engines[i]);
+        fmt::format_to(out, "{:.1f}\n", snapshot.engineUtilization[i]);
+    }
+
+    n = std::min(device.temperatures.size(), snapshot.temperatures.size());
+    for (size_t i = 0; i < n; ++i)
+    {
+        // Sensors that couldn't be read have no row.
+        if (i < snapshot.temperatureSensors.size() && !snapshot.temperatureSensors[i].valid)
+        {
+            continue;
+        }
+        row(device.temperatures[i]);
+        fmt::format_to(out, "{:.1f}\n", snapshot.temperatures[i]);
+    }
+
+    n = std::min(device.powerDomains.size(), snapshot.powerDomains.size());
+    for (size_t i = 0; i < n; ++i)
+    {
+        row(device.powerDomains[i]);
+        fmt::format_to(out, "{:.2f}\n", snapshot.powerDomains[i].power);
+        row(device.energy[i]);
+        fmt::format_to(out, "{:.3f}\n", snapshot.powerDomains[i].sessionEnergy);
+    }
+
+    if (snapshot.components & COMPONENT_MEMORY)
+    {
+        row(device.memorySize);
+        fmt::format_to(out, "{}\n", snapshot.memory.size);
+        row(device.memoryFree);
+        fmt::format_to(out, "{}\n", snapshot.memory.free);
+    }
+
+    // Process rows give the PID as the index and the name as the type.
+    for (const ProcessSample &process : snapshot.processes)
+    {
+        row(device.processMemory);
+        fmt::format_to(out, "{},", process.pid);
+        appendCsvField(buffer, process.name);
+        fmt::format_to(out, ",,{}\n", process.used_memory);
+
+        int utilization = process_utilization(process);
+        if (utilization >= 0)
+        {
+            row(device.processUtilization);
+            fmt::format_to(out, "{},", process.pid);
+            appendCsvField(buffer, process.name);
+            fmt::format_to(out, ",,{}\n", utilization);
+        }
+        if (process.energy >= 0)
+        {
+            row(device.processEnergy);
+            fmt::format_to(out, "{},", process.pid);
+            appendCsvField(buffer, process.name);
+            fmt::format_to(out, ",,{:.3f}\n", process.energy);
+        }
+    }
+}
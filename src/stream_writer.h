@@ -0,0 +1,73 @@
+#pragma once
+
+#include "device_labels.h"
+#include "snapshot.h"
+
+#include <fmt/format.h>         // for memory_buffer
+#include <chrono>               // for system_clock, steady_clock
+#include <cstdint>              // for uint64_t
+#include <string>               // for string
+#include <vector>               // for vector
+
+enum class StreamFormat
+{
+    JSONL,
+    CSV
+};
+
+// "jsonl" or "csv", as given to --stream.
+bool parse_stream_format(const std::string &name, StreamFormat &format);
+
+// Writes a record per device for every sample: engine utilization,
+// temperatures, power and energy, memory use and processes.
+//
+// JSON Lines gives one object per device per sample. CSV is in long form,
+// one row per value (time, sequence, bdf, metric, index, type, subdevice,
+// value), so devices with different components share the same columns.
+//
+// Meant for 10-100 samples a second across many devices, so everything
+// about a device that doesn't change is rendered once up front, each sample
+// is formatted with fmt::format_to into a buffer that keeps its capacity,
+// and all of the devices' records go out in a single write().
+class StreamWriter
+{
+public:
+    StreamWriter(int fd, StreamFormat format, std::vector<DeviceLabels> devices);
+
+    // Format snapshots, one per device in the order given to the
+    // constructor, and write them. Returns false, having logged why, if the
+    // output can't be written.
+    bool write(const std::vector<const DeviceSnapshot *> &snapshots);
+    // Records written so far, one per device per sample.
+    uint64_t getRecordCount() const { return recordCount; }
+
+private:
+    // Text repeated in every record, in the writer's format. In JSON these
+    // open each component's object up to its first value; in CSV they are
+    // the columns between the sequence and the value.
+    struct Rendered
+    {
+        std::string device;
+        std::vector<std::string> engines;
+        std::vector<std::string> powerDomains;
+        std::vector<std::string> energy;
+        std::vector<std::string> temperatures;
+        std::string memorySize;
+        std::string memoryFree;
+        std::string processMemory;
+        std::string processUtilization;
+        std::string processEnergy;
+    };
+
+    int fd;
+    StreamFormat format;
+    std::vector<Rendered> devices;
+    // Snapshot timestamps are steady_clock; records carry wall time.
+    std::chrono::system_clock::duration clockOffset;
+    fmt::memory_buffer buffer;
+    bool headerWritten = false;
+    uint64_t recordCount = 0;
+
+    void formatJson(const Rendered &device, const DeviceSnapshot &snapshot, double time);
+    void formatCsv(const Rendered &device, const DeviceSnapshot &snapshot, double time);
+};
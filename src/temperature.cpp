@@ -1,6 +1,14 @@
 #include "temperature.h"
 #include "helpers.h"
 
+namespace
+{
+// Readings needed before a trend is trusted, and the slowest climb (°C per
+// second) that counts as climbing rather than noise.
+const size_t MIN_TREND_SAMPLES = 5;
+const double MIN_CLIMB = 0.01;
+} // namespace
+
 bool TemperatureMonitor::initializeSensors()
 {
     uint32_t count = 0;
@@ -11,32 +19,111 @@ bool TemperatureMonitor::initializeSensors()
         return false;
     }
 
-    if (count > 0)
+    start = std::chrono::steady_clock::now();
+    if (count == 0)
     {
-        sensors.resize(count);
-        temperatures.resize(count);
-        ret = zesDeviceEnumTemperatureSensors(device, &count, sensors.data());
-        if (ret != ZE_RESULT_SUCCESS)
+        return true;
+    }
+
+    std::vector<zes_temp_handle_t> handles(count);
+    ret = zesDeviceEnumTemperatureSensors(device, &count, handles.data());
+    if (ret != ZE_RESULT_SUCCESS)
+    {
+        std::cerr << "Failed to retrieve temperature sensors: " << std::hex << ret << " (" << ze_error_to_str(ret) << ")" << std::endl;
+        return false;
+    }
+
+    sensors.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        sensors.push_back(Sensor{handles[i], {}, {}, false, false, 0.0, false, LinearTrend(trendSamples)});
+        Sensor &sensor = sensors.back();
+
+        // Both are optional: a sensor without them is still worth reading.
+        sensor.properties.stype = ZES_STRUCTURE_TYPE_TEMP_PROPERTIES;
+        ret = zesTemperatureGetProperties(sensor.handle, &sensor.properties);
+        sensor.haveProperties = ret == ZE_RESULT_SUCCESS;
+        if (!sensor.haveProperties && ret != ZE_RESULT_ERROR_UNSUPPORTED_FEATURE)
         {
-            std::cerr << "Failed to retrieve temperature sensors: " << std::hex << ret << " (" << ze_error_to_str(ret) << ")" << std::endl;
-            sensors.clear();
-            return false;
+            std::cerr << "zesTemperatureGetProperties failed for sensor " << i << ": " << std::hex << ret << " (" << ze_error_to_str(ret) << ")" << std::endl;
         }
+
+        // Reading the thresholds can need more privilege than reading the
+        // temperature, so a failure here isn't worth reporting.
+        sensor.config.stype = ZES_STRUCTURE_TYPE_TEMP_CONFIG;
+        sensor.haveConfig = zesTemperatureGetConfig(sensor.handle, &sensor.config) == ZE_RESULT_SUCCESS;
     }
     return true;
 }
 
-ze_result_t TemperatureMonitor::updateTemperatures()
+ze_result_t TemperatureMonitor::updateTemperatures(std::chrono::steady_clock::time_point now)
 {
-    ze_result_t ret;
+    ze_result_t result = ZE_RESULT_SUCCESS;
+    double seconds = std::chrono::duration<double>(now - start).count();
     for (size_t i = 0; i < sensors.size(); ++i)
     {
-        ret = zesTemperatureGetState(sensors[i], &temperatures[i]);
-        if (ret != ZE_RESULT_SUCCESS)
+        Sensor &sensor = sensors[i];
+        double temperature = 0.0;
+        ze_result_t ret = zesTemperatureGetState(sensor.handle, &temperature);
+        sensor.valid = ret == ZE_RESULT_SUCCESS;
+        if (!sensor.valid)
         {
             std::cerr << "Failed to get temperature sensor " << i << ": " << std::hex << ret << " (" << ze_error_to_str(ret) << ")" << std::endl;
-            return ret;
+            if (result == ZE_RESULT_SUCCESS)
+            {
+                result = ret;
+            }
+            continue;
         }
+        sensor.temperature = temperature;
+        sensor.trend.add(seconds, sensor.temperature);
+    }
+    return result;
+}
+
+double TemperatureMonitor::getThrottleTemperature(uint32_t index) const
+{
+    const Sensor &sensor = sensors[index];
+    if (sensor.haveProperties && sensor.properties.maxTemperature > 0)
+    {
+        return sensor.properties.maxTemperature;
+    }
+    return DEFAULT_THROTTLE_TEMPERATURE;
+}
+
+double TemperatureMonitor::getWarmTemperature(uint32_t index) const
+{
+    const Sensor &sensor = sensors[index];
+    double throttle = getThrottleTemperature(index);
+    if (sensor.haveConfig && sensor.config.threshold1.enableLowToHigh && sensor.config.threshold1.threshold > 0 &&
+        sensor.config.threshold1.threshold < throttle)
+    {
+        return sensor.config.threshold1.threshold;
+    }
+    return throttle - WARM_MARGIN;
+}
+
+double TemperatureMonitor::getTimeToThrottle(uint32_t index) const
+{
+    const Sensor &sensor = sensors[index];
+    // The last good reading says nothing about a sensor that now fails.
+    if (!sensor.valid)
+    {
+        return -1.0;
+    }
+    double throttle = getThrottleTemperature(index);
+    if (sensor.temperature >= throttle)
+    {
+        return 0.0;
+    }
+    if (sensor.trend.getCount() < MIN_TREND_SAMPLES)
+    {
+        return -1.0;
+    }
+    double slope = sensor.trend.getSlope();
+    if (slope < MIN_CLIMB)
+    {
+        return -1.0;
     }
-    return ZE_RESULT_SUCCESS;
+    return (throttle - sensor.temperature) / slope;
 }
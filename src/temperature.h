@@ -1,7 +1,10 @@
 #pragma once
 
+#include "statistics.h"
+
 #include <level_zero/ze_api.h>  // for _ze_result_t, ze_result_t, ZE_MAX_DE...
 #include <level_zero/zes_api.h> // for zes_device_handle_t, _zes_structure_...
+#include <chrono>               // for steady_clock
 #include <fstream>              // for basic_ostream, operator<<, endl, bas...
 #include <stdexcept>            // for runtime_error
 #include <iostream>             // for cerr, cout
@@ -9,10 +12,18 @@
 #include <sstream>              // for basic_ostringstream
 #include <vector>               // for vector
 
+// Throttle point assumed for sensors that don't report a maximum.
+constexpr double DEFAULT_THROTTLE_TEMPERATURE = 90.0;
+// How far below the throttle point a sensor counts as warm, unless its
+// first threshold is set.
+constexpr double WARM_MARGIN = 10.0;
+
 class TemperatureMonitor
 {
 public:
-    TemperatureMonitor(zes_device_handle_t device) : device(device)
+    // trendSamples is how many recent readings the time-to-throttle
+    // estimate is fitted to.
+    TemperatureMonitor(zes_device_handle_t device, size_t trendSamples = 30) : device(device), trendSamples(trendSamples)
     {
         if (!initializeSensors())
         {
@@ -20,15 +31,57 @@ public:
         }
     }
 
-    ze_result_t updateTemperatures();
-    double getTemperature(uint32_t index) const { return temperatures[index]; };
+    // Read every sensor. A sensor that fails is marked invalid and keeps
+    // its last reading; the others are still read. Returns the first
+    // failure.
+    ze_result_t updateTemperatures(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+    double getTemperature(uint32_t index) const { return sensors[index].temperature; };
     uint32_t getSensorCount() const { return sensors.size(); }
+    // Whether the last read of the sensor succeeded.
+    bool isValid(uint32_t index) const { return sensors[index].valid; }
+
+    // Properties and threshold configuration, or nullptr where the driver
+    // wouldn't give them.
+    const zes_temp_properties_t *getProperties(uint32_t index) const
+    {
+        return sensors[index].haveProperties ? &sensors[index].properties : nullptr;
+    }
+    const zes_temp_config_t *getConfig(uint32_t index) const
+    {
+        return sensors[index].haveConfig ? &sensors[index].config : nullptr;
+    }
+    // The sensor's maximum temperature, where the hardware starts to
+    // throttle, or DEFAULT_THROTTLE_TEMPERATURE if it doesn't report one.
+    double getThrottleTemperature(uint32_t index) const;
+    // Where the sensor counts as warm: its first threshold if one is set
+    // for rising temperatures, otherwise WARM_MARGIN below the throttle
+    // point.
+    double getWarmTemperature(uint32_t index) const;
+
+    // °C per second over the recent readings.
+    double getSlope(uint32_t index) const { return sensors[index].trend.getSlope(); }
+    // Seconds until the sensor reaches its throttle point at the current
+    // rate of climb: 0 if it already has, negative if it isn't climbing,
+    // there are too few readings to tell or the last read failed.
+    double getTimeToThrottle(uint32_t index) const;
 
 private:
+    struct Sensor
+    {
+        zes_temp_handle_t handle;
+        zes_temp_properties_t properties;
+        zes_temp_config_t config;
+        bool haveProperties;
+        bool haveConfig;
+        double temperature;
+        bool valid;
+        LinearTrend trend;
+    };
+
     zes_device_handle_t device;
-    std::vector<zes_temp_handle_t> sensors;
-    std::vector<double> temperatures;
+    size_t trendSamples;
+    std::vector<Sensor> sensors;
+    std::chrono::steady_clock::time_point start;
 
     bool initializeSensors();
 };
-
@@ -0,0 +1,191 @@
+#include "thread_pool.h"
+
+namespace
+{
+// Index of the queue owned by the current thread, if it is a pool worker.
+thread_local const ThreadPool *currentPool = nullptr;
+thread_local size_t currentQueue = 0;
+} // namespace
+
+ThreadPool::ThreadPool(size_t threads) : nextQueue(0), queued(0), stopping(false)
+{
+    // Always have at least one queue so a zero-thread pool can still accept
+    // work for TaskGroup::wait() to run.
+    size_t queueCount = threads > 0 ? threads : 1;
+    for (size_t i = 0; i < queueCount; ++i)
+    {
+        queues.emplace_back(std::make_unique<WorkQueue>());
+    }
+    for (size_t i = 0; i < threads; ++i)
+    {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    sleeping.notify_all();
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    // Workers push onto their own queue; everyone else spreads the work.
+    size_t index = currentPool == this ? currentQueue
+                                       : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    queued.fetch_add(1, std::memory_order_release);
+
+    // Taking the lock orders this notify after a worker's check of queued,
+    // so the wakeup can't be lost.
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    sleeping.notify_one();
+}
+
+bool ThreadPool::popTask(size_t home, std::function<void()> &task)
+{
+    if (queued.load(std::memory_order_acquire) == 0)
+    {
+        return false;
+    }
+
+    // Own queue first, newest task first...
+    {
+        WorkQueue &queue = *queues[home];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // ...then steal the oldest task from someone else.
+    for (size_t i = 1; i < queues.size(); ++i)
+    {
+        WorkQueue &queue = *queues[(home + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ThreadPool::runPendingTask()
+{
+    std::function<void()> task;
+    size_t home = currentPool == this ? currentQueue : 0;
+    if (!popTask(home, task))
+    {
+        return false;
+    }
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(size_t index)
+{
+    currentPool = this;
+    currentQueue = index;
+
+    for (;;)
+    {
+        std::function<void()> task;
+        if (popTask(index, task))
+        {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleeping.wait(lock, [this] { return stopping || queued.load(std::memory_order_acquire) > 0; });
+        if (stopping)
+        {
+            return;
+        }
+    }
+}
+
+TaskGroup::~TaskGroup()
+{
+    // Tasks reference this group; never let it go away underneath them.
+    drain();
+}
+
+void TaskGroup::run(std::function<void()> task)
+{
+    outstanding.fetch_add(1, std::memory_order_relaxed);
+    pool.submit([this, task = std::move(task)]() {
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            done.notify_all();
+        }
+    });
+}
+
+void TaskGroup::drain()
+{
+    while (outstanding.load(std::memory_order_acquire) > 0)
+    {
+        if (pool.runPendingTask())
+        {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return outstanding.load(std::memory_order_acquire) == 0; });
+    }
+
+    // The last task decrements and notifies under the mutex, so it may
+    // still be inside notify_all() when the count reads zero. Once the lock
+    // can be taken it has let go of the group for good.
+    std::lock_guard<std::mutex> lock(mutex);
+}
+
+void TaskGroup::wait()
+{
+    drain();
+
+    std::exception_ptr pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::swap(pending, error);
+    }
+    if (pending)
+    {
+        std::rethrow_exception(pending);
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "snapshot_buffer.h"    // for CACHE_LINE_SIZE
+
+#include <atomic>               // for atomic
+#include <condition_variable>   // for condition_variable
+#include <cstddef>              // for size_t
+#include <deque>                // for deque
+#include <exception>            // for exception_ptr
+#include <functional>           // for function
+#include <memory>               // for unique_ptr
+#include <mutex>                // for mutex
+#include <thread>               // for thread
+#include <vector>               // for vector
+
+// Small work-stealing pool. Each worker owns a queue it pops from the back
+// (newest first, which keeps nested work hot in cache); idle workers steal
+// from the front of the other queues. A pool created with zero threads is
+// valid: tasks then run on whichever thread calls TaskGroup::wait().
+class ThreadPool
+{
+public:
+    explicit ThreadPool(size_t threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    void submit(std::function<void()> task);
+    // Run one queued task on the calling thread, if there is one.
+    bool runPendingTask();
+    size_t getThreadCount() const { return workers.size(); }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> nextQueue;
+    std::atomic<size_t> queued;
+
+    std::mutex sleepMutex;
+    std::condition_variable sleeping;
+    bool stopping;
+
+    bool popTask(size_t home, std::function<void()> &task);
+    void workerLoop(size_t index);
+};
+
+// Tracks a batch of tasks submitted to a ThreadPool. wait() helps execute
+// queued work instead of just blocking, so tasks may themselves create and
+// wait on nested groups without deadlocking the pool. The first exception
+// thrown by a task is rethrown from wait().
+class TaskGroup
+{
+public:
+    explicit TaskGroup(ThreadPool &pool) : pool(pool), outstanding(0) {}
+    ~TaskGroup();
+
+    void run(std::function<void()> task);
+    void wait();
+
+private:
+    ThreadPool &pool;
+    std::atomic<size_t> outstanding;
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+
+    void drain();
+};
@@ -12,12 +12,24 @@ https://github.com/intel/compute-runtime/tree/master/programmers-guide
 #include "args.h"    // for arg_search_t, arg_enum, process_devi...
 #include "device.h"  // for ze_error_to_str, engine_type_to_str
 #include "engine.h"  // for ze_error_to_str, engine_type_to_str
+#include "event_listener.h"
+#include "exporter.h"
+#include "frequency_domain.h"
+#include "headless.h"
 #include "helpers.h" // for ze_error_to_str, engine_type_to_str
+#include "paths.h"   // for SystemPaths
 #include "power_domain.h"
 #include "process.h"     // for ze_error_to_str, engine_type_to_str
+#include "process_sort.h" // for select_top_processes, ProcessSortKey
+#include "profile.h"
+#include "sampler.h"
+#include "stream_writer.h"
 #include "temperature.h" // for ze_error_to_str, engine_type_to_str
 #include <chrono>
 #include <cmath>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
 #include <ftxui/component/component.hpp>
 #include <ftxui/component/screen_interactive.hpp>
 #include <ftxui/dom/elements.hpp>
@@ -25,7 +37,9 @@ https://github.com/intel/compute-runtime/tree/master/programmers-guide
 #include <ftxui/screen/color.hpp>
 #include <iomanip>
 #include <sstream>
+#include <sys/eventfd.h>
 #include <thread>
+#include <unistd.h>
 using namespace ftxui;
 
 // Helper to format bytes
@@ -42,6 +56,65 @@ std::string format_bytes(uint64_t bytes) {
   return buf;
 }
 
+// Helper to format a bandwidth in bytes per second as GB/s
+std::string format_bandwidth(double bytes_per_second) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.2f GB/s", bytes_per_second / 1e9);
+  return buf;
+}
+
+// Helper to format an event rate, e.g. "12.5k/s"
+std::string format_rate(double per_second) {
+  char buf[32];
+  if (per_second < 1000) {
+    snprintf(buf, sizeof(buf), "%.0f/s", per_second);
+  } else if (per_second < 1e6) {
+    snprintf(buf, sizeof(buf), "%.1fk/s", per_second / 1e3);
+  } else {
+    snprintf(buf, sizeof(buf), "%.1fM/s", per_second / 1e6);
+  }
+  return buf;
+}
+
+// Helper to format a sampling latency
+std::string format_latency(std::chrono::nanoseconds latency) {
+  char buf[32];
+  double usec = latency.count() / 1000.0;
+  if (usec < 1000) {
+    snprintf(buf, sizeof(buf), "%.0f us", usec);
+  } else {
+    snprintf(buf, sizeof(buf), "%.1f ms", usec / 1000);
+  }
+  return buf;
+}
+
+// Helper to draw the last `width` values as a line of block characters
+// scaled between lo and hi. Shorter histories are right aligned.
+std::string sparkline(const std::vector<double> &values, int width, double lo,
+                      double hi) {
+  static const char *blocks[] = {"▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"};
+  std::string line;
+  int count = std::min((int)values.size(), std::max(width, 0));
+  line.append(std::max(width, 0) - count, ' ');
+  double span = hi > lo ? hi - lo : 1.0;
+  for (int i = (int)values.size() - count; i < (int)values.size(); ++i) {
+    int level = (int)((values[i] - lo) / span * 7.0 + 0.5);
+    line += blocks[std::min(std::max(level, 0), 7)];
+  }
+  return line;
+}
+
+// Helper to format a window's p50/p95/p99 as "12/40/78"
+std::string format_quantiles(const StatisticsSummary &summary) {
+  if (summary.count == 0) {
+    return "-";
+  }
+  char buf[48];
+  snprintf(buf, sizeof(buf), "%.0f/%.0f/%.0f", summary.p50, summary.p95,
+           summary.p99);
+  return buf;
+}
+
 // Helper to get color based on percentage
 Color get_percentage_color(double percentage) {
   if (percentage < 30)
@@ -53,6 +126,65 @@ Color get_percentage_color(double percentage) {
   return Color::Red;
 }
 
+// Helper to get a color for the share of time spent throttled. Any
+// throttling is worth noticing, so this is stricter than a utilization.
+Color get_throttle_color(double percentage) {
+  if (percentage <= 0)
+    return Color::Green;
+  if (percentage < 10)
+    return Color::Yellow;
+  return Color::Red;
+}
+
+// Helper to format a frequency in MHz; negative means unknown
+std::string format_mhz(double mhz) {
+  if (mhz < 0) {
+    return "N/A";
+  }
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.0f MHz", mhz);
+  return buf;
+}
+
+// Helper to format joules, switching to Wh and kWh as they grow; negative
+// means unknown
+std::string format_energy(double joules) {
+  if (joules < 0) {
+    return "-";
+  }
+  char buf[32];
+  if (joules < 3600) {
+    snprintf(buf, sizeof(buf), "%.0f J", joules);
+  } else if (joules < 3600 * 1000) {
+    snprintf(buf, sizeof(buf), "%.2f Wh", joules / 3600);
+  } else {
+    snprintf(buf, sizeof(buf), "%.2f kWh", joules / 3600 / 1000);
+  }
+  return buf;
+}
+
+// Helper to format a time to throttle in seconds; negative means not
+// heading there.
+std::string format_time_to_throttle(double seconds) {
+  if (seconds < 0) {
+    return "-";
+  }
+  if (seconds == 0) {
+    return "NOW";
+  }
+  if (seconds >= 3600) {
+    return ">1h";
+  }
+  char buf[32];
+  if (seconds < 60) {
+    snprintf(buf, sizeof(buf), "%.0fs", seconds);
+  } else {
+    snprintf(buf, sizeof(buf), "%dm%02ds", (int)seconds / 60,
+             (int)seconds % 60);
+  }
+  return buf;
+}
+
 // Helper to get temperature color
 Color get_temp_color(double temp) {
   if (temp < 50)
@@ -69,6 +201,26 @@ Color get_temp_color(double temp) {
 void show_device_memory(Device *device) {
   zes_mem_state_t memState = device->getMemoryState();
   printf(" Memory: %lu\n", memState.size);
+  for (uint32_t i = 0; i < device->getMemoryModuleCount(); ++i) {
+    const MemoryModule *module = device->getMemoryModule(i);
+    const zes_mem_properties_t *properties = module->getMemoryProperties();
+    const zes_mem_state_t *state = module->getMemoryState();
+    printf("  Module %u: %s, %s\n", i, mem_type_to_str(properties->type),
+           properties->location == ZES_MEM_LOC_DEVICE ? "device" : "system");
+    printf("   Size: %lu (%lu free)\n", state->size, state->free);
+    printf("   Health: %s\n", mem_health_to_str(state->health));
+    if (properties->busWidth > 0) {
+      printf("   Bus width: %d bits\n", properties->busWidth);
+    }
+    if (properties->numChannels > 0) {
+      printf("   Channels: %d\n", properties->numChannels);
+    }
+    if (properties->onSubdevice) {
+      printf("   Sub-device: %u\n", properties->subdeviceId);
+    }
+    printf("   Bandwidth counters: %s\n",
+           module->isBandwidthSupported() ? "yes" : "no");
+  }
 }
 
 void show_device_properties(const Device *device) {
@@ -207,6 +359,19 @@ void show_power_domains(const Device *device) {
              i + 1, properties->canControl ? "Yes" : "No",
              properties->isEnergyThresholdSupported ? "Yes" : "No");
     }
+    for (const zes_power_limit_ext_desc_t &limit : powerDomain->getLimits()) {
+      printf("   %s Limit: ", power_level_to_str(limit.level));
+      if (!limit.enabled) {
+        printf("disabled\n");
+        continue;
+      }
+      printf("%.1f %s", limit.limit / 1000.0,
+             limit.limitUnit == ZES_LIMIT_UNIT_CURRENT ? "A" : "W");
+      if (limit.interval > 0) {
+        printf(" over %d ms", limit.interval);
+      }
+      printf("%s\n", limit.limitValueLocked ? " (locked)" : "");
+    }
   }
 }
 
@@ -235,6 +400,88 @@ void show_psus(const Device *device) {
   }
 }
 
+void show_frequency_domains(const Device *device) {
+  uint32_t frequencyDomainCount = device->getFrequencyDomainCount();
+
+  printf(" Frequency Domains: %d\n", frequencyDomainCount);
+  for (uint32_t i = 0; i < frequencyDomainCount; ++i) {
+    const FrequencyDomain *domain = device->getFrequencyDomain(i);
+    const zes_freq_properties_t *properties = domain->getFrequencyProperties();
+    const zes_freq_state_t *state = domain->getFrequencyState();
+    printf("  Frequency Domain %d: %s", i + 1,
+           freq_domain_to_str(properties->type));
+    if (properties->onSubdevice) {
+      printf(" (Sub-device ID: %04X)", properties->subdeviceId);
+    }
+    printf("\n");
+    printf("   Range: %.0f - %.0f MHz, Can Control: %s\n", properties->min,
+           properties->max, properties->canControl ? "Yes" : "No");
+    printf("   Actual: %s, Requested: %s\n", format_mhz(state->actual).c_str(),
+           format_mhz(state->request).c_str());
+    printf("   Throttle time counter: %s\n",
+           domain->isThrottleTimeSupported() ? "yes" : "no");
+    if (state->throttleReasons != 0) {
+      printf("   Throttled: %s\n",
+             throttle_reasons_to_str(state->throttleReasons).c_str());
+    }
+  }
+}
+
+void show_pci_link(const Device *device) {
+  const PciLink *link = device->getPciLink();
+  if (link == nullptr) {
+    return;
+  }
+  const zes_pci_properties_t *properties = link->getPciProperties();
+
+  printf(" PCIe Link:\n");
+  printf("  Max Speed: %s", pci_speed_to_str(properties->maxSpeed).c_str());
+  if (properties->maxSpeed.maxBandwidth > 0) {
+    printf(" (%s)",
+           format_bandwidth((double)properties->maxSpeed.maxBandwidth).c_str());
+  }
+  printf("\n");
+  printf("  Current Speed: %s%s\n", pci_speed_to_str(link->getSpeed()).c_str(),
+         link->isDegraded() ? " (DEGRADED)" : "");
+  if (link->isStateSupported()) {
+    printf("  Status: %s\n",
+           pci_link_status_to_str(link->getPciState()->status));
+  }
+  printf("  Bandwidth counters: %s\n",
+         link->isStatsSupported() && properties->haveBandwidthCounters ? "yes"
+                                                                       : "no");
+  printf("  Packet counters: %s\n",
+         link->isStatsSupported() && properties->havePacketCounters ? "yes"
+                                                                    : "no");
+  printf("  Replay counters: %s\n",
+         link->isStatsSupported() && properties->haveReplayCounters ? "yes"
+                                                                    : "no");
+}
+
+void show_ras_error_sets(const Device *device) {
+  uint32_t rasCount = device->getRasErrorSetCount();
+
+  printf(" RAS Error Sets: %d\n", rasCount);
+  for (uint32_t i = 0; i < rasCount; ++i) {
+    const RasErrorSet *set = device->getRasErrorSet(i);
+    const zes_ras_properties_t *properties = set->getRasProperties();
+    printf("  RAS Error Set %d: %s", i + 1,
+           properties->type == ZES_RAS_ERROR_TYPE_CORRECTABLE
+               ? "Correctable"
+               : "Uncorrectable");
+    if (properties->onSubdevice) {
+      printf(" (Sub-device ID: %04X)", properties->subdeviceId);
+    }
+    printf(", Total: %lu\n", set->getTotal());
+    for (uint32_t c = 0; c < ZES_MAX_RAS_ERROR_CATEGORY_COUNT; ++c) {
+      if (set->getRasState()->category[c] > 0) {
+        printf("   %s: %lu\n", ras_category_to_str((zes_ras_error_cat_t)c),
+               set->getRasState()->category[c]);
+      }
+    }
+  }
+}
+
 ze_result_t list_devices(std::vector<std::unique_ptr<Device>> &devices) {
   // Walk through each device and display properties
   for (uint32_t j = 0; j < devices.size(); ++j) {
@@ -249,10 +496,14 @@ ze_result_t list_devices(std::vector<std::unique_ptr<Device>> &devices) {
   return ZE_RESULT_SUCCESS;
 }
 
-std::vector<std::unique_ptr<Device>> get_devices() {
+std::vector<std::unique_ptr<Device>> get_devices(ThreadPool &pool) {
   std::vector<std::unique_ptr<Device>> devices;
+  std::vector<zes_device_handle_t> handles;
+  // The driver each handle came from.
+  std::vector<zes_driver_handle_t> handleDrivers;
 
   // Discover all the drivers
+  auto discovery = std::make_unique<StartupProfile::Scope>("driver discovery");
   uint32_t driversCount = 0;
   zesDriverGet(&driversCount, nullptr);
 
@@ -288,11 +539,23 @@ std::vector<std::unique_ptr<Device>> get_devices() {
 
     zesDeviceGet(drivers[driver], &deviceCount, deviceHandles.get());
 
-    // Walk through each device and get properties
-    for (uint32_t device = 0; device < deviceCount; ++device) {
-      devices.emplace_back(std::make_unique<Device>(deviceHandles[device]));
-    }
+    handles.insert(handles.end(), deviceHandles.get(),
+                   deviceHandles.get() + deviceCount);
+    handleDrivers.insert(handleDrivers.end(), deviceCount, drivers[driver]);
+  }
+  discovery.reset();
+
+  // Construct every device concurrently. Construction only reads device and
+  // PCI properties; components are enumerated later, on first use.
+  StartupProfile::Scope scope("device initialization");
+  devices.resize(handles.size());
+  TaskGroup group(pool);
+  for (size_t i = 0; i < handles.size(); ++i) {
+    group.run([&devices, &handles, &handleDrivers, i]() {
+      devices[i] = std::make_unique<Device>(handles[i], handleDrivers[i]);
+    });
   }
+  group.wait();
 
   return devices;
 }
@@ -346,14 +609,107 @@ int32_t find_device_index(arg_search_t search,
   return -1;
 }
 
+// Sensor type ("GPU", "MEMORY"), with the sub-device where there is one,
+// or "Sensor N" if the driver didn't say.
+std::string sensor_label(const TemperatureMonitor *monitor, uint32_t index) {
+  const zes_temp_properties_t *properties = monitor->getProperties(index);
+  if (properties == nullptr) {
+    return "Sensor " + std::to_string(index + 1);
+  }
+  std::string label = temp_sensor_to_str(properties->type);
+  if (properties->onSubdevice) {
+    label += " " + std::to_string(properties->subdeviceId);
+  }
+  return label;
+}
+
+// "1800 RPM (45%)", "45%" or "-".
+std::string format_fan_speed(const FanSample &fan) {
+  if (fan.speed < 0) {
+    return "-";
+  }
+  char buffer[32];
+  if (fan.units == ZES_FAN_SPEED_UNITS_PERCENT) {
+    snprintf(buffer, sizeof(buffer), "%d%%", fan.speed);
+  } else if (fan.percent >= 0) {
+    snprintf(buffer, sizeof(buffer), "%d RPM (%.0f%%)", fan.speed,
+             fan.percent);
+  } else {
+    snprintf(buffer, sizeof(buffer), "%d RPM", fan.speed);
+  }
+  return buffer;
+}
+
 void show_temperatures(Device *device) {
+  const TemperatureMonitor *monitor = device->getTemperatureMonitor();
+  if (monitor == nullptr) {
+    return;
+  }
   device->updateTemperatures();
 
-  for (uint32_t i = 0; i < device->getTemperatureCount(); ++i) {
-    printf("  Sensor %d: %.1fC", i, device->getTemperature(i));
+  printf(" Temperature Sensors:\n");
+  for (uint32_t i = 0; i < monitor->getSensorCount(); ++i) {
+    printf("  %s: ", sensor_label(monitor, i).c_str());
+    if (monitor->isValid(i)) {
+      printf("%.1fC", monitor->getTemperature(i));
+    } else {
+      printf("unreadable");
+    }
+    printf(", Throttle: %.1fC%s", monitor->getThrottleTemperature(i),
+           monitor->getProperties(i) != nullptr &&
+                   monitor->getProperties(i)->maxTemperature > 0
+               ? ""
+               : " (assumed)");
+    if (const zes_temp_config_t *config = monitor->getConfig(i)) {
+      if (config->threshold1.enableLowToHigh ||
+          config->threshold1.enableHighToLow) {
+        printf(", Threshold 1: %.1fC", config->threshold1.threshold);
+      }
+      if (config->threshold2.enableLowToHigh ||
+          config->threshold2.enableHighToLow) {
+        printf(", Threshold 2: %.1fC", config->threshold2.threshold);
+      }
+      if (config->enableCritical) {
+        printf(", Critical: enabled");
+      }
+    }
+    printf("\n");
+  }
+
+  for (uint32_t i = 0; i < device->getFanCount(); ++i) {
+    const Fan *fan = device->getFan(i);
+    const zes_fan_properties_t *properties = fan->getFanProperties();
+    FanSample sample;
+    sample.speed = fan->getSpeed();
+    sample.units = fan->getUnits();
+    sample.percent = fan->getPercent();
+    printf("  Fan %d: %s", i + 1, format_fan_speed(sample).c_str());
+    if (properties->maxRPM > 0) {
+      printf(", Max: %d RPM", properties->maxRPM);
+    }
+    printf(", Controllable: %s\n", properties->canControl ? "yes" : "no");
   }
 }
 
+// Session energy per process, printed on exit for chargeback.
+void show_process_energy(const Device *device) {
+  const EnergyAttribution &attribution = device->getEnergyAttribution();
+  std::vector<EnergyAttribution::Total> totals = attribution.getTotals();
+  if (totals.empty() && attribution.getIdleEnergy() <= 0) {
+    return;
+  }
+
+  printf("Energy by process this session:\n");
+  printf("  %8s %12s %10s  %s\n", "PID", "ENERGY (J)", "Wh", "NAME");
+  for (const EnergyAttribution::Total &total : totals) {
+    printf("  %8u %12.1f %10.4f  %s\n", total.pid, total.energy,
+           total.energy / 3600.0, total.name.c_str());
+  }
+  printf("  %8s %12.1f %10.4f  (idle, %.1f W)\n", "-",
+         attribution.getIdleEnergy(), attribution.getIdleEnergy() / 3600.0,
+         attribution.getIdlePower());
+}
+
 void copyright() {
   printf("ze-monitor: A small Level Zero Sysman GPU monitor utility\n");
   printf("Copyright (C) 2025 James Ketrenos\n");
@@ -364,16 +720,238 @@ void copyright() {
 #endif
 void version() { printf("Version: %s\n", APP_VERSION); }
 
+// How --exporter and --stream identify the device and its components, read
+// once the components are enumerated.
+DeviceLabels device_labels(const Device *device) {
+  DeviceLabels labels;
+  labels.uuid = uuid_to_string(&device->getDeviceExtProperties()->uuid);
+  labels.bdf = device->getLabel();
+  labels.model = device->getDeviceProperties()->modelName;
+
+  auto subdevice = [](ze_bool_t onSubdevice, uint32_t subdeviceId) {
+    return onSubdevice ? (int32_t)subdeviceId : -1;
+  };
+  for (uint32_t i = 0; i < device->getEngineCount(); ++i) {
+    const zes_engine_properties_t *properties =
+        device->getEngine(i)->getEngineProperties();
+    labels.engines.push_back(
+        {engine_type_to_str(properties->type),
+         subdevice(properties->onSubdevice, properties->subdeviceId)});
+  }
+  for (uint32_t i = 0; i < device->getPowerDomainCount(); ++i) {
+    const zes_power_properties_t *properties =
+        device->getPowerDomain(i)->getPowerDomainProperties();
+    labels.powerDomains.push_back(
+        {"", subdevice(properties->onSubdevice, properties->subdeviceId)});
+  }
+  const TemperatureMonitor *monitor = device->getTemperatureMonitor();
+  for (uint32_t i = 0; i < device->getTemperatureCount(); ++i) {
+    const zes_temp_properties_t *properties = monitor->getProperties(i);
+    labels.temperatures.push_back(
+        properties == nullptr
+            ? ComponentLabels{}
+            : ComponentLabels{temp_sensor_to_str(properties->type),
+                              subdevice(properties->onSubdevice,
+                                        properties->subdeviceId)});
+  }
+  for (uint32_t i = 0; i < device->getMemoryModuleCount(); ++i) {
+    const zes_mem_properties_t *properties =
+        device->getMemoryModule(i)->getMemoryProperties();
+    labels.memoryModules.push_back(
+        {mem_type_to_str(properties->type),
+         subdevice(properties->onSubdevice, properties->subdeviceId)});
+  }
+  for (uint32_t i = 0; i < device->getFrequencyDomainCount(); ++i) {
+    const zes_freq_properties_t *properties =
+        device->getFrequencyDomain(i)->getFrequencyProperties();
+    labels.frequencyDomains.push_back(
+        {freq_domain_to_str(properties->type),
+         subdevice(properties->onSubdevice, properties->subdeviceId)});
+  }
+  for (uint32_t i = 0; i < device->getRasErrorSetCount(); ++i) {
+    const zes_ras_properties_t *properties =
+        device->getRasErrorSet(i)->getRasProperties();
+    labels.rasErrorSets.push_back(
+        {properties->type == ZES_RAS_ERROR_TYPE_CORRECTABLE ? "correctable"
+                                                            : "uncorrectable",
+         subdevice(properties->onSubdevice, properties->subdeviceId)});
+  }
+  return labels;
+}
+
+// Written to by the SIGINT/SIGTERM handler, or on a write error, to end
+// --exporter and --stream.
+int headless_exit_fd = -1;
+
+void stop_headless(int = 0) {
+  uint64_t one = 1;
+  if (write(headless_exit_fd, &one, sizeof(one)) != sizeof(one)) {
+    // Only fails if an exit is already pending.
+  }
+}
+
+// Sample devices without the UI, handing every display-rate sample of all
+// of them to consume on the sampler thread, until SIGINT, SIGTERM or
+// stop_headless().
+void run_headless(
+    const std::vector<Device *> &devices, SamplingSchedule schedule,
+    bool use_events,
+    const std::function<void(const std::vector<const DeviceSnapshot *> &)>
+        &consume) {
+  // Same relaxed periods as the UI.
+  schedule.relax(COMPONENT_RAS, std::chrono::seconds(10));
+  const SamplingSchedule polled = schedule;
+  EventListener events(devices);
+  if (use_events) {
+    schedule.relax(events.registerEvents(), std::chrono::seconds(5));
+  }
+
+  Sampler sampler(devices, schedule);
+
+  headless_exit_fd = eventfd(0, EFD_CLOEXEC);
+  struct sigaction action = {};
+  action.sa_handler = stop_headless;
+  sigaction(SIGINT, &action, nullptr);
+  sigaction(SIGTERM, &action, nullptr);
+
+  // Reused every sample; the readers pin each device's snapshot only for
+  // as long as it takes to consume them.
+  std::vector<SnapshotBuffer<DeviceSnapshot>::Reader> readers;
+  readers.reserve(devices.size());
+  std::vector<const DeviceSnapshot *> snapshots(devices.size());
+  sampler.start([&]() {
+    for (size_t i = 0; i < devices.size(); ++i) {
+      readers.push_back(devices[i]->getSnapshot());
+      snapshots[i] = &*readers.back();
+    }
+    consume(snapshots);
+    readers.clear();
+  });
+  events.start(
+      [&sampler](Device *, zes_event_type_flags_t flags) {
+        sampler.requestSample(event_components(flags));
+      },
+      [&sampler, &polled]() { sampler.setSchedule(polled); });
+
+  uint64_t count;
+  while (read(headless_exit_fd, &count, sizeof(count)) < 0 &&
+         errno == EINTR) {
+  }
+
+  // The listener calls into the sampler, so it has to stop first.
+  events.stop();
+  sampler.stop();
+  close(headless_exit_fd);
+}
+
+// --exporter: serve every sample to Prometheus until interrupted.
+int run_exporter(const std::vector<Device *> &devices, ThreadPool &pool,
+                 const SamplingSchedule &schedule, bool use_events,
+                 std::chrono::milliseconds power_window, double smoothing,
+                 const std::string &host, uint16_t port) {
+  prepare_headless(devices, pool, EXPORTER_COMPONENTS, power_window,
+                   schedule.getPeriod(SCHEDULE_DISPLAY), smoothing);
+
+  std::vector<DeviceLabels> labels;
+  for (const Device *device : devices) {
+    labels.push_back(device_labels(device));
+  }
+  MetricsExporter exporter(std::move(labels));
+  if (!exporter.start(host, port)) {
+    return 1;
+  }
+  std::cout << "Serving metrics for " << devices.size()
+            << " device(s) on port " << exporter.getPort() << std::endl;
+
+  run_headless(devices, schedule, use_events,
+               [&exporter](const std::vector<const DeviceSnapshot *> &snapshots) {
+                 exporter.publish(snapshots);
+               });
+  exporter.stop();
+  return 0;
+}
+
+// --stream: write a record per device for every sample to output ("" for
+// stdout) until interrupted.
+int run_stream(const std::vector<Device *> &devices, ThreadPool &pool,
+               const SamplingSchedule &schedule, bool use_events,
+               std::chrono::milliseconds power_window, double smoothing,
+               StreamFormat format, const std::string &output) {
+  int fd = STDOUT_FILENO;
+  if (!output.empty()) {
+    fd = open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+      std::cerr << "Can't open " << output << ": " << strerror(errno)
+                << std::endl;
+      return 1;
+    }
+  }
+
+  // A reader that goes away (e.g. `| head`) should make write() fail with
+  // EPIPE so the stream shuts down cleanly, not kill the process.
+  struct sigaction ignore = {};
+  ignore.sa_handler = SIG_IGN;
+  sigaction(SIGPIPE, &ignore, nullptr);
+
+  prepare_headless(devices, pool, STREAM_COMPONENTS, power_window,
+                   schedule.getPeriod(SCHEDULE_DISPLAY), smoothing);
+
+  std::vector<DeviceLabels> labels;
+  for (const Device *device : devices) {
+    labels.push_back(device_labels(device));
+  }
+  StreamWriter writer(fd, format, std::move(labels));
+  bool failed = false;
+  run_headless(devices, schedule, use_events,
+               [&](const std::vector<const DeviceSnapshot *> &snapshots) {
+                 if (!failed && !writer.write(snapshots)) {
+                   failed = true;
+                   stop_headless();
+                 }
+               });
+
+  if (fd != STDOUT_FILENO) {
+    close(fd);
+  }
+  return failed ? 1 : 0;
+}
+
 void usage() {
   const uint32_t indent = 2;
-  const uint32_t option_len = 12;
   const char *options[][2] = {
       {"device ID",
        "Device ID to query. Can accept #, BDF, PCI-ID, /dev/dri/*."},
+      {"exporter [HOST]:PORT",
+       "Serve Prometheus metrics for all devices instead of the UI."},
       {"help", "This text."},
+      {"history DURATION",
+       "How much history to keep for sparklines (default 4h)."},
+      {"high-frequency",
+       "Sample engine activity every 10ms (same as --interval engines=10ms)."},
       {"info", "Show additional details about device."},
+      {"interval SPEC",
+       "Sampling periods, e.g. 500ms or engines=50ms,thermal=2s."},
+      {"no-events", "Only poll; don't listen for sysman events."},
+      {"output FILE", "Write --stream records to FILE instead of stdout."},
+      {"power-window DURATION",
+       "Window power readings are averaged over (default 1s)."},
+      {"procfs-root DIR",
+       "Read process information from DIR instead of /proc."},
+      {"smoothing ALPHA",
+       "EWMA weight (0-1] for displayed engine utilization; 1 is off."},
+      {"startup-profile", "Report time spent in each startup phase."},
+      {"stats-windows LIST",
+       "Statistics windows besides the session (default 1m,5m)."},
+      {"stream FORMAT",
+       "Write a jsonl or csv record per device per sample, without the UI."},
+      {"sysfs-root DIR", "Read device information from DIR instead of /sys."},
       {"version", "Version info."},
       {nullptr, nullptr}};
+  // Descriptions line up after the longest option.
+  int option_len = 0;
+  for (uint32_t i = 0; options[i][0] != nullptr; ++i) {
+    option_len = std::max(option_len, (int)strlen(options[i][0]));
+  }
   printf("\n");
   printf("usage: ze-monitor [OPTIONS]\n");
   printf("\n");
@@ -402,7 +980,23 @@ int main(int argc, char *argv[]) {
   bool showInfo = false;
   bool listDevices = true;
   bool one_shot = false;
+  bool startupProfile = false;
+  bool use_events = true;
+  SamplingSchedule schedule;
+  double smoothing = 1.0;
+  std::chrono::milliseconds history_length = std::chrono::hours(4);
+  std::chrono::milliseconds power_window = std::chrono::seconds(1);
+  // Zero is the whole session, which is always shown last.
+  std::vector<std::chrono::milliseconds> stats_windows = {
+      std::chrono::minutes(1), std::chrono::minutes(5)};
   arg_search_t argSearch;
+  std::string device_arg;
+  bool exporting = false;
+  std::string exporter_host;
+  uint16_t exporter_port = 0;
+  bool streaming = false;
+  StreamFormat stream_format = StreamFormat::JSONL;
+  std::string stream_output;
 
   // Process command-line arguments
   for (int i = 1; i < argc; ++i) {
@@ -410,18 +1004,90 @@ int main(int argc, char *argv[]) {
 
     // Look for --device argument
     if (arg == "--device" && i + 1 < argc) {
-      std::string device_arg = argv[i + 1];
-      argSearch = process_device_argument(device_arg);
-      if (argSearch.type == INVALID) {
-        std::cerr << "Invalid argument: " << arg << std::endl;
-        return -1;
-      }
+      // Resolved once every option is read, as a /dev/dri path is looked up
+      // under --sysfs-root.
+      device_arg = argv[i + 1];
       i++; // Skip the device argument
       listDevices = false;
+    } else if (arg == "--exporter" && i + 1 < argc) {
+      if (!parse_listen_address(argv[i + 1], exporter_host, exporter_port)) {
+        std::cerr << "Invalid --exporter: " << argv[i + 1]
+                  << " (expected [HOST]:PORT)" << std::endl;
+        return 1;
+      }
+      exporting = true;
+      listDevices = false;
+      i++; // Skip the address
+    } else if (arg == "--output" && i + 1 < argc) {
+      stream_output = argv[i + 1];
+      i++; // Skip the path
+    } else if (arg == "--stream" && i + 1 < argc) {
+      if (!parse_stream_format(argv[i + 1], stream_format)) {
+        std::cerr << "Invalid --stream: " << argv[i + 1]
+                  << " (expected jsonl or csv)" << std::endl;
+        return 1;
+      }
+      streaming = true;
+      listDevices = false;
+      i++; // Skip the format
+    } else if (arg == "--procfs-root" && i + 1 < argc) {
+      SystemPaths::instance().proc = argv[i + 1];
+      i++; // Skip the path
+    } else if (arg == "--sysfs-root" && i + 1 < argc) {
+      SystemPaths::instance().sys = argv[i + 1];
+      i++; // Skip the path
+    } else if (arg == "--interval" && i + 1 < argc) {
+      std::string error;
+      if (!schedule.parse(argv[i + 1], error)) {
+        std::cerr << "Invalid --interval: " << error << std::endl;
+        return 1;
+      }
+      i++; // Skip the interval argument
+    } else if (arg == "--history" && i + 1 < argc) {
+      if (!SamplingSchedule::parseDuration(argv[i + 1], history_length)) {
+        std::cerr << "Invalid --history: " << argv[i + 1] << std::endl;
+        return 1;
+      }
+      i++; // Skip the history argument
+    } else if (arg == "--power-window" && i + 1 < argc) {
+      if (!SamplingSchedule::parseDuration(argv[i + 1], power_window)) {
+        std::cerr << "Invalid --power-window: " << argv[i + 1] << std::endl;
+        return 1;
+      }
+      i++; // Skip the window argument
+    } else if (arg == "--stats-windows" && i + 1 < argc) {
+      stats_windows.clear();
+      std::stringstream list(argv[i + 1]);
+      std::string entry;
+      while (std::getline(list, entry, ',')) {
+        std::chrono::milliseconds window;
+        if (!SamplingSchedule::parseDuration(entry, window)) {
+          std::cerr << "Invalid --stats-windows entry: " << entry << std::endl;
+          return 1;
+        }
+        stats_windows.push_back(window);
+      }
+      i++; // Skip the window list
+    } else if (arg == "--high-frequency") {
+      schedule.setPeriod(COMPONENT_ENGINES, std::chrono::milliseconds(10));
+    } else if (arg == "--smoothing" && i + 1 < argc) {
+      char *end = nullptr;
+      smoothing = strtod(argv[i + 1], &end);
+      if (end == argv[i + 1] || *end != '\0' || !(smoothing > 0.0) ||
+          smoothing > 1.0) {
+        std::cerr << "Invalid --smoothing: " << argv[i + 1]
+                  << " (expected a value in (0, 1])" << std::endl;
+        return 1;
+      }
+      i++; // Skip the smoothing argument
     } else if (arg == "--info") {
       showInfo = true;
+    } else if (arg == "--no-events") {
+      use_events = false;
     } else if (arg == "--one-shot") {
       one_shot = true;
+    } else if (arg == "--startup-profile") {
+      startupProfile = true;
     } else if (arg == "--list") {
       listDevices = true;
     } else if (arg == "--version") {
@@ -438,12 +1104,32 @@ int main(int argc, char *argv[]) {
     }
   }
 
-  if (zesInit(0) != ZE_RESULT_SUCCESS) {
-    printf("Can't initialize the API\n");
-    return -1;
+  if (exporting && streaming) {
+    std::cerr << "--exporter and --stream can't be used together" << std::endl;
+    return 1;
+  }
+
+  if (!device_arg.empty()) {
+    argSearch = process_device_argument(device_arg);
+    if (argSearch.type == INVALID) {
+      std::cerr << "Invalid argument: --device " << device_arg << std::endl;
+      return -1;
+    }
+  }
+
+  {
+    StartupProfile::Scope scope("zesInit");
+    if (zesInit(0) != ZE_RESULT_SUCCESS) {
+      printf("Can't initialize the API\n");
+      return -1;
+    }
   }
 
-  std::vector<std::unique_ptr<Device>> devices = get_devices();
+  // Shared by device construction and --info component enumeration; the
+  // main thread helps out while waiting, so it counts as one of the threads.
+  ThreadPool pool(std::max<unsigned>(std::thread::hardware_concurrency(), 1) -
+                  1);
+  std::vector<std::unique_ptr<Device>> devices = get_devices(pool);
 
   Device *device = nullptr;
   int32_t index = -1;
@@ -458,26 +1144,48 @@ int main(int argc, char *argv[]) {
     }
   }
 
-  if (device == nullptr && !showInfo) {
+  if (device == nullptr && !showInfo && !exporting && !streaming) {
     listDevices = true;
   }
 
   if (listDevices) {
     list_devices(devices);
+    if (startupProfile) {
+      StartupProfile::instance().report(stderr);
+    }
     return 0;
   }
 
+  // Everything --info displays except processes.
+  const component_flags_t info_components = COMPONENT_ENGINES | COMPONENT_POWER |
+                                            COMPONENT_PSUS | COMPONENT_MEMORY |
+                                            COMPONENT_THERMAL |
+                                            COMPONENT_FREQUENCY | COMPONENT_PCI |
+                                            COMPONENT_RAS;
+
   // If --info was requested, either show the single --device or if no device
   // was provided, list all devices.
   if (showInfo) {
     if (device != nullptr) {
+      device->initializeComponents(info_components, &pool);
       show_device_properties(device);
       show_device_memory(device);
       show_engine_groups(device);
       show_temperatures(device);
       show_power_domains(device);
       show_psus(device);
+      show_frequency_domains(device);
+      show_pci_link(device);
+      show_ras_error_sets(device);
     } else {
+      TaskGroup group(pool);
+      for (auto &each : devices) {
+        group.run([&each, &pool, info_components]() {
+          each->initializeComponents(info_components, &pool);
+        });
+      }
+      group.wait();
+
       for (uint32_t i = 0; i < devices.size(); ++i) {
         device = devices[i].get();
 
@@ -492,15 +1200,108 @@ int main(int argc, char *argv[]) {
         show_temperatures(device);
         show_power_domains(device);
         show_psus(device);
+        show_frequency_domains(device);
+        show_pci_link(device);
+        show_ras_error_sets(device);
       }
     }
+    if (startupProfile) {
+      StartupProfile::instance().report(stderr);
+    }
     return 0;
   }
 
+  // Headless: every device, or just the one given with --device.
+  if (exporting || streaming) {
+    std::vector<Device *> selected;
+    for (auto &each : devices) {
+      if (device == nullptr || each.get() == device) {
+        selected.push_back(each.get());
+      }
+    }
+    if (exporting) {
+      return run_exporter(selected, pool, schedule, use_events, power_window,
+                          smoothing, exporter_host, exporter_port);
+    }
+    return run_stream(selected, pool, schedule, use_events, power_window,
+                      smoothing, stream_format, stream_output);
+  }
+
   // FTXUI main UI loop
   auto screen = ScreenInteractive::Fullscreen();
 
-  enum class ViewMode { OVERVIEW, ENGINES, PROCESSES, POWER, THERMAL };
+  // RAS counters rarely change and reading them can be slow, so unless
+  // --interval says otherwise they are read every 10 seconds.
+  schedule.relax(COMPONENT_RAS, std::chrono::seconds(10));
+
+  // Sysman events (critical temperatures, resets, health changes, throttling)
+  // trigger an immediate sample of whatever they affect, so the classes they
+  // cover can be polled much less often unless --interval says otherwise.
+  // If listening fails the sampler goes back to the polled schedule.
+  const SamplingSchedule polled = schedule;
+  EventListener events({device});
+  if (use_events) {
+    schedule.relax(events.registerEvents(), std::chrono::seconds(5));
+  }
+
+  device->setPowerWindow(power_window);
+
+  // All sysman polling happens on the sampler thread; the renderer below only
+  // reads the most recently published snapshot.
+  Sampler sampler({device}, schedule);
+  // Engines may be sampled much faster than the screen redraws; what is
+  // displayed is the average over each redraw period.
+  device->setEngineDecimation(schedule.getPeriod(SCHEDULE_DISPLAY), smoothing);
+  // Fast samples per redraw, used for the PEAK column in the Engines view.
+  const size_t engine_window_samples =
+      std::max<size_t>(schedule.getPeriod(SCHEDULE_DISPLAY) /
+                           schedule.getPeriod(COMPONENT_ENGINES),
+                       1);
+  std::vector<EngineSample> engine_history;
+  stats_windows.push_back(std::chrono::milliseconds(0));
+  device->setHistory(
+      std::chrono::duration_cast<std::chrono::seconds>(history_length),
+      stats_windows, schedule);
+  // Reused for every sparkline so redraws don't allocate.
+  std::vector<double> history_values;
+  // Indices into snapshot->processes of the rows to show, best first.
+  std::vector<uint32_t> process_order;
+
+  enum class ViewMode {
+    OVERVIEW,
+    ENGINES,
+    PROCESSES,
+    POWER,
+    THERMAL,
+    MEMORY,
+    FREQUENCY
+  };
+
+  // Components each view reads from the snapshot. Only these are enumerated
+  // and sampled, so a session pays only for the views it actually opens.
+  auto view_components = [](ViewMode mode) -> component_flags_t {
+    // The header always shows memory, temperature, throttling and RAS errors.
+    component_flags_t components = COMPONENT_MEMORY | COMPONENT_THERMAL |
+                                   COMPONENT_FREQUENCY | COMPONENT_RAS;
+    switch (mode) {
+    // Process energy is apportioned from the device's, so the process lists
+    // need power too.
+    case ViewMode::OVERVIEW:
+      return components | COMPONENT_ENGINES | COMPONENT_PROCESSES |
+             COMPONENT_POWER | COMPONENT_PCI;
+    case ViewMode::ENGINES:
+      return components | COMPONENT_ENGINES;
+    case ViewMode::PROCESSES:
+      return components | COMPONENT_PROCESSES | COMPONENT_POWER;
+    case ViewMode::POWER:
+      return components | COMPONENT_POWER | COMPONENT_PSUS;
+    case ViewMode::THERMAL:
+    case ViewMode::MEMORY:
+    case ViewMode::FREQUENCY:
+      return components;
+    }
+    return components;
+  };
 
   struct UIState {
     ViewMode view_mode = ViewMode::OVERVIEW;
@@ -508,27 +1309,28 @@ int main(int argc, char *argv[]) {
     int engine_offset = 0;
     int thermal_offset = 0;
     int power_offset = 0;
+    // Index into stats_windows shown in the STATS columns.
+    size_t stats_window = 0;
+    ProcessSortKey process_sort = ProcessSortKey::MEMORY;
     bool show_help = false;
-    std::chrono::steady_clock::time_point refresh_time =
-        std::chrono::steady_clock::now();
   };
 
   UIState state;
+  device->require(view_components(state.view_mode));
+
+  auto switch_view = [&](ViewMode mode) {
+    state.view_mode = mode;
+    component_flags_t components = view_components(mode);
+    if ((device->getRequiredComponents() & components) != components) {
+      device->require(components);
+      sampler.requestSample();
+    }
+  };
   // Buffer holding the final rendered screen to print on exit
   std::string final_frame_buffer;
   // Keep the last rendered Element so we can render it to a Screen on exit
   Element last_rendered_element;
 
-  // Auto-refresh timer
-  auto refresh_timer = [&] {
-    auto now = std::chrono::steady_clock::now();
-    if (now - state.refresh_time > std::chrono::seconds(1)) {
-      state.refresh_time = now;
-      return true;
-    }
-    return false;
-  };
-
   // For one-shot mode we want to render once then exit
   bool one_shot_rendered = false;
 
@@ -538,11 +1340,7 @@ int main(int argc, char *argv[]) {
         int screen_width = terminal.dimx;
         int screen_height = terminal.dimy;
 
-        // Auto refresh every second
-        if (refresh_timer()) {
-          device->updateTemperatures();
-          device->updateProcesses();
-        }
+        auto snapshot = device->getSnapshot();
 
         // Use FTXUI flex utilities to allow gauges to grow and fill remaining
         // horizontal space. xflex_grow wraps the gauge and permits it to expand
@@ -550,18 +1348,95 @@ int main(int argc, char *argv[]) {
 
         Elements main_content;
 
+        // Header for the STATS columns, e.g. "P50/95/99 1m".
+        std::string stats_header =
+            "P50/95/99 " +
+            statistics_window_label(stats_windows[state.stats_window]);
+        auto window_quantiles =
+            [&](const std::vector<std::vector<StatisticsSummary>> &statistics,
+                size_t index) -> std::string {
+          if (index >= statistics.size() ||
+              state.stats_window >= statistics[index].size()) {
+            return "-";
+          }
+          return format_quantiles(statistics[index][state.stats_window]);
+        };
+
         // Header with device info
-        auto mem = device->getMemoryState();
+        auto mem = snapshot->memory;
         double mem_usage_pct = 0.0;
         if (mem.size > 0) {
           mem_usage_pct = (1.0 - (double)mem.free / mem.size) * 100;
         }
+        // Average over the sensors that could be read, and the soonest
+        // any of them is expected to reach its throttle point.
         auto avg_temp = 0.0;
-        if (device->getTemperatureCount() > 0) {
-          for (uint32_t i = 0; i < device->getTemperatureCount(); ++i) {
-            avg_temp += device->getTemperature(i);
+        int temp_count = 0;
+        double time_to_throttle = -1;
+        for (size_t i = 0; i < snapshot->temperatures.size(); ++i) {
+          if (i < snapshot->temperatureSensors.size() &&
+              !snapshot->temperatureSensors[i].valid) {
+            continue;
           }
-          avg_temp /= device->getTemperatureCount();
+          avg_temp += snapshot->temperatures[i];
+          temp_count++;
+          double eta = i < snapshot->temperatureSensors.size()
+                           ? snapshot->temperatureSensors[i].timeToThrottle
+                           : -1;
+          if (eta >= 0 && (time_to_throttle < 0 || eta < time_to_throttle)) {
+            time_to_throttle = eta;
+          }
+        }
+        if (temp_count > 0) {
+          avg_temp /= temp_count;
+        }
+        // Only worth a place in the header when it is close.
+        std::string throttle_eta_text =
+            time_to_throttle >= 0 && time_to_throttle < 300
+                ? " (throttle " + format_time_to_throttle(time_to_throttle) +
+                      ")"
+                : "";
+        // Worst throttling across every frequency domain, and all the
+        // reasons given for it.
+        double throttle_pct = 0.0;
+        zes_freq_throttle_reason_flags_t throttle_reasons = 0;
+        for (const FrequencySample &domain : snapshot->frequencyDomains) {
+          throttle_pct = std::max(throttle_pct, domain.throttleFraction * 100);
+          throttle_reasons |= domain.state.throttleReasons;
+        }
+        std::string throttle_text =
+            snapshot->frequencyDomains.empty()
+                ? "N/A"
+                : std::to_string((int)std::round(throttle_pct)) + "%";
+        if (throttle_reasons != 0) {
+          throttle_text += " " + throttle_reasons_to_str(throttle_reasons);
+        }
+        // Correctable errors are expected now and then; a rate that keeps
+        // climbing is what precedes retries and device loss, so that is
+        // what gets highlighted. Any uncorrectable error is.
+        uint64_t correctable = 0, uncorrectable = 0;
+        double correctable_rate = 0.0;
+        bool correctable_rising = false;
+        for (const RasSample &set : snapshot->rasErrorSets) {
+          if (set.type == ZES_RAS_ERROR_TYPE_CORRECTABLE) {
+            correctable += set.total;
+            correctable_rate += set.rate;
+            correctable_rising |= set.rising;
+          } else {
+            uncorrectable += set.total;
+          }
+        }
+        std::string ras_text = "N/A";
+        Color ras_color = Color::GrayDark;
+        if (!snapshot->rasErrorSets.empty()) {
+          char buffer[64];
+          snprintf(buffer, sizeof(buffer), "CE %lu (%.1f/h%s) UE %lu",
+                   correctable, correctable_rate,
+                   correctable_rising ? " ↑" : "", uncorrectable);
+          ras_text = buffer;
+          ras_color = uncorrectable > 0 || correctable_rising ? Color::Red
+                      : correctable_rate > 0                 ? Color::Yellow
+                                                             : Color::Green;
         }
 
         auto header =
@@ -585,6 +1460,10 @@ int main(int argc, char *argv[]) {
                            return "Power";
                          case ViewMode::THERMAL:
                            return "Thermal";
+                         case ViewMode::MEMORY:
+                           return "Memory";
+                         case ViewMode::FREQUENCY:
+                           return "Frequency";
                          }
                          return "Unknown";
                        }()) |
@@ -609,7 +1488,22 @@ int main(int argc, char *argv[]) {
                            : text(""),
                        separator(), text(" Temp: ") | color(Color::White),
                        text(std::to_string((int)avg_temp) + "°C") |
-                           color(get_temp_color(avg_temp))})}) |
+                           color(get_temp_color(avg_temp)),
+                       text(throttle_eta_text) | bold |
+                           color(time_to_throttle < 60 ? Color::Red
+                                                       : Color::Yellow),
+                       separator(), text(" Throttle: ") | color(Color::White),
+                       text(throttle_text) |
+                           color(snapshot->frequencyDomains.empty()
+                                     ? Color::GrayDark
+                                     : get_throttle_color(throttle_pct)),
+                       separator(), text(" RAS: ") | color(Color::White),
+                       correctable_rising || uncorrectable > 0
+                           ? text(ras_text) | bold | color(ras_color)
+                           : text(ras_text) | color(ras_color),
+                       separator(), text(" Sample: ") | color(Color::White),
+                       text(format_latency(snapshot->sampleLatency)) |
+                           color(Color::GrayDark)})}) |
             size(HEIGHT, GREATER_THAN, 2) | border | color(Color::Cyan) |
             notflex;
 
@@ -626,9 +1520,9 @@ int main(int argc, char *argv[]) {
                     text("SUB-DEV") | bold | size(WIDTH, EQUAL, 10)}) |
               color(Color::White));
 
-          for (uint32_t i = 0; i < device->getEngineCount(); ++i) {
+          for (uint32_t i = 0; i < snapshot->engineUtilization.size(); ++i) {
             auto engine = device->getEngine(i);
-            double util = engine->getEngineUtilization();
+            double util = snapshot->engineUtilization[i];
             auto subdev =
                 engine->getEngineProperties()->onSubdevice
                     ? std::to_string(engine->getEngineProperties()->subdeviceId)
@@ -655,6 +1549,60 @@ int main(int argc, char *argv[]) {
                     vbox(std::move(engine_rows))}) |
               border);
 
+          // PCIe link: host transfers and whether the link trained at its
+          // full speed and width.
+          if (snapshot->components & COMPONENT_PCI) {
+            const PciSample &pci = snapshot->pci;
+            auto link = device->getPciLink();
+            const zes_pci_properties_t *pci_properties =
+                link->getPciProperties();
+            bool link_ok = !pci.degraded &&
+                           pci.state.status != ZES_PCI_LINK_STATUS_QUALITY_ISSUES &&
+                           pci.state.status != ZES_PCI_LINK_STATUS_STABILITY_ISSUES;
+            bool have_bandwidth = link->isStatsSupported() &&
+                                  pci_properties->haveBandwidthCounters;
+            bool have_packets = link->isStatsSupported() &&
+                                pci_properties->havePacketCounters;
+            bool have_replays = link->isStatsSupported() &&
+                                pci_properties->haveReplayCounters;
+
+            main_content.push_back(
+                vbox({text("🔌 PCIe Link") | bold | color(Color::Green),
+                      hbox({text(pci_speed_to_str(pci.speed)) |
+                                color(link_ok ? Color::Cyan : Color::Red),
+                            text(" of " +
+                                 pci_speed_to_str(pci_properties->maxSpeed)) |
+                                color(Color::GrayDark),
+                            text(pci.degraded ? " DEGRADED " : " ") |
+                                bold | color(Color::Red),
+                            text(link->isStateSupported()
+                                     ? pci_link_status_to_str(pci.state.status)
+                                     : "") |
+                                color(link_ok ? Color::Green : Color::Red),
+                            separator(), text(" RX: ") | color(Color::White),
+                            text(have_bandwidth
+                                     ? format_bandwidth(pci.rxBandwidth)
+                                     : "N/A") |
+                                color(Color::Yellow),
+                            separator(), text(" TX: ") | color(Color::White),
+                            text(have_bandwidth
+                                     ? format_bandwidth(pci.txBandwidth)
+                                     : "N/A") |
+                                color(Color::Yellow),
+                            separator(),
+                            text(" Packets: ") | color(Color::White),
+                            text(have_packets ? format_rate(pci.packetRate)
+                                              : "N/A") |
+                                color(Color::GrayDark),
+                            separator(),
+                            text(" Replays: ") | color(Color::White),
+                            text(have_replays ? format_rate(pci.replayRate)
+                                              : "N/A") |
+                                color(pci.replayRate > 0 ? Color::Red
+                                                         : Color::GrayDark)})}) |
+                border);
+          }
+
           // Top processes
           Elements proc_rows;
           proc_rows.push_back(
@@ -665,33 +1613,35 @@ int main(int argc, char *argv[]) {
               color(Color::White));
 
           int proc_limit =
-              std::min((int)(screen_height - (6 + device->getEngineCount() + 4 +
-                                              (state.show_help ? 5 : 3) + 2)),
-                       (int)device->getProcessCount());
+              std::min((int)(screen_height - (6 + snapshot->engineUtilization.size() + 4 +
+                                              (state.show_help ? 5 : 3) + 2 +
+                                              (snapshot->components & COMPONENT_PCI ? 4 : 0))),
+                       (int)snapshot->processes.size());
+          select_top_processes(snapshot->processes, state.process_sort,
+                               std::max(proc_limit, 0), process_order);
           for (int i = 0; i < proc_limit; ++i) {
-            auto proc = device->getProcessInfo(i);
+            const ProcessSample &proc = snapshot->processes[process_order[i]];
             auto mem_pct =
-                mem.size > 0
-                    ? (double)proc->getProcessState()->memSize / mem.size * 100
-                    : 0.0;
+                mem.size > 0 ? (double)proc.used_memory / mem.size * 100 : 0.0;
 
             proc_rows.push_back(hbox(
-                {text(std::to_string(proc->getProcessState()->processId)) |
-                     size(WIDTH, EQUAL, 8) | color(Color::Yellow),
+                {text(std::to_string(proc.pid)) | size(WIDTH, EQUAL, 8) |
+                     color(Color::Yellow),
                  separator(),
-                 text(ellipses(proc->getCommandLine(), screen_width - 34)) |
-                     flex | color(Color::White),
+                 text(ellipses(proc.command_line, screen_width - 34)) | flex |
+                     color(Color::White),
                  separator(),
-                 text(format_bytes(proc->getProcessState()->memSize)) |
-                     size(WIDTH, EQUAL, 12) |
+                 text(format_bytes(proc.used_memory)) | size(WIDTH, EQUAL, 12) |
                      color(get_percentage_color(mem_pct)),
                  separator(),
-                 text(format_bytes(proc->getProcessState()->sharedSize)) |
+                 text(format_bytes(proc.shared_memory)) |
                      size(WIDTH, EQUAL, 12) | color(Color::GrayDark)}));
           }
 
           main_content.push_back(
-              vbox({text("📊 Top Processes") | bold | color(Color::Green),
+              vbox({text(std::string("📊 Top Processes by ") +
+                         process_sort_key_to_str(state.process_sort)) |
+                        bold | color(Color::Green),
                     vbox(std::move(proc_rows)) | vscroll_indicator | frame}) |
               border);
           break;
@@ -702,6 +1652,11 @@ int main(int argc, char *argv[]) {
           engine_detail.push_back(
               hbox({text("ENGINE") | bold | size(WIDTH, EQUAL, 15), separator(),
                     text("UTILIZATION") | bold | flex, separator(),
+                    text("PEAK") | bold | size(WIDTH, EQUAL, 6), separator(),
+                    text("HISTORY") | bold | size(WIDTH, EQUAL, 24),
+                    separator(),
+                    text(stats_header) | bold | size(WIDTH, EQUAL, 18),
+                    separator(),
                     text("SUB-DEVICE") | bold | size(WIDTH, EQUAL, 15),
                     separator(),
                     text("STATUS") | bold | size(WIDTH, EQUAL, 15)}) |
@@ -710,14 +1665,28 @@ int main(int argc, char *argv[]) {
           int visible_engines = 15;
           int start = state.engine_offset;
           int end =
-              std::min(start + visible_engines, (int)device->getEngineCount());
+              std::min(start + visible_engines,
+                       (int)snapshot->engineUtilization.size());
 
           for (int i = start; i < end; ++i) {
             auto engine = device->getEngine(i);
-            double util = engine->getEngineUtilization();
+            double util = snapshot->engineUtilization[i];
             auto status = util > 0 ? "ACTIVE" : "IDLE";
             auto status_color = util > 0 ? Color::Green : Color::GrayDark;
 
+            // Busiest single sample in the last redraw period; a high peak
+            // over a low average points at bursty work with idle bubbles.
+            double peak = util;
+            engine->getHistory().read(engine_history, engine_window_samples);
+            for (const EngineSample &sample : engine_history) {
+              peak = std::max(peak, (double)sample.utilization);
+            }
+
+            history_values.clear();
+            if (auto history = device->getEngineHistory(i)) {
+              history->read(history_values, 24);
+            }
+
             engine_detail.push_back(hbox(
                 {notflex(text(engine_type_to_str(
                              engine->getEngineProperties()->type)) |
@@ -729,6 +1698,17 @@ int main(int argc, char *argv[]) {
                          size(WIDTH, EQUAL, 5) |
                          color(get_percentage_color(util))),
                  separator(),
+                 notflex(text(" " + std::to_string((int)peak) + "%") |
+                         size(WIDTH, EQUAL, 6) |
+                         color(get_percentage_color(peak))),
+                 separator(),
+                 notflex(text(sparkline(history_values, 24, 0.0, 100.0)) |
+                         size(WIDTH, EQUAL, 24) |
+                         color(get_percentage_color(util))),
+                 separator(),
+                 notflex(text(window_quantiles(snapshot->engineStatistics, i)) |
+                         size(WIDTH, EQUAL, 18) | color(Color::White)),
+                 separator(),
                  notflex(text(engine->getEngineProperties()->onSubdevice
                                   ? std::to_string(engine->getEngineProperties()
                                                        ->subdeviceId)
@@ -748,53 +1728,90 @@ int main(int argc, char *argv[]) {
 
         case ViewMode::PROCESSES: {
           Elements process_detail;
-          process_detail.push_back(
-              hbox({notflex(text("PID") | bold | size(WIDTH, EQUAL, 8)),
-                    separator(),
-                    notflex(text("COMMAND") | bold | size(WIDTH, EQUAL, 30)),
-                    separator(),
-                    notflex(text("MEMORY") | bold | size(WIDTH, EQUAL, 12)),
-                    separator(),
-                    notflex(text("SHARED") | bold | size(WIDTH, EQUAL, 12)),
-                    separator(),
-                    notflex(text("ENGINES") | bold | size(WIDTH, EQUAL, 15))}) |
-              color(Color::White));
+          Elements process_header = {
+              notflex(text("PID") | bold | size(WIDTH, EQUAL, 8)),
+              separator(),
+              notflex(text("COMMAND") | bold | size(WIDTH, EQUAL, 30)),
+              separator(),
+              notflex(text("MEMORY") | bold | size(WIDTH, EQUAL, 12)),
+              separator(),
+              notflex(text("SHARED") | bold | size(WIDTH, EQUAL, 12)),
+              separator(),
+              notflex(text("VRAM") | bold | size(WIDTH, EQUAL, 12)),
+              separator(),
+              notflex(text("ENGINES") | bold | size(WIDTH, EQUAL, 15)),
+              separator(),
+              notflex(text("ENERGY") | bold | size(WIDTH, EQUAL, 9))};
+          // Per engine class utilization from DRM fdinfo.
+          for (int c = 0; c < DRM_ENGINE_CLASS_COUNT; ++c) {
+            process_header.push_back(separator());
+            process_header.push_back(
+                notflex(text(drm_engine_class_to_str(c)) | bold |
+                        size(WIDTH, EQUAL, 5)));
+          }
+          process_detail.push_back(hbox(std::move(process_header)) |
+                                   color(Color::White));
 
           int visible_processes = 15;
           int start = state.process_offset;
           int end = std::min(start + visible_processes,
-                             (int)device->getProcessCount());
+                             (int)snapshot->processes.size());
 
+          // Only the rows up to the bottom of the screen need ranking.
+          select_top_processes(snapshot->processes, state.process_sort,
+                               std::max(end, 0), process_order);
           for (int i = start; i < end; ++i) {
-            auto proc = device->getProcessInfo(i);
+            const ProcessSample &proc = snapshot->processes[process_order[i]];
             auto mem_pct =
-                mem.size > 0
-                    ? (double)proc->getProcessState()->memSize / mem.size * 100
-                    : 0.0;
-
-            process_detail.push_back(hbox(
-                {notflex(
-                     text(std::to_string(proc->getProcessState()->processId)) |
-                     size(WIDTH, EQUAL, 8) | color(Color::Yellow)),
-                 separator(),
-                 notflex(text(proc->getCommandLine()) | size(WIDTH, EQUAL, 30) |
-                         color(Color::White)),
-                 separator(),
-                 notflex(text(format_bytes(proc->getProcessState()->memSize)) |
-                         size(WIDTH, EQUAL, 12) |
-                         color(get_percentage_color(mem_pct))),
-                 separator(),
-                 notflex(
-                     text(format_bytes(proc->getProcessState()->sharedSize)) |
-                     size(WIDTH, EQUAL, 12) | color(Color::GrayDark)),
-                 separator(),
-                 notflex(text(engine_flags_to_str(
-                             proc->getProcessState()->engines)) |
-                         size(WIDTH, EQUAL, 15) | color(Color::Cyan))}));
+                mem.size > 0 ? (double)proc.used_memory / mem.size * 100 : 0.0;
+
+            Elements row = {
+                notflex(text(std::to_string(proc.pid)) |
+                        size(WIDTH, EQUAL, 8) | color(Color::Yellow)),
+                separator(),
+                notflex(text(proc.command_line) | size(WIDTH, EQUAL, 30) |
+                        color(Color::White)),
+                separator(),
+                notflex(text(format_bytes(proc.used_memory)) |
+                        size(WIDTH, EQUAL, 12) |
+                        color(get_percentage_color(mem_pct))),
+                separator(),
+                notflex(text(format_bytes(proc.shared_memory)) |
+                        size(WIDTH, EQUAL, 12) | color(Color::GrayDark)),
+                separator(),
+                notflex(text(proc.drm.valid
+                                 ? format_bytes(proc.drm.vramResident)
+                                 : "N/A") |
+                        size(WIDTH, EQUAL, 12) | color(Color::GrayDark)),
+                separator(),
+                notflex(text(engine_flags_to_str(proc.engines)) |
+                        size(WIDTH, EQUAL, 15) | color(Color::Cyan)),
+                separator(),
+                notflex(text(format_energy(proc.energy)) |
+                        size(WIDTH, EQUAL, 9) | color(Color::Yellow))};
+            for (int c = 0; c < DRM_ENGINE_CLASS_COUNT; ++c) {
+              float util = proc.drm.utilization[c];
+              row.push_back(separator());
+              row.push_back(notflex(
+                  text(proc.drm.valid && util >= 0
+                           ? std::to_string((int)util) + "%"
+                           : "-") |
+                  size(WIDTH, EQUAL, 5) |
+                  color(util >= 0 ? get_percentage_color(util)
+                                  : Color::GrayDark)));
+            }
+            process_detail.push_back(hbox(std::move(row)));
           }
 
           main_content.push_back(
-              vbox({text("📊 Process Details") | bold | color(Color::Green),
+              vbox({hbox({text(std::string("📊 Process Details by ") +
+                               process_sort_key_to_str(state.process_sort)) |
+                              bold | color(Color::Green),
+                          snapshot->idleEnergy >= 0
+                              ? text("  Idle energy: " +
+                                     format_energy(snapshot->idleEnergy)) |
+                                    color(Color::GrayDark)
+                              : text("")}),
                     vbox(std::move(process_detail))}) |
               border);
           break;
@@ -809,30 +1826,83 @@ int main(int argc, char *argv[]) {
                     text(" "),
                     text("STATUS") | bold | size(WIDTH, LESS_THAN, 15),
                     text(" "),
+                    text("TREND") | bold | size(WIDTH, EQUAL, 10),
+                    text(" "),
+                    text("THROTTLE IN") | bold | size(WIDTH, EQUAL, 11),
+                    text(" "),
                     text("GRAPH") | bold | size(WIDTH, LESS_THAN, 30)}) |
               color(Color::White));
 
-          for (uint32_t i = 0; i < device->getTemperatureCount(); ++i) {
-            auto temp = device->getTemperature(i);
-            auto status = temp < 80 ? "NORMAL" : temp < 90 ? "WARM" : "HOT";
-            auto status_color = temp < 80   ? Color::Green
-                                : temp < 90 ? Color::Yellow
-                                            : Color::Red;
-
-            // Simple temperature bar (0-100°C scale)
-            double temp_ratio = std::min(temp / 100.0, 1.0);
+          // Whatever is left of the row after the fixed columns and borders.
+          int graph_width = std::max(10, screen_width - 84);
+          const TemperatureMonitor *monitor = device->getTemperatureMonitor();
+          for (uint32_t i = 0; monitor != nullptr &&
+                               i < snapshot->temperatures.size() &&
+                               i < monitor->getSensorCount();
+               ++i) {
+            auto temp = snapshot->temperatures[i];
+            TemperatureSample sensor = i < snapshot->temperatureSensors.size()
+                                           ? snapshot->temperatureSensors[i]
+                                           : TemperatureSample{};
+            // Against the sensor's own limits rather than fixed cutoffs.
+            double warm = monitor->getWarmTemperature(i);
+            double throttle = monitor->getThrottleTemperature(i);
+            auto status = !sensor.valid     ? "ERROR"
+                          : temp < warm     ? "NORMAL"
+                          : temp < throttle ? "WARM"
+                                            : "HOT";
+            auto status_color = !sensor.valid     ? Color::GrayDark
+                                : temp < warm     ? Color::Green
+                                : temp < throttle ? Color::Yellow
+                                                  : Color::Red;
+            char trend[32];
+            snprintf(trend, sizeof(trend), "%+.1f°C/m", sensor.slope * 60);
+
+            // Scale to the range seen, but at least 10°C so sensor noise
+            // doesn't look like a swing.
+            history_values.clear();
+            if (auto history = device->getTemperatureHistory(i)) {
+              history->read(history_values, graph_width);
+            }
+            double lo = temp, hi = temp;
+            for (double value : history_values) {
+              lo = std::min(lo, value);
+              hi = std::max(hi, value);
+            }
+            hi = std::max(hi, lo + 10.0);
 
             thermal_detail.push_back(hbox(
-                {text("Sensor " + std::to_string(i + 1)) |
-                     size(WIDTH, LESS_THAN, 15) | color(Color::Cyan),
+                {text(sensor_label(monitor, i)) | size(WIDTH, LESS_THAN, 15) |
+                     color(Color::Cyan),
                  separator(),
-                 text(std::to_string((int)temp) + "°C") |
+                 text(std::to_string((int)temp) + "°C / " +
+                      std::to_string((int)throttle) + "°C") |
                      size(WIDTH, LESS_THAN, 20) | color(get_temp_color(temp)),
                  separator(),
                  text(status) | size(WIDTH, LESS_THAN, 15) |
                      color(status_color),
                  separator(),
-                 xflex_grow(gauge(temp_ratio) | color(get_temp_color(temp)))}));
+                 text(trend) | size(WIDTH, EQUAL, 10) |
+                     color(sensor.slope > 0 ? Color::Yellow : Color::GrayDark),
+                 separator(),
+                 text(format_time_to_throttle(sensor.timeToThrottle)) |
+                     size(WIDTH, EQUAL, 11) |
+                     color(sensor.timeToThrottle < 0    ? Color::GrayDark
+                           : sensor.timeToThrottle < 60 ? Color::Red
+                                                        : Color::Yellow),
+                 separator(),
+                 xflex_grow(text(sparkline(history_values, graph_width, lo, hi)) |
+                            color(get_temp_color(temp)))}));
+          }
+
+          for (size_t i = 0; i < snapshot->fans.size(); ++i) {
+            thermal_detail.push_back(
+                hbox({text("Fan " + std::to_string(i + 1)) |
+                          size(WIDTH, LESS_THAN, 15) | color(Color::Cyan),
+                      separator(),
+                      text(format_fan_speed(snapshot->fans[i])) |
+                          color(snapshot->fans[i].speed < 0 ? Color::GrayDark
+                                                            : Color::White)}));
           }
 
           main_content.push_back(
@@ -846,26 +1916,73 @@ int main(int argc, char *argv[]) {
           Elements power_detail;
           power_detail.push_back(
               hbox({text("DOMAIN") | bold | size(WIDTH, EQUAL, 9), separator(),
-                    text("POWER") | bold | size(WIDTH, EQUAL, 5), separator(),
-                    text("ENERGY") | bold | size(WIDTH, EQUAL, 6), separator(),
+                    text("POWER") | bold | size(WIDTH, EQUAL, 7), separator(),
+                    text("ENERGY") | bold | size(WIDTH, EQUAL, 9), separator(),
+                    text("% SUS/BST/PK") | bold | size(WIDTH, EQUAL, 12),
+                    separator(),
                     text("CONTROL") | bold | size(WIDTH, EQUAL, 7), separator(),
-                    text("SUB-DEV") | bold | size(WIDTH, EQUAL, 10)}) |
+                    text("SUB-DEV") | bold | size(WIDTH, EQUAL, 10),
+                    separator(),
+                    text(stats_header + " W") | bold | size(WIDTH, EQUAL, 20),
+                    separator(), text("HISTORY") | bold | flex}) |
               color(Color::White));
 
-          for (uint32_t i = 0; i < device->getPowerDomainCount(); ++i) {
+          int power_graph_width = std::max(10, screen_width - 98);
+          for (uint32_t i = 0; i < snapshot->powerDomains.size(); ++i) {
             auto power_domain = device->getPowerDomain(i);
             auto properties = power_domain->getPowerDomainProperties();
-            auto energy = power_domain->getPowerDomainEnergy();
+            const PowerSample &sample = snapshot->powerDomains[i];
+            auto energy = sample.power;
+
+            // How close the domain runs to each of its caps; the sustained
+            // limit is the one a power-capped card lives against.
+            double headroom_pct = -1;
+            std::string limits_text;
+            for (zes_power_level_t level :
+                 {ZES_POWER_LEVEL_SUSTAINED, ZES_POWER_LEVEL_BURST,
+                  ZES_POWER_LEVEL_PEAK}) {
+              double limit = power_domain->getLimit(level);
+              if (!limits_text.empty()) {
+                limits_text += "/";
+              }
+              if (limit <= 0) {
+                limits_text += "-";
+                continue;
+              }
+              double pct = energy / limit * 100;
+              headroom_pct = std::max(headroom_pct, pct);
+              limits_text += std::to_string((int)std::lround(pct));
+            }
+            char power_text[16];
+            snprintf(power_text, sizeof(power_text), "%.1fW", energy);
+            char energy_text[16];
+            snprintf(energy_text, sizeof(energy_text), "%.3fWh",
+                     sample.sessionEnergy / 3600.0);
+
+            history_values.clear();
+            if (auto history = device->getPowerDomainHistory(i)) {
+              history->read(history_values, power_graph_width);
+            }
+            double peak_power = std::max(energy, 1.0);
+            for (double value : history_values) {
+              peak_power = std::max(peak_power, value);
+            }
 
             power_detail.push_back(hbox(
                 {text("Domain " + std::to_string(i + 1)) |
                      size(WIDTH, EQUAL, 9) | color(Color::Cyan),
                  separator(),
-                 text(energy >= 0 ? (std::to_string((int)energy) + "W")
-                                  : "N/A") |
-                     size(WIDTH, EQUAL, 5) | color(Color::Yellow),
+                 text(energy >= 0 ? power_text : "N/A") |
+                     size(WIDTH, EQUAL, 7) | color(Color::Yellow),
+                 separator(),
+                 text(energy_text) | size(WIDTH, EQUAL, 9) |
+                     color(Color::White),
                  separator(),
-                 text("N/A") | size(WIDTH, EQUAL, 6) | color(Color::GrayDark),
+                 text(limits_text) | size(WIDTH, EQUAL, 12) |
+                     color(headroom_pct < 0    ? Color::GrayDark
+                           : headroom_pct < 80 ? Color::Green
+                           : headroom_pct < 95 ? Color::Yellow
+                                               : Color::Red),
                  separator(),
                  text(properties->canControl ? "YES" : "NO") |
                      size(WIDTH, EQUAL, 7) |
@@ -874,18 +1991,26 @@ int main(int argc, char *argv[]) {
                  text(properties->onSubdevice
                           ? std::to_string(properties->subdeviceId)
                           : "N/A") |
-                     size(WIDTH, EQUAL, 10) | color(Color::GrayDark)}));
+                     size(WIDTH, EQUAL, 10) | color(Color::GrayDark),
+                 separator(),
+                 text(window_quantiles(snapshot->powerDomainStatistics, i)) |
+                     size(WIDTH, EQUAL, 20) | color(Color::White),
+                 separator(),
+                 xflex_grow(text(sparkline(history_values, power_graph_width,
+                                           0.0, peak_power)) |
+                            color(Color::Yellow))}));
           }
 
           // PSU information
-          if (device->getPSUCount() > 0) {
+          if (!snapshot->psuStates.empty()) {
             power_detail.push_back(separator());
             power_detail.push_back(text("Power Supply Units:") | bold |
                                    color(Color::White));
 
-            for (uint32_t i = 0; i < device->getPSUCount(); ++i) {
+            for (uint32_t i = 0; i < snapshot->psuStates.size(); ++i) {
               auto psu = device->getPSU(i);
               auto properties = psu->getPSUProperties();
+              const zes_psu_state_t &psu_state = snapshot->psuStates[i];
 
               power_detail.push_back(hbox(
                   {text("PSU " + std::to_string(i + 1)) |
@@ -897,7 +2022,9 @@ int main(int argc, char *argv[]) {
                    text("Limit: " + std::to_string(properties->ampLimit) +
                         "A") |
                        size(WIDTH, LESS_THAN, 15) | color(Color::Yellow),
-                   text("") | size(WIDTH, LESS_THAN, 10),
+                   text(std::to_string(psu_state.temperature) + "°C") |
+                       size(WIDTH, LESS_THAN, 10) |
+                       color(get_temp_color(psu_state.temperature)),
                    text(properties->onSubdevice
                             ? std::to_string(properties->subdeviceId)
                             : "N/A") |
@@ -911,6 +2038,161 @@ int main(int argc, char *argv[]) {
               border);
           break;
         }
+
+        case ViewMode::MEMORY: {
+          Elements memory_detail;
+          memory_detail.push_back(
+              hbox({text("MODULE") | bold | size(WIDTH, EQUAL, 18), separator(),
+                    text("USAGE") | bold | flex, separator(),
+                    text("USED / TOTAL") | bold | size(WIDTH, EQUAL, 23),
+                    separator(),
+                    text("HEALTH") | bold | size(WIDTH, EQUAL, 9), separator(),
+                    text("READ") | bold | size(WIDTH, EQUAL, 11), separator(),
+                    text("WRITE") | bold | size(WIDTH, EQUAL, 11), separator(),
+                    text("BW %") | bold | size(WIDTH, EQUAL, 5)}) |
+              color(Color::White));
+
+          for (uint32_t i = 0; i < snapshot->memoryModules.size(); ++i) {
+            const MemorySample &sample = snapshot->memoryModules[i];
+            auto properties = device->getMemoryModule(i)->getMemoryProperties();
+            double used_pct =
+                sample.state.size > 0
+                    ? (double)(sample.state.size - sample.state.free) /
+                          sample.state.size * 100
+                    : 0.0;
+            bool healthy = sample.state.health == ZES_MEM_HEALTH_OK ||
+                           sample.state.health == ZES_MEM_HEALTH_UNKNOWN;
+            // Share of the module's peak bandwidth in use, read and write
+            // combined.
+            double bw_pct =
+                sample.maxBandwidth > 0
+                    ? std::min((sample.readBandwidth + sample.writeBandwidth) /
+                                   sample.maxBandwidth * 100,
+                               100.0)
+                    : 0.0;
+            bool have_bandwidth =
+                device->getMemoryModule(i)->isBandwidthSupported();
+
+            memory_detail.push_back(hbox(
+                {notflex(text(ellipses(mem_type_to_str(properties->type), 18,
+                                       true)) |
+                         size(WIDTH, EQUAL, 18) | color(Color::Cyan)),
+                 separator(),
+                 xflex_grow(gauge(used_pct / 100.0) |
+                            color(get_percentage_color(used_pct))),
+                 notflex(text(" " + std::to_string((int)used_pct) + "%") |
+                         size(WIDTH, EQUAL, 5) |
+                         color(get_percentage_color(used_pct))),
+                 separator(),
+                 notflex(text(format_bytes(sample.state.size -
+                                           sample.state.free) +
+                              " / " + format_bytes(sample.state.size)) |
+                         size(WIDTH, EQUAL, 23) | color(Color::White)),
+                 separator(),
+                 notflex(text(mem_health_to_str(sample.state.health)) |
+                         size(WIDTH, EQUAL, 9) |
+                         color(healthy ? Color::Green : Color::Red)),
+                 separator(),
+                 notflex(text(have_bandwidth ? format_bandwidth(sample.readBandwidth)
+                                             : "N/A") |
+                         size(WIDTH, EQUAL, 11) | color(Color::Yellow)),
+                 separator(),
+                 notflex(text(have_bandwidth ? format_bandwidth(sample.writeBandwidth)
+                                             : "N/A") |
+                         size(WIDTH, EQUAL, 11) | color(Color::Yellow)),
+                 separator(),
+                 notflex(text(sample.maxBandwidth > 0
+                                  ? std::to_string((int)bw_pct) + "%"
+                                  : "N/A") |
+                         size(WIDTH, EQUAL, 5) |
+                         color(get_percentage_color(bw_pct)))}));
+          }
+
+          if (snapshot->memoryModules.empty()) {
+            memory_detail.push_back(text("No memory modules exposed") |
+                                    color(Color::GrayDark));
+          }
+
+          main_content.push_back(
+              vbox({text("💾 Memory") | bold | color(Color::Green),
+                    vbox(std::move(memory_detail))}) |
+              border);
+          break;
+        }
+
+        case ViewMode::FREQUENCY: {
+          Elements frequency_detail;
+          frequency_detail.push_back(
+              hbox({text("DOMAIN") | bold | size(WIDTH, EQUAL, 8), separator(),
+                    text("ACTUAL") | bold | flex, separator(),
+                    text("REQUEST") | bold | size(WIDTH, EQUAL, 9),
+                    separator(),
+                    text("EFFICIENT") | bold | size(WIDTH, EQUAL, 9),
+                    separator(),
+                    text("TDP") | bold | size(WIDTH, EQUAL, 9), separator(),
+                    text("THROTTLED") | bold | size(WIDTH, EQUAL, 9),
+                    separator(),
+                    text("REASONS") | bold | size(WIDTH, EQUAL, 24),
+                    separator(),
+                    text("SUB-DEV") | bold | size(WIDTH, EQUAL, 7)}) |
+              color(Color::White));
+
+          for (uint32_t i = 0; i < snapshot->frequencyDomains.size(); ++i) {
+            const FrequencySample &sample = snapshot->frequencyDomains[i];
+            auto properties =
+                device->getFrequencyDomain(i)->getFrequencyProperties();
+            // How far up its range the domain is currently clocked.
+            double actual_pct =
+                properties->max > 0 && sample.state.actual >= 0
+                    ? std::min(sample.state.actual / properties->max * 100,
+                               100.0)
+                    : 0.0;
+            double throttled_pct = sample.throttleFraction * 100;
+
+            frequency_detail.push_back(hbox(
+                {notflex(text(freq_domain_to_str(properties->type)) |
+                         size(WIDTH, EQUAL, 8) | color(Color::Cyan)),
+                 separator(),
+                 xflex_grow(gauge(actual_pct / 100.0) | color(Color::Cyan)),
+                 notflex(text(" " + format_mhz(sample.state.actual)) |
+                         size(WIDTH, EQUAL, 10) | color(Color::White)),
+                 separator(),
+                 notflex(text(format_mhz(sample.state.request)) |
+                         size(WIDTH, EQUAL, 9) | color(Color::GrayDark)),
+                 separator(),
+                 notflex(text(format_mhz(sample.state.efficient)) |
+                         size(WIDTH, EQUAL, 9) | color(Color::GrayDark)),
+                 separator(),
+                 notflex(text(format_mhz(sample.state.tdp)) |
+                         size(WIDTH, EQUAL, 9) | color(Color::GrayDark)),
+                 separator(),
+                 notflex(text(std::to_string((int)std::round(throttled_pct)) +
+                              "%") |
+                         size(WIDTH, EQUAL, 9) |
+                         color(get_throttle_color(throttled_pct))),
+                 separator(),
+                 notflex(text(ellipses(
+                             throttle_reasons_to_str(sample.state.throttleReasons),
+                             24)) |
+                         size(WIDTH, EQUAL, 24) | color(Color::Red)),
+                 separator(),
+                 notflex(text(properties->onSubdevice
+                                  ? std::to_string(properties->subdeviceId)
+                                  : "N/A") |
+                         size(WIDTH, EQUAL, 7) | color(Color::GrayDark))}));
+          }
+
+          if (snapshot->frequencyDomains.empty()) {
+            frequency_detail.push_back(text("No frequency domains exposed") |
+                                       color(Color::GrayDark));
+          }
+
+          main_content.push_back(
+              vbox({text("⏱️  Frequency") | bold | color(Color::Green),
+                    vbox(std::move(frequency_detail))}) |
+              border);
+          break;
+        }
         }
 
         // Key hints
@@ -918,16 +2200,21 @@ int main(int argc, char *argv[]) {
         if (state.show_help) {
           key_hints = {
               text("📋 Key Bindings:") | bold | color(Color::White),
-              hbox({text("1-5") | color(Color::Yellow),
+              hbox({text("1-7") | color(Color::Yellow),
                     text(": Switch views  ") | color(Color::GrayDark),
                     text("↑↓") | color(Color::Yellow),
                     text(": Scroll  ") | color(Color::GrayDark),
+                    text("w") | color(Color::Yellow),
+                    text(": Stats window  ") | color(Color::GrayDark),
+                    text("s") | color(Color::Yellow),
+                    text(": Sort processes  ") | color(Color::GrayDark),
                     text("h") | color(Color::Yellow),
                     text(": Toggle help  ") | color(Color::GrayDark),
                     text("q/ESC") | color(Color::Yellow),
                     text(": Quit") | color(Color::GrayDark)}),
               text(
-                  "Views: 1=Overview 2=Engines 3=Processes 4=Power 5=Thermal") |
+                  "Views: 1=Overview 2=Engines 3=Processes 4=Power 5=Thermal "
+                  "6=Memory 7=Frequency") |
                   color(Color::GrayDark)};
         } else {
           key_hints = {hbox({text("Views: ") | color(Color::GrayDark),
@@ -941,6 +2228,10 @@ int main(int argc, char *argv[]) {
                              text("=Power ") | color(Color::GrayDark),
                              text("5") | color(Color::Yellow),
                              text("=Thermal ") | color(Color::GrayDark),
+                             text("6") | color(Color::Yellow),
+                             text("=Memory ") | color(Color::GrayDark),
+                             text("7") | color(Color::Yellow),
+                             text("=Frequency ") | color(Color::GrayDark),
                              text("| ") | color(Color::GrayDark),
                              text("↑↓") | color(Color::Yellow),
                              text("=Scroll ") | color(Color::GrayDark),
@@ -971,19 +2262,25 @@ int main(int argc, char *argv[]) {
       CatchEvent([&](Event event) {
         // View switching
         if (event == Event::Character('1')) {
-          state.view_mode = ViewMode::OVERVIEW;
+          switch_view(ViewMode::OVERVIEW);
           return true;
         } else if (event == Event::Character('2')) {
-          state.view_mode = ViewMode::ENGINES;
+          switch_view(ViewMode::ENGINES);
           return true;
         } else if (event == Event::Character('3')) {
-          state.view_mode = ViewMode::PROCESSES;
+          switch_view(ViewMode::PROCESSES);
           return true;
         } else if (event == Event::Character('4')) {
-          state.view_mode = ViewMode::POWER;
+          switch_view(ViewMode::POWER);
           return true;
         } else if (event == Event::Character('5')) {
-          state.view_mode = ViewMode::THERMAL;
+          switch_view(ViewMode::THERMAL);
+          return true;
+        } else if (event == Event::Character('6')) {
+          switch_view(ViewMode::MEMORY);
+          return true;
+        } else if (event == Event::Character('7')) {
+          switch_view(ViewMode::FREQUENCY);
           return true;
         }
 
@@ -1009,7 +2306,8 @@ int main(int argc, char *argv[]) {
         } else if (event == Event::ArrowDown) {
           switch (state.view_mode) {
           case ViewMode::PROCESSES: {
-            int max_offset = std::max(0, (int)device->getProcessCount() - 15);
+            int max_offset =
+                std::max(0, (int)device->getSnapshot()->processes.size() - 15);
             state.process_offset =
                 std::min(max_offset, state.process_offset + 1);
             break;
@@ -1038,6 +2336,20 @@ int main(int argc, char *argv[]) {
           return true;
         }
 
+        // Cycle the column processes are sorted by
+        else if (event == Event::Character('s') ||
+                 event == Event::Character('S')) {
+          state.process_sort = next_process_sort_key(state.process_sort);
+          return true;
+        }
+
+        // Cycle the window shown in the STATS columns
+        else if (event == Event::Character('w') ||
+                 event == Event::Character('W')) {
+          state.stats_window = (state.stats_window + 1) % stats_windows.size();
+          return true;
+        }
+
         // Help toggle
         else if (event == Event::Character('h') ||
                  event == Event::Character('H')) {
@@ -1130,14 +2442,16 @@ int main(int argc, char *argv[]) {
         return false;
       });
 
-  // Auto-refresh component
-  std::thread refresh_thread([&]() {
-    while (true) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-      screen.PostEvent(Event::Custom);
-    }
-  });
-  refresh_thread.detach();
+  // Every published sample triggers a redraw.
+  sampler.start([&]() { screen.PostEvent(Event::Custom); });
+  events.start(
+      [&sampler](Device *, zes_event_type_flags_t flags) {
+        sampler.requestSample(event_components(flags));
+      },
+      [&sampler, &polled]() { sampler.setSchedule(polled); });
+  if (startupProfile) {
+    StartupProfile::instance().report(stderr);
+  }
 
   // Ensure we capture the final frame when exiting. Wrap the Loop with
   // a restored-IO closure so printing the frame doesn't interfere with
@@ -1176,5 +2490,10 @@ int main(int argc, char *argv[]) {
     screen.Loop(component);
   }
 
+  // The listener calls into the sampler, so it has to stop first.
+  events.stop();
+  sampler.stop();
+  show_process_energy(device);
+
   return 0;
 }
\ No newline at end of file
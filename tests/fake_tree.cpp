@@ -0,0 +1,97 @@
+#include "fake_tree.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+FakeSystemTree::FakeSystemTree() {
+    char pattern[] = "/tmp/ze-monitor-treeXXXXXX";
+    root = mkdtemp(pattern);
+    fs::create_directories(root / "proc");
+    fs::create_directories(root / "sys" / "class" / "drm");
+}
+
+FakeSystemTree::~FakeSystemTree() {
+    std::error_code error;
+    fs::remove_all(root, error);
+}
+
+void FakeSystemTree::addProcess(uint32_t pid, const std::string &comm, const std::string &cmdline, uint64_t startTime) {
+    fs::path dir = root / "proc" / std::to_string(pid);
+    fs::create_directories(dir / "fd");
+    fs::create_directories(dir / "fdinfo");
+
+    // Fields 3-21 of stat don't matter here; starttime is field 22.
+    std::string stat = std::to_string(pid) + " (" + comm + ") S";
+    for (int field = 4; field < 22; ++field) {
+        stat += " 0";
+    }
+    stat += " " + std::to_string(startTime) + " 0 0\n";
+    std::ofstream(dir / "stat") << stat;
+    std::ofstream(dir / "comm") << comm << "\n";
+    std::string args = cmdline;
+    for (char &c : args) {
+        if (c == ' ')
+            c = '\0';
+    }
+    std::ofstream(dir / "cmdline", std::ios::binary) << args << '\0';
+}
+
+void FakeSystemTree::addFd(uint32_t pid, int fd, const std::string &target, const std::string &fdinfo) {
+    fs::path dir = root / "proc" / std::to_string(pid);
+    fs::create_directories(dir / "fd");
+    fs::create_directories(dir / "fdinfo");
+    fs::create_symlink(target, dir / "fd" / std::to_string(fd));
+    setFdinfo(pid, fd, fdinfo.empty() ? "pos:\t0\nflags:\t02\n" : fdinfo);
+}
+
+void FakeSystemTree::setFdinfo(uint32_t pid, int fd, const std::string &fdinfo) {
+    std::ofstream(root / "proc" / std::to_string(pid) / "fdinfo" / std::to_string(fd), std::ios::trunc) << fdinfo;
+}
+
+void FakeSystemTree::closeFd(uint32_t pid, int fd) {
+    fs::remove(root / "proc" / std::to_string(pid) / "fd" / std::to_string(fd));
+    fs::remove(root / "proc" / std::to_string(pid) / "fdinfo" / std::to_string(fd));
+}
+
+std::string FakeSystemTree::gpuAddress(uint32_t index) {
+    char address[16];
+    snprintf(address, sizeof(address), "0000:%02x:00.0", index + 3);
+    return address;
+}
+
+void FakeSystemTree::addGpu(uint32_t index, uint32_t vendor, uint32_t device) {
+    std::string node = "renderD" + std::to_string(128 + index);
+    fs::path pci = root / "sys" / "devices" / "pci0000:00" / gpuAddress(index);
+    fs::create_directories(pci / "drm" / node);
+    char id[8];
+    snprintf(id, sizeof(id), "0x%04x", vendor);
+    std::ofstream(pci / "vendor") << id << "\n";
+    snprintf(id, sizeof(id), "0x%04x", device);
+    std::ofstream(pci / "device") << id << "\n";
+    fs::create_symlink("../../devices/pci0000:00/" + gpuAddress(index) + "/drm/" + node,
+                       root / "sys" / "class" / "drm" / node);
+}
+
+std::string FakeSystemTree::drmFdinfo(uint64_t client, uint64_t renderTime, const std::string &pdev) {
+    return "pos:\t0\nflags:\t02100002\ndrm-driver:\ti915\ndrm-client-id:\t" + std::to_string(client) +
+           "\ndrm-pdev:\t" + pdev + "\ndrm-engine-render:\t" + std::to_string(renderTime) +
+           " ns\ndrm-engine-copy:\t0 ns\ndrm-memory-local0:\t64 MiB\n";
+}
+
+void FakeSystemTree::populate(uint32_t processes, uint32_t gpus, uint32_t firstPid) {
+    for (uint32_t gpu = 0; gpu < gpus; ++gpu) {
+        addGpu(gpu, 0x8086, 0xe20b);
+    }
+    for (uint32_t i = 0; i < processes; ++i) {
+        uint32_t pid = firstPid + i;
+        uint32_t gpu = gpus ? i % gpus : 0;
+        addProcess(pid, "worker", "/usr/bin/worker --rank " + std::to_string(i), 100 + i);
+        for (int fd = 0; fd < 3; ++fd) {
+            addFd(pid, fd, "/dev/pts/0");
+        }
+        addFd(pid, 3, "socket:[" + std::to_string(20000 + i) + "]");
+        addFd(pid, 4, "/dev/dri/renderD" + std::to_string(128 + gpu), drmFdinfo(i + 1, 0, gpuAddress(gpu)));
+    }
+}
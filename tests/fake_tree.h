@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+// A throwaway /proc and /sys under a temporary directory, holding just the
+// entries ze-monitor reads: per-process stat, comm, cmdline, fd and fdinfo,
+// and DRM render nodes with the PCI device behind them. Point a collector's
+// root (or SystemPaths) at procRoot() and sysRoot() to run it on a machine
+// without a GPU.
+class FakeSystemTree {
+public:
+    FakeSystemTree();
+    ~FakeSystemTree();
+    FakeSystemTree(const FakeSystemTree &) = delete;
+    FakeSystemTree &operator=(const FakeSystemTree &) = delete;
+
+    std::string procRoot() const { return (root / "proc").string(); }
+    std::string sysRoot() const { return (root / "sys").string(); }
+
+    void addProcess(uint32_t pid, const std::string &comm, const std::string &cmdline, uint64_t startTime);
+    // fd is a symlink to target; fdinfo defaults to a non-DRM entry.
+    void addFd(uint32_t pid, int fd, const std::string &target, const std::string &fdinfo = "");
+    // Rewritten in place, as collectors keep fdinfo files open.
+    void setFdinfo(uint32_t pid, int fd, const std::string &fdinfo);
+    void closeFd(uint32_t pid, int fd);
+
+    // GPU index at PCI address gpuAddress(index), with render node
+    // renderD<128 + index>.
+    void addGpu(uint32_t index, uint32_t vendor, uint32_t device);
+    static std::string gpuAddress(uint32_t index);
+
+    // i915-style fdinfo for one DRM client.
+    static std::string drmFdinfo(uint64_t client, uint64_t renderTime, const std::string &pdev = gpuAddress(0));
+
+    // gpus GPUs and processes processes starting at PID firstPid, each with
+    // stdio, a socket and a render node of one of the GPUs open.
+    void populate(uint32_t processes, uint32_t gpus, uint32_t firstPid = 1000);
+
+private:
+    std::filesystem::path root;
+};
@@ -0,0 +1,75 @@
+#include <catch2/catch_all.hpp>
+#include "src/energy_attribution.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+using std::chrono::seconds;
+
+TEST_CASE("Energy attribution to processes", "[energy]") {
+    auto start = std::chrono::steady_clock::now();
+    std::string render = "render", encode = "encode";
+
+    SECTION("Idle power is kept separate and the rest shared by activity") {
+        EnergyAttribution attribution;
+        attribution.attribute(0, start, {});
+        // 20W with nothing running sets the idle power.
+        attribution.attribute(20, start + seconds(1), {});
+        REQUIRE(attribution.getIdlePower() == Catch::Approx(20.0));
+        REQUIRE(attribution.getIdleEnergy() == Catch::Approx(20.0));
+
+        // 100W: 20W is idle, 80W split 3:1.
+        attribution.attribute(120, start + seconds(2),
+                              {{100, 1, 75.0, &render}, {200, 2, 25.0, &encode}, {300, 3, 0.0, &encode}});
+        REQUIRE(attribution.getIdleEnergy() == Catch::Approx(40.0));
+        REQUIRE(attribution.getProcessEnergy(100, 1) == Catch::Approx(60.0));
+        REQUIRE(attribution.getProcessEnergy(200, 2) == Catch::Approx(20.0));
+        REQUIRE(attribution.getProcessEnergy(300, 3) == 0.0);
+        REQUIRE(attribution.getAttributedEnergy() == Catch::Approx(80.0));
+    }
+
+    SECTION("Totals accumulate and outlive the process") {
+        EnergyAttribution attribution;
+        attribution.attribute(0, start, {});
+        attribution.attribute(10, start + seconds(1), {});
+        attribution.attribute(60, start + seconds(2), {{100, 1, 1.0, &render}});
+        attribution.attribute(110, start + seconds(3), {{100, 1, 1.0, &render}, {200, 2, 1.0, &encode}});
+        // Process 100 has exited.
+        attribution.attribute(160, start + seconds(4), {{200, 2, 1.0, &encode}});
+
+        std::vector<EnergyAttribution::Total> totals = attribution.getTotals();
+        REQUIRE(totals.size() == 2);
+        REQUIRE(totals[0].pid == 100);
+        REQUIRE(totals[0].name == "render");
+        REQUIRE(totals[0].energy == Catch::Approx(60.0));
+        REQUIRE(totals[1].pid == 200);
+        REQUIRE(totals[1].energy == Catch::Approx(60.0));
+        REQUIRE(attribution.getIdleEnergy() + attribution.getAttributedEnergy() == Catch::Approx(160.0));
+    }
+
+    SECTION("Energy that updates less often than processes covers the whole interval") {
+        EnergyAttribution attribution;
+        auto quarter = std::chrono::milliseconds(250);
+        attribution.attribute(0, start, {});
+        // Processes are sampled every 250ms, energy only moves every second.
+        attribution.attribute(0, start + quarter, {{100, 1, 1.0, &render}});
+        attribution.attribute(0, start + 2 * quarter, {{100, 1, 1.0, &render}});
+        attribution.attribute(0, start + 3 * quarter, {{100, 1, 1.0, &render}});
+        attribution.attribute(20, start + seconds(1), {});
+        REQUIRE(attribution.getIdlePower() == Catch::Approx(20.0));
+
+        attribution.attribute(20, start + seconds(1) + quarter, {{100, 1, 1.0, &render}});
+        attribution.attribute(120, start + seconds(2), {{100, 1, 1.0, &render}});
+        REQUIRE(attribution.getIdlePower() == Catch::Approx(20.0));
+        REQUIRE(attribution.getProcessEnergy(100, 1) == Catch::Approx(80.0));
+    }
+
+    SECTION("A reused PID starts from zero") {
+        EnergyAttribution attribution;
+        attribution.attribute(0, start, {});
+        attribution.attribute(50, start + seconds(1), {{100, 1, 1.0, &render}});
+        attribution.attribute(100, start + seconds(2), {{100, 2, 1.0, &render}});
+        REQUIRE(attribution.getProcessEnergy(100, 2) == Catch::Approx(attribution.getProcessEnergy(100, 1)));
+        REQUIRE(attribution.getTotals().size() == 2);
+    }
+}
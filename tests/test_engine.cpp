@@ -0,0 +1,98 @@
+#include <catch2/catch_all.hpp>
+#include "src/engine.h"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "ze_mock.h"
+
+namespace {
+zes_engine_stats_t stats(uint64_t activeTime, uint64_t timestamp) {
+    zes_engine_stats_t value = {};
+    value.activeTime = activeTime;
+    value.timestamp = timestamp;
+    return value;
+}
+
+void update(Engine &engine, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        engine.updateStats();
+    }
+}
+} // namespace
+
+TEST_CASE("Engine utilization", "[engine]") {
+    zes_engine_handle_t handle = reinterpret_cast<zes_engine_handle_t>(1);
+
+    SECTION("Utilization is computed in floating point") {
+        resetMocks();
+        // 1/3 busy: integer division used to truncate this to 33.
+        g_mockEngineStats = {stats(0, 0), stats(1, 3)};
+        Engine engine(handle);
+        update(engine, 1);
+        REQUIRE(engine.getEngineUtilization() == Catch::Approx(100.0 / 3.0));
+    }
+
+    SECTION("Counter wrap is handled") {
+        resetMocks();
+        g_mockEngineStats = {stats(UINT64_MAX - 99, UINT64_MAX - 999), stats(400, 9000)};
+        Engine engine(handle);
+        update(engine, 1);
+        REQUIRE(engine.getEngineUtilization() == Catch::Approx(5.0));
+    }
+
+    SECTION("Counter resets are dropped instead of reported") {
+        resetMocks();
+        g_mockEngineStats = {stats(0, 0), stats(500, 1000), stats(10, 1100), stats(60, 1200)};
+        Engine engine(handle);
+        update(engine, 1);
+        REQUIRE(engine.getEngineUtilization() == Catch::Approx(50.0));
+        update(engine, 1); // activeTime went backwards
+        REQUIRE(engine.getEngineUtilization() == Catch::Approx(50.0));
+        REQUIRE(engine.getHistory().getCount() == 1);
+        update(engine, 1);
+        REQUIRE(engine.getEngineUtilization() == Catch::Approx(50.0));
+        REQUIRE(engine.getHistory().getCount() == 2);
+    }
+
+    SECTION("Slightly over 100% is clamped") {
+        resetMocks();
+        g_mockEngineStats = {stats(0, 0), stats(1010, 1000)};
+        Engine engine(handle);
+        update(engine, 1);
+        REQUIRE(engine.getEngineUtilization() == Catch::Approx(100.0));
+    }
+
+    SECTION("Fast samples are kept and decimated to the display window") {
+        resetMocks();
+        // 10ms samples alternating fully busy and idle.
+        for (uint64_t i = 0; i <= 10; ++i) {
+            g_mockEngineStats.push_back(stats(((i + 1) / 2) * 10000, i * 10000));
+        }
+        Engine engine(handle);
+        engine.setDecimation(std::chrono::milliseconds(50), 1.0);
+
+        update(engine, 4);
+        REQUIRE(engine.getEngineUtilization() == 0.0); // window not complete
+        update(engine, 1);
+        REQUIRE(engine.getEngineUtilization() == Catch::Approx(60.0));
+        update(engine, 5);
+        REQUIRE(engine.getEngineUtilization() == Catch::Approx(40.0));
+
+        std::vector<EngineSample> history;
+        REQUIRE(engine.getHistory().read(history) == 10);
+        REQUIRE(history.front().utilization == Catch::Approx(100.0));
+        REQUIRE(history[1].utilization == Catch::Approx(0.0));
+        REQUIRE(history.back().timestamp == 100000);
+    }
+
+    SECTION("EWMA smoothing across windows") {
+        resetMocks();
+        g_mockEngineStats = {stats(0, 0), stats(1000, 1000), stats(1000, 2000)};
+        Engine engine(handle);
+        engine.setDecimation(std::chrono::microseconds(0), 0.25);
+        update(engine, 1);
+        REQUIRE(engine.getEngineUtilization() == Catch::Approx(100.0));
+        update(engine, 1);
+        REQUIRE(engine.getEngineUtilization() == Catch::Approx(75.0));
+    }
+}
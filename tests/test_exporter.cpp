@@ -0,0 +1,171 @@
+#include <catch2/catch_all.hpp>
+#include "src/exporter.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+namespace {
+DeviceLabels makeLabels() {
+    DeviceLabels labels;
+    labels.uuid = "00000000-0000-0000-0000-000000000001";
+    labels.bdf = "0000:03:00.0";
+    labels.model = "Test \"GPU\"";
+    labels.engines = {{"ZES_ENGINE_GROUP_COMPUTE_ALL", -1}, {"ZES_ENGINE_GROUP_COPY_ALL", 1}};
+    labels.powerDomains = {{"", -1}};
+    labels.temperatures = {{"GPU", 0}, {"MEMORY", 0}};
+    return labels;
+}
+
+DeviceSnapshot makeSnapshot() {
+    DeviceSnapshot snapshot;
+    snapshot.components = COMPONENT_ENGINES | COMPONENT_POWER | COMPONENT_THERMAL;
+    snapshot.engineUtilization = {50.0, 0.0};
+    PowerSample power;
+    power.power = 120.5;
+    power.sessionEnergy = 1000;
+    snapshot.powerDomains = {power};
+    snapshot.temperatures = {60.0, 70.0};
+    snapshot.temperatureSensors.resize(2);
+    snapshot.temperatureSensors[0].valid = true;
+    snapshot.temperatureSensors[1].valid = false;
+    return snapshot;
+}
+
+// Send request to the exporter on localhost and return everything it
+// answers with.
+std::string fetch(uint16_t port, const std::string &request) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    REQUIRE(connect(fd, (struct sockaddr *)&address, sizeof(address)) == 0);
+    REQUIRE(write(fd, request.data(), request.size()) == (ssize_t)request.size());
+
+    std::string response;
+    char buffer[4096];
+    ssize_t count;
+    while ((count = read(fd, buffer, sizeof(buffer))) > 0) {
+        response.append(buffer, count);
+    }
+    close(fd);
+    return response;
+}
+} // namespace
+
+TEST_CASE("Listen addresses", "[exporter]") {
+    std::string host;
+    uint16_t port = 0;
+
+    REQUIRE(parse_listen_address(":9100", host, port));
+    REQUIRE(host.empty());
+    REQUIRE(port == 9100);
+
+    REQUIRE(parse_listen_address("127.0.0.1:8080", host, port));
+    REQUIRE(host == "127.0.0.1");
+    REQUIRE(port == 8080);
+
+    REQUIRE(parse_listen_address("[::1]:9100", host, port));
+    REQUIRE(host == "::1");
+
+    REQUIRE_FALSE(parse_listen_address("9100", host, port));
+    REQUIRE_FALSE(parse_listen_address(":", host, port));
+    REQUIRE_FALSE(parse_listen_address(":0", host, port));
+    REQUIRE_FALSE(parse_listen_address(":65536", host, port));
+    REQUIRE_FALSE(parse_listen_address(":91x", host, port));
+    REQUIRE_FALSE(parse_listen_address("::1:9100", host, port));
+}
+
+TEST_CASE("Exposition text", "[exporter]") {
+    MetricsExporter exporter({makeLabels()});
+    DeviceSnapshot snapshot = makeSnapshot();
+    exporter.publish({&snapshot});
+    std::string metrics = exporter.getMetrics();
+    const std::string device = "uuid=\"00000000-0000-0000-0000-000000000001\",bdf=\"0000:03:00.0\"";
+
+    SECTION("Each family is described once") {
+        REQUIRE(metrics.find("# TYPE ze_engine_utilization_ratio gauge\n") != std::string::npos);
+        REQUIRE(metrics.find("# TYPE ze_energy_joules_total counter\n") != std::string::npos);
+        REQUIRE(metrics.find("# HELP ze_power_watts ") != std::string::npos);
+    }
+
+    SECTION("Samples carry the device, engine type and sub-device") {
+        REQUIRE(metrics.find("ze_device_info{" + device + ",model=\"Test \\\"GPU\\\"\"} 1\n") != std::string::npos);
+        REQUIRE(metrics.find("ze_engine_utilization_ratio{" + device +
+                             ",index=\"0\",type=\"ZES_ENGINE_GROUP_COMPUTE_ALL\"} 0.5\n") != std::string::npos);
+        REQUIRE(metrics.find("ze_engine_utilization_ratio{" + device +
+                             ",index=\"1\",type=\"ZES_ENGINE_GROUP_COPY_ALL\",subdevice=\"1\"} 0\n") !=
+                std::string::npos);
+        REQUIRE(metrics.find("ze_power_watts{" + device + ",index=\"0\"} 120.5\n") != std::string::npos);
+        REQUIRE(metrics.find("ze_energy_joules_total{" + device + ",index=\"0\"} 1000\n") != std::string::npos);
+    }
+
+    SECTION("Sensors that couldn't be read are left out") {
+        REQUIRE(metrics.find("ze_temperature_celsius{" + device + ",index=\"0\",type=\"GPU\",subdevice=\"0\"} 60\n") !=
+                std::string::npos);
+        REQUIRE(metrics.find("type=\"MEMORY\"") == std::string::npos);
+    }
+
+    SECTION("Components that weren't sampled have no samples") {
+        REQUIRE(metrics.find("ze_pci_receive_bytes_per_second{") == std::string::npos);
+        REQUIRE(metrics.find("ze_memory_size_bytes{") == std::string::npos);
+    }
+
+    SECTION("A later sample replaces the text") {
+        snapshot.powerDomains[0].power = 80;
+        exporter.publish({&snapshot});
+        std::string updated = exporter.getMetrics();
+        REQUIRE(updated.find("ze_power_watts{" + device + ",index=\"0\"} 80\n") != std::string::npos);
+        REQUIRE(updated.find("120.5") == std::string::npos);
+    }
+
+    SECTION("Families list the samples of every device together") {
+        DeviceLabels second = makeLabels();
+        second.uuid = "00000000-0000-0000-0000-000000000002";
+        second.bdf = "0000:04:00.0";
+        MetricsExporter both({makeLabels(), second});
+        both.publish({&snapshot, &snapshot});
+        std::string text = both.getMetrics();
+        size_t first = text.find("ze_power_watts{uuid=\"00000000-0000-0000-0000-000000000001\"");
+        size_t next = text.find("ze_power_watts{uuid=\"00000000-0000-0000-0000-000000000002\"");
+        REQUIRE(first != std::string::npos);
+        REQUIRE(next == text.find('\n', first) + 1);
+    }
+}
+
+TEST_CASE("Scrapes over HTTP", "[exporter]") {
+    MetricsExporter exporter({makeLabels()});
+    REQUIRE(exporter.start("127.0.0.1", 0));
+    REQUIRE(exporter.getPort() != 0);
+
+    SECTION("Nothing to serve before the first sample") {
+        REQUIRE(fetch(exporter.getPort(), "GET /metrics HTTP/1.1\r\nHost: x\r\n\r\n").rfind("HTTP/1.1 503", 0) == 0);
+    }
+
+    SECTION("GET /metrics returns the published text") {
+        DeviceSnapshot snapshot = makeSnapshot();
+        exporter.publish({&snapshot});
+        std::string metrics = exporter.getMetrics();
+
+        std::string response = fetch(exporter.getPort(), "GET /metrics HTTP/1.1\r\nHost: x\r\n\r\n");
+        REQUIRE(response.rfind("HTTP/1.1 200 OK\r\n", 0) == 0);
+        REQUIRE(response.find("Content-Length: " + std::to_string(metrics.size()) + "\r\n") != std::string::npos);
+        REQUIRE(response.substr(response.find("\r\n\r\n") + 4) == metrics);
+
+        std::string head = fetch(exporter.getPort(), "HEAD /metrics?x=1 HTTP/1.1\r\n\r\n");
+        REQUIRE(head.rfind("HTTP/1.1 200 OK\r\n", 0) == 0);
+        REQUIRE(head.size() == head.find("\r\n\r\n") + 4);
+        REQUIRE(exporter.getScrapeCount() == 2);
+    }
+
+    SECTION("Anything else is refused") {
+        REQUIRE(fetch(exporter.getPort(), "GET / HTTP/1.1\r\n\r\n").rfind("HTTP/1.1 404", 0) == 0);
+        REQUIRE(fetch(exporter.getPort(), "POST /metrics HTTP/1.1\r\n\r\n").rfind("HTTP/1.1 405", 0) == 0);
+        REQUIRE(fetch(exporter.getPort(), "nonsense\r\n\r\n").rfind("HTTP/1.1 400", 0) == 0);
+    }
+
+    exporter.stop();
+}
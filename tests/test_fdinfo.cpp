@@ -0,0 +1,178 @@
+#include <catch2/catch_all.hpp>
+#include "src/fdinfo.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "fake_tree.h"
+
+namespace {
+const char *i915_fdinfo = "pos:\t0\n"
+                          "flags:\t02100002\n"
+                          "mnt_id:\t26\n"
+                          "drm-driver:\ti915\n"
+                          "drm-client-id:\t7\n"
+                          "drm-pdev:\t0000:03:00.0\n"
+                          "drm-engine-render:\t9288864723 ns\n"
+                          "drm-engine-copy:\t2035071108 ns\n"
+                          "drm-engine-video:\t0 ns\n"
+                          "drm-engine-capacity-video:\t2\n"
+                          "drm-engine-video-enhance:\t0 ns\n"
+                          "drm-memory-system0:\t1024 KiB\n"
+                          "drm-memory-local0:\t64 MiB\n";
+
+const char *xe_fdinfo = "pos:\t0\n"
+                        "drm-driver:\txe\n"
+                        "drm-client-id:\t42\n"
+                        "drm-pdev:\t0000:03:00.0\n"
+                        "drm-total-system:\t0\n"
+                        "drm-resident-system:\t8 KiB\n"
+                        "drm-total-vram0:\t24 MiB\n"
+                        "drm-resident-vram0:\t16 MiB\n"
+                        "drm-cycles-rcs:\t1000\n"
+                        "drm-total-cycles-rcs:\t50000\n"
+                        "drm-cycles-ccs:\t0\n"
+                        "drm-total-cycles-ccs:\t50000\n"
+                        "drm-engine-capacity-ccs:\t4\n";
+
+std::string engine_fdinfo(uint64_t client, uint64_t render, const char *pdev = "0000:03:00.0") {
+    return FakeSystemTree::drmFdinfo(client, render, pdev);
+}
+} // namespace
+
+TEST_CASE("DRM fdinfo parsing", "[fdinfo]") {
+    DrmFdinfo info;
+
+    SECTION("i915 engine time and memory") {
+        REQUIRE(parse_drm_fdinfo(i915_fdinfo, std::strlen(i915_fdinfo), info));
+        REQUIRE(info.clientId == 7);
+        REQUIRE(std::string(info.pdev) == "0000:03:00.0");
+        REQUIRE(info.engineTime[DRM_ENGINE_RENDER] == 9288864723ull);
+        REQUIRE(info.engineTime[DRM_ENGINE_COPY] == 2035071108ull);
+        REQUIRE(info.haveEngineTime == ((1u << DRM_ENGINE_RENDER) | (1u << DRM_ENGINE_COPY) |
+                                        (1u << DRM_ENGINE_VIDEO) | (1u << DRM_ENGINE_VIDEO_ENHANCE)));
+        REQUIRE(info.capacity[DRM_ENGINE_VIDEO] == 2);
+        REQUIRE(info.capacity[DRM_ENGINE_RENDER] == 1);
+        REQUIRE(info.systemResident == 1024 * 1024);
+        REQUIRE(info.vramResident == 64 * 1024 * 1024);
+    }
+
+    SECTION("xe cycles and residency") {
+        REQUIRE(parse_drm_fdinfo(xe_fdinfo, std::strlen(xe_fdinfo), info));
+        REQUIRE(info.clientId == 42);
+        REQUIRE(info.haveEngineTime == 0);
+        REQUIRE(info.haveCycles == ((1u << DRM_ENGINE_RENDER) | (1u << DRM_ENGINE_COMPUTE)));
+        REQUIRE(info.cycles[DRM_ENGINE_RENDER] == 1000);
+        REQUIRE(info.totalCycles[DRM_ENGINE_RENDER] == 50000);
+        REQUIRE(info.capacity[DRM_ENGINE_COMPUTE] == 4);
+        // drm-total-* is allocated, not resident.
+        REQUIRE(info.vramResident == 16 * 1024 * 1024);
+        REQUIRE(info.systemResident == 8 * 1024);
+    }
+
+    SECTION("Non-DRM fds are rejected") {
+        const char *socket = "pos:\t0\nflags:\t02000002\nmnt_id:\t9\nino:\t12345\n";
+        REQUIRE_FALSE(parse_drm_fdinfo(socket, std::strlen(socket), info));
+    }
+}
+
+TEST_CASE("DRM fdinfo collection", "[fdinfo]") {
+    FakeSystemTree proc;
+    const uint32_t pid = 1234;
+
+    SECTION("Utilization is busy time over elapsed time") {
+        proc.addFd(pid, 0, "/dev/pts/0");
+        proc.addFd(pid, 3, "/dev/dri/renderD128", engine_fdinfo(1, 1000000000));
+        proc.addFd(pid, 4, "socket:[5678]");
+        DrmFdinfoCollector collector(proc.procRoot(), "0000:03:00.0");
+
+        collector.begin(0);
+        const DrmUsage &first = collector.update(pid, 1);
+        collector.end();
+        REQUIRE(first.valid);
+        REQUIRE(first.utilization[DRM_ENGINE_RENDER] == 0.0f);
+        REQUIRE(first.utilization[DRM_ENGINE_COMPUTE] < 0);
+        // Only the DRM fd is held open.
+        REQUIRE(collector.getOpenFdCount() == 1);
+
+        proc.setFdinfo(pid, 3, engine_fdinfo(1, 1250000000));
+        collector.begin(500000000);
+        const DrmUsage &second = collector.update(pid, 1);
+        collector.end();
+        REQUIRE(second.utilization[DRM_ENGINE_RENDER] == Catch::Approx(50.0));
+    }
+
+    SECTION("Cycles are measured against the GPU timestamp") {
+        proc.addFd(pid, 5, "/dev/dri/renderD128", xe_fdinfo);
+        DrmFdinfoCollector collector(proc.procRoot());
+        collector.begin(0);
+        collector.update(pid, 1);
+        proc.setFdinfo(pid, 5, "drm-driver:\txe\ndrm-client-id:\t42\n"
+                               "drm-cycles-rcs:\t6000\ndrm-total-cycles-rcs:\t60000\n"
+                               "drm-cycles-ccs:\t20000\ndrm-total-cycles-ccs:\t60000\n"
+                               "drm-engine-capacity-ccs:\t4\n");
+        collector.begin(1000);
+        const DrmUsage &usage = collector.update(pid, 1);
+        REQUIRE(usage.utilization[DRM_ENGINE_RENDER] == Catch::Approx(50.0));
+        // 20000 of 10000 cycles across four engines.
+        REQUIRE(usage.utilization[DRM_ENGINE_COMPUTE] == Catch::Approx(50.0));
+    }
+
+    SECTION("Shared clients count once and other devices are ignored") {
+        proc.addFd(pid, 3, "/dev/dri/renderD128", engine_fdinfo(1, 0));
+        proc.addFd(pid, 4, "/dev/dri/renderD128", engine_fdinfo(1, 0));
+        proc.addFd(pid, 5, "/dev/dri/renderD129", engine_fdinfo(2, 0, "0000:04:00.0"));
+        DrmFdinfoCollector collector(proc.procRoot(), "0000:03:00.0");
+        collector.begin(0);
+        collector.update(pid, 1);
+        proc.setFdinfo(pid, 3, engine_fdinfo(1, 100));
+        proc.setFdinfo(pid, 4, engine_fdinfo(1, 100));
+        proc.setFdinfo(pid, 5, engine_fdinfo(2, 900, "0000:04:00.0"));
+        collector.begin(1000);
+        REQUIRE(collector.update(pid, 1).utilization[DRM_ENGINE_RENDER] == Catch::Approx(10.0));
+        // The other device's client isn't held open.
+        REQUIRE(collector.getOpenFdCount() == 2);
+    }
+
+    SECTION("Collectors share one descriptor count") {
+        proc.addFd(pid, 3, "/dev/dri/renderD128", engine_fdinfo(1, 0));
+        proc.addFd(pid, 4, "/dev/dri/renderD129", engine_fdinfo(2, 0, "0000:04:00.0"));
+        size_t before = DrmFdinfoCollector::getHeldFdCount();
+        {
+            DrmFdinfoCollector first(proc.procRoot(), "0000:03:00.0");
+            DrmFdinfoCollector second(proc.procRoot(), "0000:04:00.0");
+            first.begin(0);
+            first.update(pid, 1);
+            second.begin(0);
+            second.update(pid, 1);
+            REQUIRE(first.getOpenFdCount() == 1);
+            REQUIRE(second.getOpenFdCount() == 1);
+            // An fd directory and one fdinfo file each.
+            REQUIRE(DrmFdinfoCollector::getHeldFdCount() == before + 4);
+        }
+        REQUIRE(DrmFdinfoCollector::getHeldFdCount() == before);
+    }
+
+    SECTION("Closed fds and exited processes are released") {
+        proc.addFd(pid, 3, "/dev/dri/renderD128", engine_fdinfo(1, 0));
+        proc.addFd(pid + 1, 3, "/dev/dri/renderD128", engine_fdinfo(2, 0));
+        DrmFdinfoCollector collector(proc.procRoot());
+        collector.begin(0);
+        collector.update(pid, 1);
+        collector.update(pid + 1, 1);
+        collector.end();
+        REQUIRE(collector.getOpenFdCount() == 2);
+
+        proc.closeFd(pid, 3);
+        collector.begin(1000);
+        REQUIRE_FALSE(collector.update(pid, 1).valid);
+        collector.end();
+        REQUIRE(collector.getOpenFdCount() == 0);
+    }
+
+    SECTION("Processes without access report nothing") {
+        DrmFdinfoCollector collector(proc.procRoot());
+        collector.begin(0);
+        REQUIRE_FALSE(collector.update(99999, 1).valid);
+        collector.end();
+    }
+}
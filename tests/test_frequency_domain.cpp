@@ -0,0 +1,76 @@
+#include <catch2/catch_all.hpp>
+#include "src/frequency_domain.h"
+#include "src/helpers.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ze_mock.h"
+
+namespace {
+zes_freq_throttle_time_t throttle_time(uint64_t throttled, uint64_t timestamp) {
+    zes_freq_throttle_time_t value = {};
+    value.throttleTime = throttled;
+    value.timestamp = timestamp;
+    return value;
+}
+} // namespace
+
+TEST_CASE("Frequency domain state and throttling", "[frequency]") {
+    zes_freq_handle_t handle = reinterpret_cast<zes_freq_handle_t>(1);
+
+    SECTION("State is read on every update") {
+        resetMocks();
+        FrequencyDomain domain(handle);
+        REQUIRE(domain.getFrequencyProperties()->type == ZES_FREQ_DOMAIN_GPU);
+        REQUIRE(domain.getFrequencyProperties()->max == 2400);
+        g_mockFrequencyState.actual = 1600;
+        g_mockFrequencyState.request = 2400;
+        REQUIRE(domain.updateStats() == ZE_RESULT_SUCCESS);
+        REQUIRE(domain.getFrequencyState()->actual == 1600);
+        REQUIRE(domain.getFrequencyState()->request == 2400);
+    }
+
+    SECTION("Throttle fraction is throttle time over elapsed time") {
+        resetMocks();
+        // 250ms of a 1s interval, then none of the next.
+        g_mockThrottleTimes = {throttle_time(1000, 1000000), throttle_time(251000, 2000000),
+                               throttle_time(251000, 3000000)};
+        FrequencyDomain domain(handle);
+        REQUIRE(domain.isThrottleTimeSupported());
+        REQUIRE(domain.getThrottleFraction() == 0.0);
+        domain.updateStats();
+        REQUIRE(domain.getThrottleFraction() == Catch::Approx(0.25));
+        domain.updateStats();
+        REQUIRE(domain.getThrottleFraction() == 0.0);
+    }
+
+    SECTION("A counter reset reports zero rather than a huge fraction") {
+        resetMocks();
+        g_mockThrottleTimes = {throttle_time(500000, 1000000), throttle_time(10, 500),
+                               throttle_time(100010, 1000500)};
+        FrequencyDomain domain(handle);
+        domain.updateStats();
+        REQUIRE(domain.getThrottleFraction() == 0.0);
+        domain.updateStats();
+        REQUIRE(domain.getThrottleFraction() == Catch::Approx(0.1));
+    }
+
+    SECTION("Without a throttle time counter the reasons are used") {
+        resetMocks();
+        g_throttleTimeResult = ZE_RESULT_ERROR_UNSUPPORTED_FEATURE;
+        FrequencyDomain domain(handle);
+        REQUIRE_FALSE(domain.isThrottleTimeSupported());
+        domain.updateStats();
+        REQUIRE(domain.getThrottleFraction() == 0.0);
+        g_mockFrequencyState.throttleReasons =
+            ZES_FREQ_THROTTLE_REASON_FLAG_THERMAL_LIMIT | ZES_FREQ_THROTTLE_REASON_FLAG_AVE_PWR_CAP;
+        domain.updateStats();
+        REQUIRE(domain.getThrottleFraction() == 1.0);
+        REQUIRE(throttle_reasons_to_str(domain.getFrequencyState()->throttleReasons) == "POWER THERMAL");
+    }
+
+    SECTION("No reasons is an empty string") {
+        REQUIRE(throttle_reasons_to_str(0).empty());
+        REQUIRE(std::string(freq_domain_to_str(ZES_FREQ_DOMAIN_MEDIA)) == "MEDIA");
+    }
+}
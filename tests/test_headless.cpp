@@ -0,0 +1,41 @@
+#include <catch2/catch_all.hpp>
+#include "src/headless.h"
+#include <chrono>
+#include <vector>
+#include "ze_mock.h"
+
+TEST_CASE("Headless setup", "[headless]") {
+    zes_device_handle_t handle = reinterpret_cast<zes_device_handle_t>(1);
+    ThreadPool pool(2);
+
+    SECTION("Exporter engines are decimated to the display period") {
+        resetMocks();
+        Device first(handle), second(handle);
+        std::vector<Device *> devices = {&first, &second};
+        prepare_headless(devices, pool, EXPORTER_COMPONENTS, std::chrono::milliseconds(500),
+                         std::chrono::milliseconds(2000), 0.25);
+
+        for (Device *device : devices) {
+            REQUIRE(device->isInitialized(EXPORTER_COMPONENTS));
+            REQUIRE(device->getEngineCount() > 0);
+            for (uint32_t i = 0; i < device->getEngineCount(); ++i) {
+                REQUIRE(device->getEngine(i)->getDecimationWindow() == std::chrono::milliseconds(2000));
+                REQUIRE(device->getEngine(i)->getSmoothing() == 0.25);
+            }
+        }
+    }
+
+    SECTION("Streamed engines are decimated to the display period") {
+        resetMocks();
+        Device device(handle);
+        prepare_headless({&device}, pool, STREAM_COMPONENTS, std::chrono::milliseconds(1000),
+                         std::chrono::milliseconds(100), 0.5);
+
+        REQUIRE(device.isInitialized(STREAM_COMPONENTS));
+        REQUIRE(device.getEngineCount() > 0);
+        for (uint32_t i = 0; i < device.getEngineCount(); ++i) {
+            REQUIRE(device.getEngine(i)->getDecimationWindow() == std::chrono::milliseconds(100));
+            REQUIRE(device.getEngine(i)->getSmoothing() == 0.5);
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#include <catch2/catch_all.hpp>
+#include "src/history.h"
+#include <vector>
+
+TEST_CASE("Compact encodings round trip", "[history]") {
+    REQUIRE(PermilleEncoding::decode(PermilleEncoding::encode(42.37)) == Catch::Approx(42.4));
+    REQUIRE(PermilleEncoding::decode(PermilleEncoding::encode(150.0)) == Catch::Approx(100.0));
+    REQUIRE(PermilleEncoding::decode(PermilleEncoding::encode(-1.0)) == Catch::Approx(0.0));
+    REQUIRE(DeciDegreeEncoding::decode(DeciDegreeEncoding::encode(-12.34)) == Catch::Approx(-12.3));
+    REQUIRE(DeciDegreeEncoding::decode(DeciDegreeEncoding::encode(95.06)) == Catch::Approx(95.1));
+    REQUIRE(DeciWattEncoding::decode(DeciWattEncoding::encode(312.25)) == Catch::Approx(312.3));
+    REQUIRE(DeciWattEncoding::decode(DeciWattEncoding::encode(9999.0)) == Catch::Approx(6553.5));
+}
+
+TEST_CASE("MetricHistory keeps the most recent values", "[history]") {
+    std::vector<double> out;
+
+    SECTION("Values packed across words stay independent") {
+        TemperatureHistory history(10);
+        for (int i = 0; i < 7; ++i) {
+            history.push(-3.0 + i);
+        }
+        REQUIRE(history.read(out, 100) == 7);
+        for (int i = 0; i < 7; ++i) {
+            REQUIRE(out[i] == Catch::Approx(-3.0 + i));
+        }
+    }
+
+    SECTION("Wraps once full and honours max") {
+        UtilizationHistory history(5);
+        for (int i = 0; i < 12; ++i) {
+            history.push(i * 5.0);
+        }
+        REQUIRE(history.getCount() == 12);
+        REQUIRE(history.read(out, 100) == 5);
+        REQUIRE(out.front() == Catch::Approx(35.0));
+        REQUIRE(out.back() == Catch::Approx(55.0));
+        REQUIRE(history.read(out, 2) == 2);
+        REQUIRE(out.front() == Catch::Approx(50.0));
+    }
+
+    SECTION("Storage is compact") {
+        // Four hours of one second samples in well under 32KB.
+        UtilizationHistory history(4 * 3600);
+        REQUIRE(history.getMemoryUsage() < 32 * 1024);
+    }
+}
@@ -0,0 +1,73 @@
+#include <catch2/catch_all.hpp>
+#include "src/memory_module.h"
+#include <cstdint>
+#include <vector>
+#include "ze_mock.h"
+
+namespace {
+zes_mem_bandwidth_t bandwidth(uint64_t read, uint64_t write, uint64_t timestamp) {
+    zes_mem_bandwidth_t value = {};
+    value.readCounter = read;
+    value.writeCounter = write;
+    value.maxBandwidth = 100000000000ull;
+    value.timestamp = timestamp;
+    return value;
+}
+} // namespace
+
+TEST_CASE("Memory module state and bandwidth", "[memory]") {
+    zes_mem_handle_t handle = reinterpret_cast<zes_mem_handle_t>(1);
+
+    SECTION("State is read on every update") {
+        resetMocks();
+        MemoryModule module(handle);
+        REQUIRE(module.getMemoryProperties()->type == ZES_MEM_TYPE_GDDR6);
+        REQUIRE(module.updateStats() == ZE_RESULT_SUCCESS);
+        REQUIRE(module.getMemoryState()->size == 1024 * 1024 * 1024);
+        REQUIRE(module.getMemoryState()->free == 512 * 1024 * 1024);
+    }
+
+    SECTION("Bandwidth is the counter delta over the timestamp delta") {
+        resetMocks();
+        // 2GB read and 1GB written over half a second.
+        g_mockMemoryBandwidth = {bandwidth(0, 0, 1000000), bandwidth(2000000000, 1000000000, 1500000)};
+        MemoryModule module(handle);
+        REQUIRE(module.isBandwidthSupported());
+        REQUIRE(module.getReadBandwidth() == 0.0);
+        module.updateStats();
+        REQUIRE(module.getReadBandwidth() == Catch::Approx(4e9));
+        REQUIRE(module.getWriteBandwidth() == Catch::Approx(2e9));
+        REQUIRE(module.getMaxBandwidth() == Catch::Approx(1e11));
+    }
+
+    SECTION("Counter wrap is handled") {
+        resetMocks();
+        g_mockMemoryBandwidth = {bandwidth(UINT64_MAX - 999, 0, 0), bandwidth(1000, 0, 1000000)};
+        MemoryModule module(handle);
+        module.updateStats();
+        REQUIRE(module.getReadBandwidth() == Catch::Approx(2000.0));
+    }
+
+    SECTION("A reset reports zero rather than a huge rate") {
+        resetMocks();
+        g_mockMemoryBandwidth = {bandwidth(0, 0, 0), bandwidth(1000, 1000, 1000000),
+                                 bandwidth(10, 10, 500), bandwidth(1010, 510, 1000500)};
+        MemoryModule module(handle);
+        module.updateStats();
+        REQUIRE(module.getReadBandwidth() == Catch::Approx(1000.0));
+        module.updateStats(); // timestamp went backwards
+        REQUIRE(module.getReadBandwidth() == 0.0);
+        module.updateStats();
+        REQUIRE(module.getReadBandwidth() == Catch::Approx(1000.0));
+        REQUIRE(module.getWriteBandwidth() == Catch::Approx(500.0));
+    }
+
+    SECTION("Modules without bandwidth counters still report state") {
+        resetMocks();
+        g_memoryBandwidthResult = ZE_RESULT_ERROR_UNSUPPORTED_FEATURE;
+        MemoryModule module(handle);
+        REQUIRE_FALSE(module.isBandwidthSupported());
+        REQUIRE(module.updateStats() == ZE_RESULT_SUCCESS);
+        REQUIRE(module.getReadBandwidth() == 0.0);
+    }
+}
@@ -0,0 +1,139 @@
+#include <catch2/catch_all.hpp>
+#include "src/helpers.h"
+#include "src/paths.h"
+#include "src/process.h"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "fake_tree.h"
+#include "ze_mock.h"
+
+namespace {
+zes_process_state_t process(uint32_t pid) {
+    zes_process_state_t value = {};
+    value.processId = pid;
+    value.memSize = 4096;
+    return value;
+}
+
+void report_processes(uint32_t first, uint32_t count) {
+    g_mockProcesses.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        g_mockProcesses.push_back(process(first + i));
+    }
+}
+
+// Point SystemPaths at a fake tree for the lifetime of a test.
+class ScopedSystemPaths {
+public:
+    explicit ScopedSystemPaths(const FakeSystemTree &tree) : saved(SystemPaths::instance()) {
+        SystemPaths::instance().proc = tree.procRoot();
+        SystemPaths::instance().sys = tree.sysRoot();
+    }
+    ~ScopedSystemPaths() { SystemPaths::instance() = saved; }
+
+private:
+    SystemPaths saved;
+};
+} // namespace
+
+TEST_CASE("Render nodes resolve under the sysfs root", "[paths]") {
+    FakeSystemTree tree;
+    tree.addGpu(0, 0x8086, 0xe20b);
+    tree.addGpu(1, 0x8086, 0x56a0);
+    ScopedSystemPaths paths(tree);
+
+    pciid_t id = get_pci_id_for_render_node(tree.sysRoot() + "/../dev/dri/renderD129");
+    REQUIRE(id.vendor == 0);
+
+    // A plain file stands in for the device node.
+    std::filesystem::create_directories(tree.sysRoot() + "/../dev/dri");
+    std::ofstream(tree.sysRoot() + "/../dev/dri/renderD129") << "";
+    id = get_pci_id_for_render_node(tree.sysRoot() + "/../dev/dri/renderD129");
+    REQUIRE(id.vendor == 0x8086);
+    REQUIRE(id.device == 0x56a0);
+}
+
+TEST_CASE("Processes are read from the procfs root", "[paths]") {
+    zes_device_handle_t handle = reinterpret_cast<zes_device_handle_t>(1);
+    FakeSystemTree tree;
+    tree.populate(8, 2);
+
+    SECTION("Metadata and fdinfo come from the fake tree") {
+        resetMocks();
+        report_processes(1000, 8);
+        ProcessMonitor monitor(handle, tree.procRoot());
+        monitor.setPciAddress(FakeSystemTree::gpuAddress(0));
+        REQUIRE(monitor.updateProcessStats() == ZE_RESULT_SUCCESS);
+        REQUIRE(monitor.getProcessCount() == 8);
+
+        const ProcessInfo *first = monitor.getProcessInfo(0);
+        REQUIRE(first->getCommandLine() == "/usr/bin/worker --rank 0");
+        REQUIRE(first->getProcessName() == "worker");
+        REQUIRE(first->getStartTime() == 100);
+        REQUIRE(first->drm_usage.valid);
+        REQUIRE(first->drm_usage.vramResident == 64 * 1024 * 1024);
+        // Processes on the other GPU have no clients on this one.
+        REQUIRE_FALSE(monitor.getProcessInfo(1)->drm_usage.valid);
+    }
+
+    SECTION("A reused PID gets a new record") {
+        resetMocks();
+        report_processes(1000, 1);
+        ProcessMonitor monitor(handle, tree.procRoot());
+        monitor.updateProcessStats();
+        const ProcessInfo *before = monitor.getProcessInfo(0);
+        REQUIRE(before->getCommandLine() == "/usr/bin/worker --rank 0");
+
+        // Reuse is noticed when the PID's start time is next revalidated.
+        tree.addProcess(1000, "server", "/usr/bin/server", 5000);
+        for (uint64_t i = 0; i < ProcessMonitor::START_TIME_REVALIDATION; ++i) {
+            monitor.updateProcessStats();
+        }
+        const ProcessInfo *after = monitor.getProcessInfo(0);
+        REQUIRE(after->getStartTime() == 5000);
+        REQUIRE(after->getCommandLine() == "/usr/bin/server");
+    }
+}
+
+TEST_CASE("Process scanning at scale", "[paths][!benchmark]") {
+    zes_device_handle_t handle = reinterpret_cast<zes_device_handle_t>(1);
+    FakeSystemTree tree;
+    tree.populate(10000, 16);
+    ScopedSystemPaths paths(tree);
+    resetMocks();
+    report_processes(1000, 10000);
+
+    // One monitor per device, as ze-monitor runs them.
+    std::vector<std::unique_ptr<ProcessMonitor>> monitors;
+    for (uint32_t gpu = 0; gpu < 16; ++gpu) {
+        monitors.push_back(std::make_unique<ProcessMonitor>(handle));
+        monitors.back()->setPciAddress(FakeSystemTree::gpuAddress(gpu));
+    }
+    BENCHMARK("First update of 10k processes") {
+        ProcessMonitor cold(handle);
+        cold.setPciAddress(FakeSystemTree::gpuAddress(0));
+        return cold.updateProcessStats();
+    };
+    for (auto &monitor : monitors) {
+        monitor->updateProcessStats();
+    }
+    BENCHMARK("Steady update of 10k processes on 16 devices") {
+        ze_result_t ret = ZE_RESULT_SUCCESS;
+        for (auto &monitor : monitors) {
+            ret = monitor->updateProcessStats();
+        }
+        return ret;
+    };
+    BENCHMARK("Resolve 16 render nodes") {
+        uint32_t found = 0;
+        for (uint32_t gpu = 0; gpu < 16; ++gpu) {
+            std::string node = tree.sysRoot() + "/class/drm/renderD" + std::to_string(128 + gpu);
+            found += get_pci_id_for_render_node(node).vendor != 0;
+        }
+        return found;
+    };
+}
@@ -0,0 +1,105 @@
+#include <catch2/catch_all.hpp>
+#include "src/helpers.h"
+#include "src/pci_link.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ze_mock.h"
+
+namespace {
+zes_pci_properties_t properties(int32_t gen, int32_t width) {
+    zes_pci_properties_t value = {};
+    value.maxSpeed = {gen, width, -1};
+    value.haveBandwidthCounters = true;
+    value.havePacketCounters = true;
+    value.haveReplayCounters = true;
+    return value;
+}
+
+zes_pci_stats_t stats(uint64_t rx, uint64_t tx, uint64_t packets, uint64_t timestamp) {
+    zes_pci_stats_t value = {};
+    value.rxCounter = rx;
+    value.txCounter = tx;
+    value.packetCounter = packets;
+    value.timestamp = timestamp;
+    value.speed = {4, 16, -1};
+    return value;
+}
+} // namespace
+
+TEST_CASE("PCIe link throughput and health", "[pci]") {
+    zes_device_handle_t handle = reinterpret_cast<zes_device_handle_t>(1);
+
+    SECTION("Throughput is the counter delta over the timestamp delta") {
+        resetMocks();
+        // 1GB received, 500MB sent and 2000 packets over a quarter second.
+        g_mockPciStats = {stats(0, 0, 0, 1000000), stats(1000000000, 500000000, 2000, 1250000)};
+        PciLink link(handle, properties(4, 16));
+        REQUIRE(link.isStatsSupported());
+        REQUIRE(link.getRxBandwidth() == 0.0);
+        REQUIRE(link.updateStats() == ZE_RESULT_SUCCESS);
+        REQUIRE(link.getRxBandwidth() == Catch::Approx(4e9));
+        REQUIRE(link.getTxBandwidth() == Catch::Approx(2e9));
+        REQUIRE(link.getPacketRate() == Catch::Approx(8000.0));
+        REQUIRE(link.getReplayRate() == 0.0);
+    }
+
+    SECTION("Counters the device doesn't have stay at zero") {
+        resetMocks();
+        g_mockPciStats = {stats(0, 0, 0, 0), stats(1000, 1000, 1000, 1000000)};
+        zes_pci_properties_t limited = properties(4, 16);
+        limited.havePacketCounters = false;
+        PciLink link(handle, limited);
+        link.updateStats();
+        REQUIRE(link.getRxBandwidth() == Catch::Approx(1000.0));
+        REQUIRE(link.getPacketRate() == 0.0);
+    }
+
+    SECTION("A reset reports zero rather than a huge rate") {
+        resetMocks();
+        g_mockPciStats = {stats(5000, 0, 0, 1000000), stats(10, 0, 0, 500), stats(1010, 0, 0, 1000500)};
+        PciLink link(handle, properties(4, 16));
+        link.updateStats();
+        REQUIRE(link.getRxBandwidth() == 0.0);
+        link.updateStats();
+        REQUIRE(link.getRxBandwidth() == Catch::Approx(1000.0));
+    }
+
+    SECTION("A link trained below its maximum is degraded") {
+        resetMocks();
+        g_mockPciState.status = ZES_PCI_LINK_STATUS_GOOD;
+        g_mockPciState.speed = {4, 4, -1};
+        PciLink narrow(handle, properties(4, 16));
+        REQUIRE(narrow.isDegraded());
+        REQUIRE(pci_speed_to_str(narrow.getSpeed()) == "Gen4 x4");
+
+        g_mockPciState.speed = {3, 16, -1};
+        narrow.updateStats();
+        REQUIRE(narrow.isDegraded());
+
+        g_mockPciState.speed = {4, 16, -1};
+        narrow.updateStats();
+        REQUIRE_FALSE(narrow.isDegraded());
+    }
+
+    SECTION("Unknown speeds are never degraded") {
+        resetMocks();
+        g_pciStateResult = ZE_RESULT_ERROR_UNSUPPORTED_FEATURE;
+        g_pciStatsResult = ZE_RESULT_ERROR_UNSUPPORTED_FEATURE;
+        PciLink link(handle, properties(-1, -1));
+        REQUIRE_FALSE(link.isStateSupported());
+        REQUIRE_FALSE(link.isStatsSupported());
+        REQUIRE(link.updateStats() == ZE_RESULT_SUCCESS);
+        REQUIRE_FALSE(link.isDegraded());
+        REQUIRE(pci_speed_to_str(link.getSpeed()) == "Gen? x?");
+    }
+
+    SECTION("Without state the speed comes from the stats") {
+        resetMocks();
+        g_pciStateResult = ZE_RESULT_ERROR_UNSUPPORTED_FEATURE;
+        g_mockPciStats = {stats(0, 0, 0, 0)};
+        g_mockPciStats[0].speed = {4, 8, -1};
+        PciLink link(handle, properties(4, 16));
+        REQUIRE(link.isDegraded());
+    }
+}
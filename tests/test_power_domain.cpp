@@ -0,0 +1,125 @@
+#include <catch2/catch_all.hpp>
+#include "src/helpers.h"
+#include "src/power_domain.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ze_mock.h"
+
+namespace {
+// energy in joules, timestamp in seconds
+zes_power_energy_counter_t counter(double joules, double seconds) {
+    return zes_power_energy_counter_t{(uint64_t)(joules * 1e6), (uint64_t)(seconds * 1e6)};
+}
+
+zes_power_limit_ext_desc_t limit(zes_power_level_t level, int32_t milliwatts, bool enabled = true,
+                                 zes_limit_unit_t unit = ZES_LIMIT_UNIT_POWER) {
+    zes_power_limit_ext_desc_t desc = {};
+    desc.level = level;
+    desc.limitUnit = unit;
+    desc.enabled = enabled;
+    desc.limit = milliwatts;
+    return desc;
+}
+}
+
+TEST_CASE("PowerDomain power and session energy", "[power]") {
+    zes_pwr_handle_t handle = reinterpret_cast<zes_pwr_handle_t>(1);
+
+    SECTION("Fractional watts between two readings") {
+        resetMocks();
+        g_mockEnergyCounters = {counter(100.0, 10.0), counter(112.5, 11.0)};
+        PowerDomain domain(handle, std::chrono::milliseconds(1));
+        REQUIRE(domain.getPower() == 0.0);
+        domain.updateStats();
+        REQUIRE(domain.getPower() == Catch::Approx(12.5));
+        REQUIRE(domain.getSessionEnergy() == Catch::Approx(12.5));
+    }
+
+    SECTION("Power is averaged over the window") {
+        resetMocks();
+        // 10W, then 30W, then 50W for a second each.
+        g_mockEnergyCounters = {counter(0, 0), counter(10, 1), counter(40, 2), counter(90, 3)};
+        PowerDomain domain(handle, std::chrono::seconds(2));
+        domain.updateStats();
+        domain.updateStats();
+        REQUIRE(domain.getPower() == Catch::Approx(20.0));
+        domain.updateStats();
+        REQUIRE(domain.getPower() == Catch::Approx(40.0));
+        REQUIRE(domain.getSessionEnergy() == Catch::Approx(90.0));
+    }
+
+    SECTION("A 32 bit counter that wraps keeps counting") {
+        resetMocks();
+        uint64_t nearTop = (uint64_t)UINT32_MAX - 4000000;
+        g_mockEnergyCounters = {{nearTop, 0}, {6000000 - 1, 1000000}};
+        PowerDomain domain(handle);
+        domain.updateStats();
+        REQUIRE(domain.getPower() == Catch::Approx(10.0));
+        REQUIRE(domain.getSessionEnergy() == Catch::Approx(10.0));
+    }
+
+    SECTION("A wrap needing more power than the domain can draw is a reset") {
+        resetMocks();
+        // 10J in a millisecond would be 10kW.
+        uint64_t nearTop = (uint64_t)UINT32_MAX - 4000000;
+        g_mockEnergyCounters = {{nearTop, 0}, {6000000 - 1, 1000}};
+        PowerDomain domain(handle);
+        domain.updateStats();
+        REQUIRE(domain.getPower() == 0.0);
+        REQUIRE(domain.getSessionEnergy() == 0.0);
+    }
+
+    SECTION("A counter that has been wider than 32 bits never wraps at 32") {
+        resetMocks();
+        // Read above UINT32_MAX, then reset twice; the second time from
+        // where a 32 bit wrap would have been plausible.
+        g_mockEnergyCounters = {counter(5000, 0), counter(4000, 1), counter(4001, 2), counter(1, 3)};
+        PowerDomain domain(handle);
+        domain.updateStats();
+        domain.updateStats();
+        REQUIRE(domain.getSessionEnergy() == Catch::Approx(1.0));
+        domain.updateStats();
+        REQUIRE(domain.getPower() == 0.0);
+        REQUIRE(domain.getSessionEnergy() == Catch::Approx(1.0));
+    }
+
+    SECTION("A reset restarts the window without losing the session") {
+        resetMocks();
+        g_mockEnergyCounters = {counter(5000, 10), counter(5100, 11), counter(1, 0.5), counter(21, 1.5)};
+        PowerDomain domain(handle);
+        domain.updateStats();
+        REQUIRE(domain.getSessionEnergy() == Catch::Approx(100.0));
+        domain.updateStats();
+        REQUIRE(domain.getPower() == 0.0);
+        domain.updateStats();
+        REQUIRE(domain.getPower() == Catch::Approx(20.0));
+        REQUIRE(domain.getSessionEnergy() == Catch::Approx(120.0));
+    }
+}
+
+TEST_CASE("PowerDomain limits", "[power]") {
+    zes_pwr_handle_t handle = reinterpret_cast<zes_pwr_handle_t>(1);
+
+    SECTION("Lowest enabled power limit per level") {
+        resetMocks();
+        g_mockPowerLimits = {limit(ZES_POWER_LEVEL_SUSTAINED, 250000), limit(ZES_POWER_LEVEL_SUSTAINED, 200000),
+                             limit(ZES_POWER_LEVEL_BURST, 300000, false),
+                             limit(ZES_POWER_LEVEL_PEAK, 40000, true, ZES_LIMIT_UNIT_CURRENT)};
+        PowerDomain domain(handle);
+        REQUIRE(domain.getLimits().size() == 4);
+        REQUIRE(domain.getLimit(ZES_POWER_LEVEL_SUSTAINED) == Catch::Approx(200.0));
+        REQUIRE(domain.getLimit(ZES_POWER_LEVEL_BURST) < 0);
+        REQUIRE(domain.getLimit(ZES_POWER_LEVEL_PEAK) < 0);
+        REQUIRE(std::string(power_level_to_str(ZES_POWER_LEVEL_SUSTAINED)) == "SUSTAINED");
+    }
+
+    SECTION("No limits without driver support") {
+        resetMocks();
+        g_powerLimitsResult = ZE_RESULT_ERROR_UNSUPPORTED_FEATURE;
+        PowerDomain domain(handle);
+        REQUIRE(domain.getLimits().empty());
+        REQUIRE(domain.getLimit(ZES_POWER_LEVEL_SUSTAINED) < 0);
+    }
+}
@@ -0,0 +1,159 @@
+#include <catch2/catch_all.hpp>
+#include "src/process.h"
+#include <cstdint>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "ze_mock.h"
+
+namespace {
+zes_process_state_t process(uint32_t pid, uint64_t memSize) {
+    zes_process_state_t value = {};
+    value.processId = pid;
+    value.memSize = memSize;
+    return value;
+}
+} // namespace
+
+TEST_CASE("Process start time", "[process]") {
+    REQUIRE(read_process_start_time(getpid()) > 0);
+    REQUIRE(read_process_start_time(getpid()) == read_process_start_time(getpid()));
+    // PID 0 never has a /proc entry.
+    REQUIRE(read_process_start_time(0) == 0);
+}
+
+TEST_CASE("Processes are tracked incrementally", "[process]") {
+    zes_device_handle_t handle = reinterpret_cast<zes_device_handle_t>(1);
+    uint32_t self = getpid();
+    uint32_t parent = getppid();
+
+    SECTION("Known processes keep their record and get new values") {
+        resetMocks();
+        ProcessMonitor monitor(handle);
+        g_mockProcesses = {process(self, 100), process(parent, 200)};
+        REQUIRE(monitor.updateProcessStats() == ZE_RESULT_SUCCESS);
+        REQUIRE(monitor.getProcessCount() == 2);
+        const ProcessInfo *first = monitor.getProcessInfo(0);
+        REQUIRE(first->pid == self);
+        REQUIRE(first->getStartTime() == read_process_start_time(self));
+
+        g_mockProcesses = {process(self, 300), process(parent, 200)};
+        monitor.updateProcessStats();
+        REQUIRE(monitor.getProcessInfo(0) == first);
+        REQUIRE(first->used_memory == 300);
+    }
+
+    SECTION("An unchanged set is only revalidated now and then") {
+        resetMocks();
+        ProcessMonitor monitor(handle);
+        g_mockProcesses = {process(self, 100), process(parent, 200)};
+        monitor.updateProcessStats();
+        REQUIRE(monitor.getStartTimeReadCount() == 2);
+
+        // Each process is read again once per revalidation period.
+        for (uint64_t i = 0; i < ProcessMonitor::START_TIME_REVALIDATION; ++i) {
+            monitor.updateProcessStats();
+        }
+        REQUIRE(monitor.getStartTimeReadCount() == 4);
+        REQUIRE(monitor.getProcessCount() == 2);
+    }
+
+    SECTION("Exited processes are retired and new ones added") {
+        resetMocks();
+        ProcessMonitor monitor(handle);
+        g_mockProcesses = {process(self, 100), process(parent, 200)};
+        monitor.updateProcessStats();
+        const ProcessInfo *kept = monitor.getProcessInfo(1);
+
+        g_mockProcesses = {process(parent, 200), process(1, 50)};
+        monitor.updateProcessStats();
+        REQUIRE(monitor.getProcessCount() == 2);
+        REQUIRE(monitor.getProcessInfo(0) == kept);
+        REQUIRE(monitor.getProcessInfo(1)->pid == 1);
+
+        g_mockProcesses.clear();
+        monitor.updateProcessStats();
+        REQUIRE(monitor.getProcessCount() == 0);
+    }
+}
+
+TEST_CASE("Process metadata cache", "[process]") {
+    uint32_t self = getpid();
+    uint64_t start = read_process_start_time(self);
+
+    SECTION("Metadata is read once per process") {
+        ProcessMetadataCache cache;
+        auto metadata = cache.lookup(self, start);
+        REQUIRE(metadata->pid == self);
+        REQUIRE(metadata->uid == getuid());
+        REQUIRE_FALSE(metadata->name.empty());
+        REQUIRE(metadata->name.back() != '\n');
+        REQUIRE(metadata->commandLine.find('\0') == std::string::npos);
+        REQUIRE(cache.lookup(self, start) == metadata);
+        REQUIRE(cache.getLoadCount() == 1);
+    }
+
+    SECTION("A reused PID is read again") {
+        ProcessMetadataCache cache;
+        auto before = cache.lookup(self, start + 1);
+        auto after = cache.lookup(self, start);
+        REQUIRE(after != before);
+        REQUIRE(after->startTime == start);
+        REQUIRE(cache.getLoadCount() == 2);
+        REQUIRE(cache.getSize() == 1);
+    }
+
+    SECTION("The least recently used entry is evicted") {
+        ProcessMetadataCache cache(2);
+        uint32_t parent = getppid();
+        auto kept = cache.lookup(self, start);
+        cache.lookup(parent, read_process_start_time(parent));
+        cache.lookup(self, start);
+        cache.lookup(1, read_process_start_time(1));
+        REQUIRE(cache.getSize() == 2);
+        REQUIRE(cache.getLoadCount() == 3);
+        REQUIRE(cache.lookup(self, start) == kept);
+        REQUIRE(cache.getLoadCount() == 3);
+        cache.lookup(parent, read_process_start_time(parent));
+        REQUIRE(cache.getLoadCount() == 4);
+    }
+}
+
+TEST_CASE("Process polling buffers", "[process]") {
+    zes_device_handle_t handle = reinterpret_cast<zes_device_handle_t>(1);
+
+    SECTION("More than 2048 processes are all reported") {
+        resetMocks();
+        ProcessMonitor monitor(handle);
+        // PIDs above the kernel's maximum, so none have /proc entries.
+        for (uint32_t i = 0; i < 3000; ++i) {
+            g_mockProcesses.push_back(process(5000000 + i, i));
+        }
+        REQUIRE(monitor.updateProcessStats() == ZE_RESULT_SUCCESS);
+        REQUIRE(monitor.getProcessCount() == 3000);
+        REQUIRE(monitor.getProcessInfo(2999)->used_memory == 2999);
+
+        size_t capacity = monitor.getBufferCapacity();
+        REQUIRE(capacity >= 3000);
+        g_mockProcesses.resize(2500);
+        monitor.updateProcessStats();
+        REQUIRE(monitor.getProcessCount() == 2500);
+        REQUIRE(monitor.getBufferCapacity() == capacity);
+    }
+
+    SECTION("Records of exited processes are reused") {
+        resetMocks();
+        ProcessMonitor monitor(handle);
+        g_mockProcesses = {process(5000000, 1), process(5000001, 2)};
+        monitor.updateProcessStats();
+        const ProcessInfo *exited = monitor.getProcessInfo(1);
+
+        g_mockProcesses = {process(5000000, 1)};
+        monitor.updateProcessStats();
+        g_mockProcesses = {process(5000000, 1), process(5000002, 3)};
+        monitor.updateProcessStats();
+        REQUIRE(monitor.getProcessInfo(1) == exited);
+        REQUIRE(exited->pid == 5000002);
+        REQUIRE(exited->used_memory == 3);
+    }
+}
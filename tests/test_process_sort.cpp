@@ -0,0 +1,85 @@
+#include <catch2/catch_all.hpp>
+#include "src/process_sort.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+ProcessSample sample(uint32_t pid, uint64_t memory, const std::string &name = "worker", float utilization = -1) {
+    ProcessSample process = {};
+    process.pid = pid;
+    process.name = name;
+    process.used_memory = memory;
+    process.shared_memory = memory / 2;
+    process.drm.valid = utilization >= 0;
+    process.drm.utilization[DRM_ENGINE_RENDER] = utilization;
+    return process;
+}
+
+std::vector<uint32_t> pids(const std::vector<ProcessSample> &processes, const std::vector<uint32_t> &order,
+                           size_t count) {
+    std::vector<uint32_t> result;
+    for (size_t i = 0; i < count; ++i) {
+        result.push_back(processes[order[i]].pid);
+    }
+    return result;
+}
+} // namespace
+
+TEST_CASE("Top-N process selection", "[process_sort]") {
+    std::vector<uint32_t> order;
+
+    SECTION("Largest memory first, ties by PID") {
+        const uint64_t MiB = 1024 * 1024;
+        std::vector<ProcessSample> processes = {sample(30, 100 * MiB), sample(10, 500 * MiB), sample(20, 100 * MiB),
+                                                sample(40, 900 * MiB)};
+        select_top_processes(processes, ProcessSortKey::MEMORY, 3, order);
+        REQUIRE(order.size() == 4);
+        REQUIRE(pids(processes, order, 3) == std::vector<uint32_t>{40, 10, 20});
+    }
+
+    SECTION("Memory compares whole MiB") {
+        const uint64_t MiB = 1024 * 1024;
+        std::vector<ProcessSample> processes = {sample(30, 64 * MiB + 4096), sample(10, 64 * MiB), sample(20, 65 * MiB)};
+        select_top_processes(processes, ProcessSortKey::MEMORY, 3, order);
+        // A few pages more doesn't move PID 30 ahead of PID 10.
+        REQUIRE(pids(processes, order, 3) == std::vector<uint32_t>{20, 10, 30});
+        // Shared memory is half of that, 32 MiB for all three.
+        select_top_processes(processes, ProcessSortKey::SHARED, 3, order);
+        REQUIRE(pids(processes, order, 3) == std::vector<uint32_t>{10, 20, 30});
+    }
+
+    SECTION("PID and name sort ascending") {
+        std::vector<ProcessSample> processes = {sample(3, 0, "b"), sample(1, 0, "c"), sample(2, 0, "a"),
+                                                sample(4, 0, "a")};
+        select_top_processes(processes, ProcessSortKey::PID, 4, order);
+        REQUIRE(pids(processes, order, 4) == std::vector<uint32_t>{1, 2, 3, 4});
+        select_top_processes(processes, ProcessSortKey::NAME, 4, order);
+        REQUIRE(pids(processes, order, 4) == std::vector<uint32_t>{2, 4, 3, 1});
+    }
+
+    SECTION("Utilization compares displayed percent; unknown sorts last") {
+        std::vector<ProcessSample> processes = {sample(5, 0, "a", 10.2f), sample(6, 0, "b"), sample(7, 0, "c", 10.9f),
+                                                sample(8, 0, "d", 50.0f)};
+        select_top_processes(processes, ProcessSortKey::UTILIZATION, 4, order);
+        // 10.2% and 10.9% both show as 10%, so they stay in PID order.
+        REQUIRE(pids(processes, order, 4) == std::vector<uint32_t>{8, 5, 7, 6});
+    }
+
+    SECTION("Asking for more rows than processes is fine") {
+        std::vector<ProcessSample> processes = {sample(2, 1), sample(1, 2)};
+        select_top_processes(processes, ProcessSortKey::MEMORY, 15, order);
+        REQUIRE(pids(processes, order, 2) == std::vector<uint32_t>{1, 2});
+        select_top_processes({}, ProcessSortKey::MEMORY, 15, order);
+        REQUIRE(order.empty());
+    }
+
+    SECTION("The sort key cycles through every column") {
+        ProcessSortKey key = ProcessSortKey::MEMORY;
+        for (int i = 0; i < 5; ++i) {
+            key = next_process_sort_key(key);
+        }
+        REQUIRE(key == ProcessSortKey::MEMORY);
+        REQUIRE(std::string(process_sort_key_to_str(ProcessSortKey::UTILIZATION)) == "utilization");
+    }
+}
@@ -0,0 +1,84 @@
+#include <catch2/catch_all.hpp>
+#include "src/helpers.h"
+#include "src/ras_error_set.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include "ze_mock.h"
+
+using std::chrono::minutes;
+
+TEST_CASE("RAS error counters, deltas and rates", "[ras]") {
+    zes_ras_handle_t handle = reinterpret_cast<zes_ras_handle_t>(1);
+    auto start = std::chrono::steady_clock::now();
+
+    SECTION("Errors from before the session are a total, not a delta") {
+        resetMocks();
+        g_mockRasState.category[ZES_RAS_ERROR_CAT_CACHE_ERRORS] = 40;
+        RasErrorSet set(handle);
+        REQUIRE(set.getRasProperties()->type == ZES_RAS_ERROR_TYPE_CORRECTABLE);
+        REQUIRE(set.getTotal() == 40);
+        REQUIRE(set.updateStats(start + minutes(1)) == ZE_RESULT_SUCCESS);
+        REQUIRE(set.getDelta() == 0);
+        REQUIRE(set.getRate() == 0.0);
+        REQUIRE_FALSE(set.isRising());
+    }
+
+    SECTION("Deltas sum across categories") {
+        resetMocks();
+        RasErrorSet set(handle);
+        g_mockRasState.category[ZES_RAS_ERROR_CAT_CACHE_ERRORS] = 2;
+        g_mockRasState.category[ZES_RAS_ERROR_CAT_COMPUTE_ERRORS] = 1;
+        set.updateStats(start + minutes(1));
+        REQUIRE(set.getDelta() == 3);
+        REQUIRE(set.getTotal() == 3);
+        set.updateStats(start + minutes(2));
+        REQUIRE(set.getDelta() == 0);
+    }
+
+    SECTION("Rate covers the trailing window") {
+        resetMocks();
+        RasErrorSet set(handle, minutes(10));
+        // One error a minute for twenty minutes.
+        for (int i = 1; i <= 20; ++i) {
+            g_mockRasState.category[ZES_RAS_ERROR_CAT_CACHE_ERRORS] = i;
+            set.updateStats(start + minutes(i));
+        }
+        REQUIRE(set.getRate() == Catch::Approx(60.0));
+        REQUIRE_FALSE(set.isRising());
+
+        // Then nothing for the next ten.
+        for (int i = 21; i <= 30; ++i) {
+            set.updateStats(start + minutes(i));
+        }
+        REQUIRE(set.getRate() == 0.0);
+    }
+
+    SECTION("A climbing rate is rising") {
+        resetMocks();
+        RasErrorSet set(handle, minutes(10));
+        uint64_t count = 0;
+        for (int i = 1; i <= 10; ++i) {
+            // One a minute, then five a minute.
+            count += i <= 5 ? 1 : 5;
+            g_mockRasState.category[ZES_RAS_ERROR_CAT_NON_COMPUTE_ERRORS] = count;
+            set.updateStats(start + minutes(i));
+        }
+        REQUIRE(set.isRising());
+    }
+
+    SECTION("A cleared counter counts from zero") {
+        resetMocks();
+        g_mockRasState.category[ZES_RAS_ERROR_CAT_RESET] = 10;
+        RasErrorSet set(handle);
+        g_mockRasState.category[ZES_RAS_ERROR_CAT_RESET] = 2;
+        set.updateStats(start + minutes(1));
+        REQUIRE(set.getDelta() == 2);
+        REQUIRE(set.getTotal() == 2);
+    }
+}
+
+TEST_CASE("RAS category names", "[ras]") {
+    REQUIRE(std::string(ras_category_to_str(ZES_RAS_ERROR_CAT_CACHE_ERRORS)) == "CACHE");
+    REQUIRE(std::string(ras_category_to_str(ZES_RAS_ERROR_CAT_NON_COMPUTE_ERRORS)) == "NON_COMPUTE");
+}
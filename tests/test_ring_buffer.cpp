@@ -0,0 +1,62 @@
+#include <catch2/catch_all.hpp>
+#include "src/ring_buffer.h"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+struct Pair {
+    uint64_t a;
+    uint64_t b;
+};
+} // namespace
+
+TEST_CASE("RingBuffer keeps the most recent values", "[ring_buffer]") {
+    SECTION("Partially filled") {
+        RingBuffer<int, 8> ring;
+        std::vector<int> out;
+        REQUIRE(ring.read(out) == 0);
+        for (int i = 0; i < 3; ++i) {
+            ring.push(i);
+        }
+        REQUIRE(ring.read(out) == 3);
+        REQUIRE(out == std::vector<int>{0, 1, 2});
+    }
+
+    SECTION("Wraps and honours max") {
+        RingBuffer<int, 4> ring;
+        std::vector<int> out;
+        for (int i = 0; i < 10; ++i) {
+            ring.push(i);
+        }
+        REQUIRE(ring.getCount() == 10);
+        REQUIRE(ring.read(out) == 4);
+        REQUIRE(out == std::vector<int>{6, 7, 8, 9});
+        REQUIRE(ring.read(out, 2) == 2);
+        REQUIRE(out == std::vector<int>{8, 9});
+    }
+
+    SECTION("Readers never see torn values") {
+        RingBuffer<Pair, 16> ring;
+        std::atomic<bool> done(false);
+        std::thread writer([&]() {
+            for (uint64_t i = 0; i < 200000; ++i) {
+                ring.push({i, ~i});
+            }
+            done = true;
+        });
+
+        bool consistent = true;
+        std::vector<Pair> out;
+        while (!done) {
+            ring.read(out);
+            for (size_t i = 0; i < out.size(); ++i) {
+                consistent = consistent && out[i].b == ~out[i].a;
+                consistent = consistent && (i == 0 || out[i].a == out[i - 1].a + 1);
+            }
+        }
+        writer.join();
+        REQUIRE(consistent);
+    }
+}
@@ -0,0 +1,132 @@
+#include <catch2/catch_all.hpp>
+#include "src/schedule.h"
+#include <chrono>
+#include <string>
+
+using std::chrono::milliseconds;
+
+TEST_CASE("SamplingSchedule parses --interval", "[schedule]") {
+    SamplingSchedule schedule;
+    std::string error;
+
+    SECTION("Default is one second for everything") {
+        REQUIRE(schedule.getPeriod(COMPONENT_ENGINES) == milliseconds(1000));
+        REQUIRE(schedule.getPeriod(COMPONENT_PROCESSES) == milliseconds(1000));
+    }
+
+    SECTION("Bare durations apply to every class") {
+        milliseconds period;
+        REQUIRE(schedule.parse("500", error));
+        REQUIRE(schedule.getPeriod(COMPONENT_THERMAL) == milliseconds(500));
+        REQUIRE(schedule.parse("100ms", error));
+        REQUIRE(schedule.getPeriod(COMPONENT_POWER) == milliseconds(100));
+        REQUIRE(schedule.parse("1.5s", error));
+        REQUIRE(schedule.getPeriod(COMPONENT_MEMORY) == milliseconds(1500));
+        REQUIRE(SamplingSchedule::parseDuration("4h", period));
+        REQUIRE(period == std::chrono::hours(4));
+        REQUIRE(SamplingSchedule::parseDuration("1.5m", period));
+        REQUIRE(period == milliseconds(90000));
+    }
+
+    SECTION("Per-class periods") {
+        REQUIRE(schedule.parse("engines=50ms,thermal=2s,processes=1s", error));
+        REQUIRE(schedule.getPeriod(COMPONENT_ENGINES) == milliseconds(50));
+        REQUIRE(schedule.getPeriod(COMPONENT_THERMAL) == milliseconds(2000));
+        REQUIRE(schedule.getPeriod(COMPONENT_PROCESSES) == milliseconds(1000));
+        REQUIRE(schedule.getPeriod(COMPONENT_PSUS) == milliseconds(1000));
+        REQUIRE(schedule.getPeriod(SCHEDULE_DISPLAY) == milliseconds(1000));
+        REQUIRE(schedule.getResolution() == milliseconds(50));
+    }
+
+    SECTION("Alternate spellings name the same class") {
+        REQUIRE(schedule.parse("engine=10ms,psus=20ms,mem=30ms,temperature=40ms,process=50ms,freq=60ms,pcie=70ms",
+                               error));
+        REQUIRE(schedule.getPeriod(COMPONENT_ENGINES) == milliseconds(10));
+        REQUIRE(schedule.getPeriod(COMPONENT_PSUS) == milliseconds(20));
+        REQUIRE(schedule.getPeriod(COMPONENT_MEMORY) == milliseconds(30));
+        REQUIRE(schedule.getPeriod(COMPONENT_THERMAL) == milliseconds(40));
+        REQUIRE(schedule.getPeriod(COMPONENT_PROCESSES) == milliseconds(50));
+        REQUIRE(schedule.getPeriod(COMPONENT_FREQUENCY) == milliseconds(60));
+        REQUIRE(schedule.getPeriod(COMPONENT_PCI) == milliseconds(70));
+        REQUIRE(schedule.getPeriod(COMPONENT_RAS) == milliseconds(1000));
+    }
+
+    SECTION("Errors leave the schedule unchanged") {
+        REQUIRE_FALSE(schedule.parse("engines=50ms,bogus=1s", error));
+        REQUIRE(error.find("bogus") != std::string::npos);
+        REQUIRE_FALSE(schedule.parse("engines=fast", error));
+        REQUIRE_FALSE(schedule.parse("0ms", error));
+        REQUIRE_FALSE(schedule.parse("", error));
+        REQUIRE(schedule.getPeriod(COMPONENT_ENGINES) == milliseconds(1000));
+    }
+
+    SECTION("Resolution never goes below 10ms for coprime periods") {
+        REQUIRE(schedule.parse("engines=33ms,thermal=1s", error));
+        REQUIRE(schedule.getResolution() == milliseconds(10));
+    }
+
+    SECTION("Relaxing leaves explicit periods alone") {
+        REQUIRE(schedule.parse("thermal=500ms", error));
+        schedule.setPeriod(COMPONENT_ENGINES, milliseconds(10));
+        schedule.relax(COMPONENT_THERMAL | COMPONENT_MEMORY | COMPONENT_ENGINES, milliseconds(5000));
+        REQUIRE(schedule.getPeriod(COMPONENT_THERMAL) == milliseconds(500));
+        REQUIRE(schedule.getPeriod(COMPONENT_ENGINES) == milliseconds(10));
+        REQUIRE(schedule.getPeriod(COMPONENT_MEMORY) == milliseconds(5000));
+        REQUIRE(schedule.getPeriod(COMPONENT_POWER) == milliseconds(1000));
+
+        SamplingSchedule everything;
+        REQUIRE(everything.parse("250ms", error));
+        everything.relax(COMPONENT_MEMORY, milliseconds(5000));
+        REQUIRE(everything.getPeriod(COMPONENT_MEMORY) == milliseconds(250));
+    }
+}
+
+TEST_CASE("TimerWheel fires each timer on its own period", "[schedule]") {
+    SECTION("Short and long periods") {
+        TimerWheel wheel(8);
+        wheel.add(COMPONENT_ENGINES, 1);
+        wheel.add(COMPONENT_THERMAL, 3);
+        wheel.add(COMPONENT_MEMORY, 20); // several trips around the wheel
+
+        int engines = 0, thermal = 0, memory = 0;
+        for (int tick = 1; tick <= 60; ++tick) {
+            component_flags_t due = wheel.advance();
+            REQUIRE(due & COMPONENT_ENGINES);
+            REQUIRE(((due & COMPONENT_THERMAL) != 0) == (tick % 3 == 0));
+            REQUIRE(((due & COMPONENT_MEMORY) != 0) == (tick % 20 == 0));
+            engines += (due & COMPONENT_ENGINES) != 0;
+            thermal += (due & COMPONENT_THERMAL) != 0;
+            memory += (due & COMPONENT_MEMORY) != 0;
+        }
+        REQUIRE(engines == 60);
+        REQUIRE(thermal == 20);
+        REQUIRE(memory == 3);
+    }
+
+    SECTION("Period equal to the wheel size") {
+        TimerWheel wheel(4);
+        wheel.add(COMPONENT_POWER, 4);
+        for (int tick = 1; tick <= 16; ++tick) {
+            REQUIRE(((wheel.advance() & COMPONENT_POWER) != 0) == (tick % 4 == 0));
+        }
+    }
+
+    SECTION("Built from a schedule") {
+        SamplingSchedule schedule;
+        std::string error;
+        REQUIRE(schedule.parse("engines=50ms,thermal=2s", error));
+        TimerWheel wheel;
+        wheel.add(schedule);
+        component_flags_t seen = 0;
+        for (int tick = 1; tick <= 40; ++tick) {
+            component_flags_t due = wheel.advance();
+            REQUIRE(due & COMPONENT_ENGINES);
+            if (tick < 20) {
+                REQUIRE_FALSE(due & COMPONENT_POWER);
+            }
+            seen |= due;
+        }
+        // Everything but thermal runs every 20 ticks; thermal every 40.
+        REQUIRE(seen == (COMPONENT_ALL | SCHEDULE_DISPLAY));
+    }
+}
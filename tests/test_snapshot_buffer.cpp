@@ -0,0 +1,97 @@
+#include <catch2/catch_all.hpp>
+#include "src/snapshot_buffer.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+struct Sample {
+    uint64_t sequence = 0;
+    uint64_t doubled = 0;
+    std::vector<uint64_t> values;
+};
+}
+
+TEST_CASE("SnapshotBuffer publishing", "[snapshot]") {
+    SECTION("Readers see the default value before the first publish") {
+        SnapshotBuffer<Sample> buffer;
+        auto reader = buffer.read();
+        REQUIRE(reader->sequence == 0);
+        REQUIRE(reader->values.empty());
+    }
+
+    SECTION("Published value becomes visible") {
+        SnapshotBuffer<Sample> buffer;
+        Sample &slot = buffer.beginWrite();
+        slot.sequence = 7;
+        slot.values = {1, 2, 3};
+        buffer.publish();
+
+        auto reader = buffer.read();
+        REQUIRE(reader->sequence == 7);
+        REQUIRE(reader->values.size() == 3);
+        REQUIRE(&buffer.peekPublished() == &*reader);
+    }
+
+    SECTION("Writer never reuses a pinned slot") {
+        SnapshotBuffer<Sample, 3> buffer;
+        buffer.beginWrite().sequence = 1;
+        buffer.publish();
+        auto pinned = buffer.read();
+
+        for (uint64_t i = 2; i < 10; ++i) {
+            Sample &slot = buffer.beginWrite();
+            REQUIRE(&slot != &*pinned);
+            slot.sequence = i;
+            buffer.publish();
+        }
+        REQUIRE(pinned->sequence == 1);
+        REQUIRE(buffer.read()->sequence == 9);
+    }
+}
+
+TEST_CASE("SnapshotBuffer concurrent readers", "[snapshot]") {
+    SnapshotBuffer<Sample> buffer;
+    std::atomic<bool> done(false);
+    std::atomic<uint64_t> torn(0);
+    std::atomic<uint64_t> backwards(0);
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&]() {
+            uint64_t last = 0;
+            while (!done.load()) {
+                auto snapshot = buffer.read();
+                if (snapshot->doubled != snapshot->sequence * 2 ||
+                    snapshot->values.size() != snapshot->sequence % 17) {
+                    torn++;
+                }
+                for (uint64_t v : snapshot->values) {
+                    if (v != snapshot->sequence) {
+                        torn++;
+                    }
+                }
+                if (snapshot->sequence < last) {
+                    backwards++;
+                }
+                last = snapshot->sequence;
+            }
+        });
+    }
+
+    for (uint64_t i = 1; i <= 20000; ++i) {
+        Sample &slot = buffer.beginWrite();
+        slot.sequence = i;
+        slot.values.assign(i % 17, i);
+        slot.doubled = i * 2;
+        buffer.publish();
+    }
+    done = true;
+    for (auto &reader : readers) {
+        reader.join();
+    }
+
+    REQUIRE(torn.load() == 0);
+    REQUIRE(backwards.load() == 0);
+    REQUIRE(buffer.read()->sequence == 20000);
+}
@@ -0,0 +1,119 @@
+#include <catch2/catch_all.hpp>
+#include "src/statistics.h"
+#include <chrono>
+#include <vector>
+
+using std::chrono::milliseconds;
+
+TEST_CASE("QuantileSketch", "[statistics]") {
+    QuantileSketch sketch;
+    for (int i = 1; i <= 1000; ++i) {
+        sketch.add(i / 10.0);
+    }
+    REQUIRE(sketch.getCount() == 1000);
+    REQUIRE(sketch.quantile(0.5) == Catch::Approx(50.0).epsilon(0.02));
+    REQUIRE(sketch.quantile(0.99) == Catch::Approx(99.0).epsilon(0.02));
+
+    for (int i = 1; i <= 500; ++i) {
+        sketch.remove(i / 10.0);
+    }
+    REQUIRE(sketch.getCount() == 500);
+    REQUIRE(sketch.quantile(0.0) == Catch::Approx(50.1).epsilon(0.02));
+    REQUIRE(sketch.quantile(0.5) == Catch::Approx(75.0).epsilon(0.02));
+
+    QuantileSketch zeros;
+    zeros.add(0.0);
+    zeros.add(0.0);
+    REQUIRE(zeros.quantile(0.5) == 0.0);
+}
+
+TEST_CASE("SlidingWindow", "[statistics]") {
+    SECTION("Window only reflects the most recent values") {
+        SlidingWindow window(4);
+        for (double value : {100.0, 1.0, 2.0, 3.0, 4.0}) {
+            window.add(value);
+        }
+        StatisticsSummary summary = window.summarize();
+        REQUIRE(summary.count == 4);
+        REQUIRE(summary.min == Catch::Approx(1.0));
+        REQUIRE(summary.max == Catch::Approx(4.0));
+        REQUIRE(summary.mean == Catch::Approx(2.5));
+        REQUIRE(summary.stddev == Catch::Approx(1.118).epsilon(0.001));
+    }
+
+    SECTION("Min and max track across many laps") {
+        SlidingWindow window(10);
+        for (int i = 0; i < 1000; ++i) {
+            window.add((i * 37) % 100);
+            StatisticsSummary summary = window.summarize();
+            double lo = 1e9, hi = -1e9;
+            for (int j = std::max(0, i - 9); j <= i; ++j) {
+                lo = std::min(lo, (double)((j * 37) % 100));
+                hi = std::max(hi, (double)((j * 37) % 100));
+            }
+            REQUIRE(summary.min == Catch::Approx(lo));
+            REQUIRE(summary.max == Catch::Approx(hi));
+        }
+    }
+
+    SECTION("Session keeps everything") {
+        SlidingWindow session(0);
+        for (int i = 1; i <= 100; ++i) {
+            session.add(i);
+        }
+        StatisticsSummary summary = session.summarize();
+        REQUIRE(summary.count == 100);
+        REQUIRE(summary.min == Catch::Approx(1.0));
+        REQUIRE(summary.max == Catch::Approx(100.0));
+        REQUIRE(summary.mean == Catch::Approx(50.5));
+        REQUIRE(summary.p95 == Catch::Approx(95.0).epsilon(0.02));
+    }
+}
+
+TEST_CASE("LinearTrend", "[statistics]") {
+    SECTION("Slope of a straight line") {
+        LinearTrend trend(10);
+        REQUIRE(trend.getSlope() == 0.0);
+        for (int i = 0; i < 5; ++i) {
+            trend.add(1000.0 + i * 2.0, 40.0 + i);
+        }
+        REQUIRE(trend.getCount() == 5);
+        REQUIRE(trend.getSlope() == Catch::Approx(0.5));
+    }
+
+    SECTION("Only the most recent points count") {
+        LinearTrend trend(4);
+        for (int i = 0; i < 10; ++i) {
+            trend.add(i, 50.0 + i);
+        }
+        for (int i = 10; i < 14; ++i) {
+            trend.add(i, 60.0 - (i - 10) * 2.0);
+        }
+        REQUIRE(trend.getCount() == 4);
+        REQUIRE(trend.getSlope() == Catch::Approx(-2.0));
+    }
+
+    SECTION("No time spread means no slope") {
+        LinearTrend trend(4);
+        trend.add(5.0, 40.0);
+        trend.add(5.0, 60.0);
+        REQUIRE(trend.getSlope() == 0.0);
+    }
+}
+
+TEST_CASE("MetricStatistics windows", "[statistics]") {
+    MetricStatistics stats({milliseconds(60000), milliseconds(300000), milliseconds(0)}, milliseconds(1000));
+    for (int i = 0; i < 600; ++i) {
+        stats.add(i < 300 ? 10.0 : 90.0);
+    }
+    std::vector<StatisticsSummary> summaries;
+    stats.summarize(summaries);
+    REQUIRE(summaries.size() == 3);
+    REQUIRE(summaries[0].count == 60);
+    REQUIRE(summaries[0].p50 == Catch::Approx(90.0));
+    REQUIRE(summaries[1].count == 300);
+    REQUIRE(summaries[2].count == 600);
+    REQUIRE(summaries[2].mean == Catch::Approx(50.0));
+    REQUIRE(statistics_window_label(milliseconds(60000)) == "1m");
+    REQUIRE(statistics_window_label(milliseconds(0)) == "session");
+}
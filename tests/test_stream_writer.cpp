@@ -0,0 +1,204 @@
+#include <catch2/catch_all.hpp>
+#include "src/stream_writer.h"
+#include <chrono>
+#include <csignal>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+DeviceLabels makeLabels(int index) {
+    DeviceLabels labels;
+    labels.uuid = "00000000-0000-0000-0000-00000000000" + std::to_string(index);
+    labels.bdf = "0000:0" + std::to_string(index) + ":00.0";
+    labels.engines = {{"ZES_ENGINE_GROUP_COMPUTE_ALL", -1}, {"ZES_ENGINE_GROUP_COPY_ALL", 1}};
+    labels.powerDomains = {{"", -1}};
+    labels.temperatures = {{"GPU", 0}, {"MEMORY", 0}};
+    return labels;
+}
+
+DeviceSnapshot makeSnapshot(size_t processes = 1) {
+    DeviceSnapshot snapshot;
+    snapshot.sequence = 7;
+    snapshot.timestamp = std::chrono::steady_clock::now();
+    snapshot.components = COMPONENT_ENGINES | COMPONENT_POWER | COMPONENT_THERMAL | COMPONENT_MEMORY |
+                          COMPONENT_PROCESSES;
+    snapshot.engineUtilization = {50.0, 0.0};
+    PowerSample power;
+    power.power = 120.5;
+    power.sessionEnergy = 1000;
+    snapshot.powerDomains = {power};
+    snapshot.temperatures = {60.0, 70.0};
+    snapshot.temperatureSensors.resize(2);
+    snapshot.temperatureSensors[0].valid = true;
+    snapshot.memory.size = 1000;
+    snapshot.memory.free = 250;
+    for (size_t i = 0; i < processes; ++i) {
+        ProcessSample process = {};
+        process.pid = 1000 + (uint32_t)i;
+        process.name = "python3, \"train\"";
+        process.used_memory = 4096;
+        process.energy = -1;
+        if (i == 0) {
+            process.drm.valid = true;
+            process.drm.utilization[0] = 75;
+            process.energy = 12.5;
+        }
+        snapshot.processes.push_back(process);
+    }
+    return snapshot;
+}
+
+// Everything written to a temporary file by write.
+template <typename Write> std::string capture(Write write) {
+    char path[] = "/tmp/ze-monitor-stream-XXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    unlink(path);
+    write(fd);
+
+    std::string output;
+    char buffer[4096];
+    ssize_t count;
+    lseek(fd, 0, SEEK_SET);
+    while ((count = read(fd, buffer, sizeof(buffer))) > 0) {
+        output.append(buffer, count);
+    }
+    close(fd);
+    return output;
+}
+
+size_t countLines(const std::string &text) {
+    size_t lines = 0;
+    for (char c : text) {
+        lines += c == '\n';
+    }
+    return lines;
+}
+} // namespace
+
+TEST_CASE("Stream formats", "[stream]") {
+    StreamFormat format = StreamFormat::CSV;
+    REQUIRE(parse_stream_format("jsonl", format));
+    REQUIRE(format == StreamFormat::JSONL);
+    REQUIRE(parse_stream_format("csv", format));
+    REQUIRE(format == StreamFormat::CSV);
+    REQUIRE_FALSE(parse_stream_format("json", format));
+}
+
+TEST_CASE("JSON Lines records", "[stream]") {
+    DeviceSnapshot snapshot = makeSnapshot();
+    std::string output = capture([&](int fd) {
+        StreamWriter writer(fd, StreamFormat::JSONL, {makeLabels(1), makeLabels(2)});
+        REQUIRE(writer.write({&snapshot, &snapshot}));
+        REQUIRE(writer.write({&snapshot, &snapshot}));
+        REQUIRE(writer.getRecordCount() == 4);
+    });
+
+    REQUIRE(countLines(output) == 4);
+    std::string first = output.substr(0, output.find('\n'));
+    REQUIRE(first.rfind("{\"time\":", 0) == 0);
+    REQUIRE(first.back() == '}');
+    REQUIRE(first.find(",\"sequence\":7,\"uuid\":\"00000000-0000-0000-0000-000000000001\","
+                       "\"bdf\":\"0000:01:00.0\"") != std::string::npos);
+    REQUIRE(first.find("\"engines\":[{\"index\":0,\"type\":\"ZES_ENGINE_GROUP_COMPUTE_ALL\",\"utilization\":50.0},"
+                       "{\"index\":1,\"type\":\"ZES_ENGINE_GROUP_COPY_ALL\",\"subdevice\":1,\"utilization\":0.0}]") !=
+            std::string::npos);
+    REQUIRE(first.find("\"temperatures\":[{\"index\":0,\"type\":\"GPU\",\"subdevice\":0,\"celsius\":60.0},"
+                       "{\"index\":1,\"type\":\"MEMORY\",\"subdevice\":0,\"celsius\":null}]") != std::string::npos);
+    REQUIRE(first.find("\"power\":[{\"index\":0,\"watts\":120.50,\"energy\":1000.000}]") != std::string::npos);
+    REQUIRE(first.find("\"memory\":{\"size\":1000,\"free\":250}") != std::string::npos);
+    REQUIRE(first.find("\"processes\":[{\"pid\":1000,\"name\":\"python3, \\\"train\\\"\",\"memory\":4096,"
+                       "\"utilization\":75,\"energy\":12.500}]") != std::string::npos);
+    REQUIRE(output.find("\"bdf\":\"0000:02:00.0\"") != std::string::npos);
+}
+
+TEST_CASE("CSV rows", "[stream]") {
+    DeviceSnapshot snapshot = makeSnapshot(2);
+    snapshot.components &= ~COMPONENT_MEMORY;
+    std::string output = capture([&](int fd) {
+        StreamWriter writer(fd, StreamFormat::CSV, {makeLabels(1)});
+        REQUIRE(writer.write({&snapshot}));
+        REQUIRE(writer.write({&snapshot}));
+    });
+
+    SECTION("The header is written once") {
+        REQUIRE(output.rfind("time,sequence,bdf,metric,index,type,subdevice,value\n", 0) == 0);
+        REQUIRE(output.find("time,", 1) == std::string::npos);
+    }
+
+    SECTION("A row per value") {
+        // 2 engines, 1 temperature, power and energy, then memory for both
+        // processes, and utilization and energy for the first.
+        REQUIRE(countLines(output) == 1 + 2 * 9);
+        REQUIRE(output.find(",7,0000:01:00.0,engine_utilization,0,ZES_ENGINE_GROUP_COMPUTE_ALL,,50.0\n") !=
+                std::string::npos);
+        REQUIRE(output.find(",7,0000:01:00.0,engine_utilization,1,ZES_ENGINE_GROUP_COPY_ALL,1,0.0\n") !=
+                std::string::npos);
+        REQUIRE(output.find(",7,0000:01:00.0,temperature_celsius,0,GPU,0,60.0\n") != std::string::npos);
+        REQUIRE(output.find("temperature_celsius,1,") == std::string::npos);
+        REQUIRE(output.find(",7,0000:01:00.0,power_watts,0,,,120.50\n") != std::string::npos);
+        REQUIRE(output.find(",7,0000:01:00.0,energy_joules,0,,,1000.000\n") != std::string::npos);
+        REQUIRE(output.find("memory_size") == std::string::npos);
+    }
+
+    SECTION("Process names are quoted") {
+        REQUIRE(output.find(",7,0000:01:00.0,process_memory,1000,\"python3, \"\"train\"\"\",,4096\n") !=
+                std::string::npos);
+        REQUIRE(output.find(",7,0000:01:00.0,process_utilization,1000,\"python3, \"\"train\"\"\",,75\n") !=
+                std::string::npos);
+        REQUIRE(output.find(",7,0000:01:00.0,process_energy,1000,\"python3, \"\"train\"\"\",,12.500\n") !=
+                std::string::npos);
+        REQUIRE(output.find("process_energy,1001,") == std::string::npos);
+    }
+}
+
+TEST_CASE("A failed write is reported", "[stream]") {
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+    close(fds[0]);
+    DeviceSnapshot snapshot = makeSnapshot();
+    StreamWriter writer(fds[1], StreamFormat::JSONL, {makeLabels(1)});
+    // Writing to a pipe with no reader raises SIGPIPE unless it is ignored.
+    struct sigaction ignore = {}, previous;
+    ignore.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &ignore, &previous);
+    REQUIRE_FALSE(writer.write({&snapshot}));
+    sigaction(SIGPIPE, &previous, nullptr);
+    close(fds[1]);
+}
+
+TEST_CASE("Streaming 8 devices", "[stream][!benchmark]") {
+    std::vector<DeviceLabels> labels;
+    for (int i = 0; i < 8; ++i) {
+        labels.push_back(makeLabels(i));
+    }
+    DeviceSnapshot snapshot = makeSnapshot(16);
+    std::vector<const DeviceSnapshot *> snapshots(8, &snapshot);
+    int fd = open("/dev/null", O_WRONLY | O_CLOEXEC);
+    REQUIRE(fd >= 0);
+
+    StreamWriter jsonl(fd, StreamFormat::JSONL, labels);
+    StreamWriter csv(fd, StreamFormat::CSV, labels);
+    BENCHMARK("JSON Lines, 8 records of 16 processes") {
+        return jsonl.write(snapshots);
+    };
+    BENCHMARK("CSV, 8 records of 16 processes") {
+        return csv.write(snapshots);
+    };
+
+    // Sustained rate over a fixed amount of time.
+    for (StreamWriter *writer : {&jsonl, &csv}) {
+        uint64_t before = writer->getRecordCount();
+        auto start = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::steady_clock::duration::zero();
+        while (elapsed < std::chrono::seconds(1)) {
+            writer->write(snapshots);
+            elapsed = std::chrono::steady_clock::now() - start;
+        }
+        double rate = (writer->getRecordCount() - before) / std::chrono::duration<double>(elapsed).count();
+        WARN((writer == &jsonl ? "JSON Lines: " : "CSV: ") << (uint64_t)rate << " records/s");
+    }
+    close(fd);
+}
@@ -1,6 +1,10 @@
 #include <catch2/catch_all.hpp>
+#include "src/fan.h"
+#include "src/helpers.h"
 #include "src/temperature.h"  // Update path if needed
+#include <chrono>
 #include <memory>
+#include <string>
 #include "ze_mock.h"
 
 TEST_CASE("TemperatureMonitor initialization", "[temperature]") {
@@ -137,4 +141,151 @@ TEST_CASE("TemperatureMonitor edge cases", "[temperature]") {
         REQUIRE(monitor.getTemperature(0) == Catch::Approx(-10.5));
         REQUIRE(monitor.getTemperature(1) == Catch::Approx(120.0));
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("TemperatureMonitor sensor properties and isolation", "[temperature]") {
+    zes_device_handle_t dummyDevice = reinterpret_cast<zes_device_handle_t>(123);
+
+    SECTION("Properties and thresholds set the limits") {
+        resetMocks();
+        g_mockTempProperties.type = ZES_TEMP_SENSORS_MEMORY;
+        g_mockTempProperties.maxTemperature = 100.0;
+        g_mockTempConfig.threshold1.enableLowToHigh = true;
+        g_mockTempConfig.threshold1.threshold = 85.0;
+
+        TemperatureMonitor monitor(dummyDevice);
+        REQUIRE(monitor.getProperties(0) != nullptr);
+        REQUIRE(monitor.getProperties(0)->type == ZES_TEMP_SENSORS_MEMORY);
+        REQUIRE(std::string(temp_sensor_to_str(monitor.getProperties(0)->type)) == "MEMORY");
+        REQUIRE(monitor.getThrottleTemperature(0) == Catch::Approx(100.0));
+        REQUIRE(monitor.getWarmTemperature(0) == Catch::Approx(85.0));
+    }
+
+    SECTION("Sensors without properties fall back to defaults") {
+        resetMocks();
+        g_tempPropertiesResult = ZE_RESULT_ERROR_UNSUPPORTED_FEATURE;
+        g_tempConfigResult = ZE_RESULT_ERROR_INSUFFICIENT_PERMISSIONS;
+
+        TemperatureMonitor monitor(dummyDevice);
+        REQUIRE(monitor.getSensorCount() == 3);
+        REQUIRE(monitor.getProperties(0) == nullptr);
+        REQUIRE(monitor.getConfig(0) == nullptr);
+        REQUIRE(monitor.getThrottleTemperature(0) == Catch::Approx(DEFAULT_THROTTLE_TEMPERATURE));
+        REQUIRE(monitor.getWarmTemperature(0) == Catch::Approx(DEFAULT_THROTTLE_TEMPERATURE - WARM_MARGIN));
+    }
+
+    SECTION("One failing sensor doesn't stop the others") {
+        resetMocks();
+        TemperatureMonitor monitor(dummyDevice);
+        REQUIRE(monitor.updateTemperatures() == ZE_RESULT_SUCCESS);
+
+        g_mockTemperatures = {50.0, 60.0, 70.0};
+        g_getTempResult = ZE_RESULT_ERROR_DEVICE_LOST;
+        g_failSensorIndex = 1;
+        REQUIRE(monitor.updateTemperatures() == ZE_RESULT_ERROR_DEVICE_LOST);
+        REQUIRE(monitor.isValid(0));
+        REQUIRE_FALSE(monitor.isValid(1));
+        REQUIRE(monitor.isValid(2));
+        REQUIRE(monitor.getTemperature(0) == Catch::Approx(50.0));
+        // The failed sensor keeps its last reading.
+        REQUIRE(monitor.getTemperature(1) == Catch::Approx(52.8));
+        REQUIRE(monitor.getTemperature(2) == Catch::Approx(70.0));
+    }
+}
+
+TEST_CASE("TemperatureMonitor time to throttle", "[temperature]") {
+    zes_device_handle_t dummyDevice = reinterpret_cast<zes_device_handle_t>(123);
+    auto start = std::chrono::steady_clock::now();
+
+    SECTION("A steady climb predicts when the limit is reached") {
+        resetMocks();
+        g_sensorCount = 1;
+        g_mockTempProperties.maxTemperature = 100.0;
+        TemperatureMonitor monitor(dummyDevice, 10);
+
+        // Half a degree a second, from 80°C to 84.5°C.
+        for (int i = 0; i < 10; ++i) {
+            g_mockTemperatures = {80.0 + i * 0.5};
+            monitor.updateTemperatures(start + std::chrono::seconds(i));
+        }
+        REQUIRE(monitor.getSlope(0) == Catch::Approx(0.5));
+        REQUIRE(monitor.getTimeToThrottle(0) == Catch::Approx(31.0));
+    }
+
+    SECTION("Too few readings, cooling, or already there") {
+        resetMocks();
+        g_sensorCount = 1;
+        g_mockTempProperties.maxTemperature = 100.0;
+        TemperatureMonitor monitor(dummyDevice, 10);
+
+        g_mockTemperatures = {80.0};
+        monitor.updateTemperatures(start);
+        g_mockTemperatures = {85.0};
+        monitor.updateTemperatures(start + std::chrono::seconds(1));
+        REQUIRE(monitor.getTimeToThrottle(0) < 0);
+
+        for (int i = 2; i < 10; ++i) {
+            g_mockTemperatures = {85.0 - i};
+            monitor.updateTemperatures(start + std::chrono::seconds(i));
+        }
+        REQUIRE(monitor.getTimeToThrottle(0) < 0);
+
+        g_mockTemperatures = {101.0};
+        monitor.updateTemperatures(start + std::chrono::seconds(10));
+        REQUIRE(monitor.getTimeToThrottle(0) == 0.0);
+    }
+
+    SECTION("A sensor that fails after a hot reading predicts nothing") {
+        resetMocks();
+        g_sensorCount = 1;
+        g_mockTempProperties.maxTemperature = 100.0;
+        TemperatureMonitor monitor(dummyDevice, 10);
+
+        g_mockTemperatures = {101.0};
+        monitor.updateTemperatures(start);
+        REQUIRE(monitor.getTimeToThrottle(0) == 0.0);
+
+        g_getTempResult = ZE_RESULT_ERROR_DEVICE_LOST;
+        monitor.updateTemperatures(start + std::chrono::seconds(1));
+        REQUIRE_FALSE(monitor.isValid(0));
+        REQUIRE(monitor.getTimeToThrottle(0) < 0);
+    }
+}
+
+TEST_CASE("Fan speed", "[temperature]") {
+    zes_fan_handle_t handle = reinterpret_cast<zes_fan_handle_t>(1);
+
+    SECTION("RPM where supported, with a percentage of the maximum") {
+        resetMocks();
+        g_mockFanProperties.supportedUnits = (1 << ZES_FAN_SPEED_UNITS_RPM) | (1 << ZES_FAN_SPEED_UNITS_PERCENT);
+        g_mockFanProperties.maxRPM = 4000;
+        g_mockFanSpeed = 1000;
+        Fan fan(handle);
+        REQUIRE(fan.getUnits() == ZES_FAN_SPEED_UNITS_RPM);
+        REQUIRE(fan.getSpeed() == 1000);
+        REQUIRE(fan.getPercent() == Catch::Approx(25.0));
+    }
+
+    SECTION("Percent-only fans") {
+        resetMocks();
+        g_mockFanProperties.supportedUnits = 1 << ZES_FAN_SPEED_UNITS_PERCENT;
+        g_mockFanSpeed = 60;
+        Fan fan(handle);
+        REQUIRE(fan.getUnits() == ZES_FAN_SPEED_UNITS_PERCENT);
+        REQUIRE(fan.getPercent() == Catch::Approx(60.0));
+    }
+
+    SECTION("Unmeasurable speed") {
+        resetMocks();
+        g_mockFanProperties.supportedUnits = 1 << ZES_FAN_SPEED_UNITS_RPM;
+        g_mockFanSpeed = -1;
+        Fan fan(handle);
+        REQUIRE(fan.getPercent() < 0);
+    }
+
+    SECTION("A fan that can't be read") {
+        resetMocks();
+        g_fanStateResult = ZE_RESULT_ERROR_DEVICE_LOST;
+        REQUIRE_THROWS_AS(Fan(handle), std::runtime_error);
+    }
+}
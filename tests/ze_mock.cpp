@@ -8,6 +8,35 @@ uint32_t g_sensorCount = 3;
 ze_result_t g_getTempResult = ZE_RESULT_SUCCESS;
 std::vector<double> g_mockTemperatures = {45.5, 52.8, 39.2};
 bool g_enumSensorsCalledOnce = false;
+int g_failSensorIndex = -1;
+zes_temp_properties_t g_mockTempProperties = {};
+ze_result_t g_tempPropertiesResult = ZE_RESULT_SUCCESS;
+zes_temp_config_t g_mockTempConfig = {};
+ze_result_t g_tempConfigResult = ZE_RESULT_SUCCESS;
+uint32_t g_fanCount = 0;
+zes_fan_properties_t g_mockFanProperties = {};
+int32_t g_mockFanSpeed = 0;
+ze_result_t g_fanStateResult = ZE_RESULT_SUCCESS;
+std::vector<zes_engine_stats_t> g_mockEngineStats;
+static size_t g_engineStatsIndex = 0;
+ze_result_t g_memoryBandwidthResult = ZE_RESULT_SUCCESS;
+std::vector<zes_mem_bandwidth_t> g_mockMemoryBandwidth;
+static size_t g_memoryBandwidthIndex = 0;
+zes_freq_state_t g_mockFrequencyState = {};
+ze_result_t g_throttleTimeResult = ZE_RESULT_SUCCESS;
+std::vector<zes_freq_throttle_time_t> g_mockThrottleTimes;
+static size_t g_throttleTimeIndex = 0;
+zes_pci_state_t g_mockPciState = {};
+ze_result_t g_pciStateResult = ZE_RESULT_SUCCESS;
+ze_result_t g_pciStatsResult = ZE_RESULT_SUCCESS;
+std::vector<zes_pci_stats_t> g_mockPciStats;
+static size_t g_pciStatsIndex = 0;
+std::vector<zes_power_energy_counter_t> g_mockEnergyCounters;
+static size_t g_energyCounterIndex = 0;
+std::vector<zes_power_limit_ext_desc_t> g_mockPowerLimits;
+ze_result_t g_powerLimitsResult = ZE_RESULT_SUCCESS;
+zes_ras_state_t g_mockRasState = {};
+std::vector<zes_process_state_t> g_mockProcesses;
 
 // Mock Implementation of `zesDeviceGetProperties`
 ze_result_t zesDeviceGetProperties(zes_device_handle_t device, zes_device_properties_t* pProperties) {
@@ -25,6 +54,33 @@ ze_result_t zesDevicePciGetProperties(zes_device_handle_t device, zes_pci_proper
     return ZE_RESULT_SUCCESS;
 }
 
+// Mock Implementation of `zesDevicePciGetState`
+ze_result_t zesDevicePciGetState(zes_device_handle_t device, zes_pci_state_t* pState) {
+    if (!pState) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    if (g_pciStateResult != ZE_RESULT_SUCCESS) {
+        return g_pciStateResult;
+    }
+    *pState = g_mockPciState;
+    return ZE_RESULT_SUCCESS;
+}
+
+// Mock Implementation of `zesDevicePciGetStats`
+ze_result_t zesDevicePciGetStats(zes_device_handle_t device, zes_pci_stats_t* pStats) {
+    if (!pStats) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    if (g_pciStatsResult != ZE_RESULT_SUCCESS) {
+        return g_pciStatsResult;
+    }
+    if (g_mockPciStats.empty()) {
+        *pStats = {};
+        return ZE_RESULT_SUCCESS;
+    }
+    *pStats = g_mockPciStats[g_pciStatsIndex];
+    if (g_pciStatsIndex + 1 < g_mockPciStats.size()) {
+        g_pciStatsIndex++;
+    }
+    return ZE_RESULT_SUCCESS;
+}
+
 // Mock Implementation of `zesDeviceEnumEngineGroups`
 ze_result_t zesDeviceEnumEngineGroups(zes_device_handle_t device, uint32_t* pCount, zes_engine_handle_t* phEngines) {
     if (!pCount) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
@@ -70,6 +126,48 @@ ze_result_t zesDeviceEnumPsus(zes_device_handle_t device, uint32_t* pCount, zes_
     return ZE_RESULT_SUCCESS;
 }
 
+// Mock Implementation of `zesPsuGetProperties`
+ze_result_t zesPsuGetProperties(zes_psu_handle_t hPsu, zes_psu_properties_t* pProperties) {
+    if (!pProperties) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    return ZE_RESULT_SUCCESS;
+}
+
+// Mock Implementation of `zesPsuGetState`
+ze_result_t zesPsuGetState(zes_psu_handle_t hPsu, zes_psu_state_t* pState) {
+    if (!pState) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    return ZE_RESULT_SUCCESS;
+}
+
+// Mock Implementation of `zesDeviceEnumFrequencyDomains`
+ze_result_t zesDeviceEnumFrequencyDomains(zes_device_handle_t device, uint32_t* pCount, zes_freq_handle_t* phFrequency) {
+    if (!pCount) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+
+    if (!phFrequency) {
+        *pCount = 1; // Assume 1 frequency domain
+        return ZE_RESULT_SUCCESS;
+    }
+
+    for (uint32_t i = 0; i < *pCount; i++) {
+        phFrequency[i] = reinterpret_cast<zes_freq_handle_t>(i + 1);
+    }
+    return ZE_RESULT_SUCCESS;
+}
+
+// Mock Implementation of `zesDeviceEnumRasErrorSets`
+ze_result_t zesDeviceEnumRasErrorSets(zes_device_handle_t device, uint32_t* pCount, zes_ras_handle_t* phRas) {
+    if (!pCount) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+
+    if (!phRas) {
+        *pCount = 1; // Assume 1 RAS error set
+        return ZE_RESULT_SUCCESS;
+    }
+
+    for (uint32_t i = 0; i < *pCount; i++) {
+        phRas[i] = reinterpret_cast<zes_ras_handle_t>(i + 1);
+    }
+    return ZE_RESULT_SUCCESS;
+}
+
 // Mock Implementation of `zesDeviceEnumMemoryModules`
 ze_result_t zesDeviceEnumMemoryModules(zes_device_handle_t device, uint32_t* pCount, zes_mem_handle_t* phMemory) {
     if (!pCount) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
@@ -94,6 +192,133 @@ ze_result_t zesMemoryGetState(zes_mem_handle_t hMemory, zes_mem_state_t* pState)
     return ZE_RESULT_SUCCESS;
 }
 
+// Mock Implementation of `zesMemoryGetProperties`
+ze_result_t zesMemoryGetProperties(zes_mem_handle_t hMemory, zes_mem_properties_t* pProperties) {
+    if (!pProperties) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    pProperties->type = ZES_MEM_TYPE_GDDR6;
+    pProperties->location = ZES_MEM_LOC_DEVICE;
+    pProperties->physicalSize = 1024 * 1024 * 1024;
+    return ZE_RESULT_SUCCESS;
+}
+
+// Mock Implementation of `zesMemoryGetBandwidth`
+ze_result_t zesMemoryGetBandwidth(zes_mem_handle_t hMemory, zes_mem_bandwidth_t* pBandwidth) {
+    if (!pBandwidth) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    if (g_memoryBandwidthResult != ZE_RESULT_SUCCESS) {
+        return g_memoryBandwidthResult;
+    }
+    if (g_mockMemoryBandwidth.empty()) {
+        *pBandwidth = {};
+        return ZE_RESULT_SUCCESS;
+    }
+    *pBandwidth = g_mockMemoryBandwidth[g_memoryBandwidthIndex];
+    if (g_memoryBandwidthIndex + 1 < g_mockMemoryBandwidth.size()) {
+        g_memoryBandwidthIndex++;
+    }
+    return ZE_RESULT_SUCCESS;
+}
+
+// Mock Implementation of `zesFrequencyGetProperties`
+ze_result_t zesFrequencyGetProperties(zes_freq_handle_t hFrequency, zes_freq_properties_t* pProperties) {
+    if (!pProperties) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    pProperties->type = ZES_FREQ_DOMAIN_GPU;
+    pProperties->min = 300;
+    pProperties->max = 2400;
+    return ZE_RESULT_SUCCESS;
+}
+
+// Mock Implementation of `zesFrequencyGetState`
+ze_result_t zesFrequencyGetState(zes_freq_handle_t hFrequency, zes_freq_state_t* pState) {
+    if (!pState) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    *pState = g_mockFrequencyState;
+    return ZE_RESULT_SUCCESS;
+}
+
+// Mock Implementation of `zesFrequencyGetThrottleTime`
+ze_result_t zesFrequencyGetThrottleTime(zes_freq_handle_t hFrequency, zes_freq_throttle_time_t* pThrottleTime) {
+    if (!pThrottleTime) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    if (g_throttleTimeResult != ZE_RESULT_SUCCESS) {
+        return g_throttleTimeResult;
+    }
+    if (g_mockThrottleTimes.empty()) {
+        *pThrottleTime = {};
+        return ZE_RESULT_SUCCESS;
+    }
+    *pThrottleTime = g_mockThrottleTimes[g_throttleTimeIndex];
+    if (g_throttleTimeIndex + 1 < g_mockThrottleTimes.size()) {
+        g_throttleTimeIndex++;
+    }
+    return ZE_RESULT_SUCCESS;
+}
+
+// Mock Implementation of `zesPowerGetProperties`
+ze_result_t zesPowerGetProperties(zes_pwr_handle_t hPower, zes_power_properties_t* pProperties) {
+    if (!pProperties) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    return ZE_RESULT_SUCCESS;
+}
+
+// Mock Implementation of `zesPowerGetEnergyCounter`
+ze_result_t zesPowerGetEnergyCounter(zes_pwr_handle_t hPower, zes_power_energy_counter_t* pEnergy) {
+    if (!pEnergy) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    if (g_mockEnergyCounters.empty()) {
+        *pEnergy = {};
+        return ZE_RESULT_SUCCESS;
+    }
+    *pEnergy = g_mockEnergyCounters[g_energyCounterIndex];
+    if (g_energyCounterIndex + 1 < g_mockEnergyCounters.size()) {
+        g_energyCounterIndex++;
+    }
+    return ZE_RESULT_SUCCESS;
+}
+
+// Mock Implementation of `zesPowerGetLimitsExt`
+ze_result_t zesPowerGetLimitsExt(zes_pwr_handle_t hPower, uint32_t* pCount, zes_power_limit_ext_desc_t* pSustained) {
+    if (!pCount) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    if (g_powerLimitsResult != ZE_RESULT_SUCCESS) return g_powerLimitsResult;
+    if (pSustained) {
+        for (uint32_t i = 0; i < *pCount && i < g_mockPowerLimits.size(); i++) {
+            pSustained[i] = g_mockPowerLimits[i];
+        }
+    }
+    *pCount = g_mockPowerLimits.size();
+    return ZE_RESULT_SUCCESS;
+}
+
+// Mock Implementation of `zesRasGetProperties`
+ze_result_t zesRasGetProperties(zes_ras_handle_t hRas, zes_ras_properties_t* pProperties) {
+    if (!pProperties) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    pProperties->type = ZES_RAS_ERROR_TYPE_CORRECTABLE;
+    return ZE_RESULT_SUCCESS;
+}
+
+// Mock Implementation of `zesRasGetState`
+ze_result_t zesRasGetState(zes_ras_handle_t hRas, ze_bool_t clear, zes_ras_state_t* pState) {
+    if (!pState) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    *pState = g_mockRasState;
+    if (clear) {
+        g_mockRasState = {};
+    }
+    return ZE_RESULT_SUCCESS;
+}
+
+// Mock Implementation of `zesDeviceProcessesGetState`
+ze_result_t zesDeviceProcessesGetState(zes_device_handle_t device, uint32_t* pCount, zes_process_state_t* pProcesses) {
+    if (!pCount) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    if (!pProcesses || *pCount == 0) {
+        *pCount = g_mockProcesses.size();
+        return ZE_RESULT_SUCCESS;
+    }
+    if (*pCount < g_mockProcesses.size()) {
+        *pCount = g_mockProcesses.size();
+        return ZE_RESULT_ERROR_INVALID_SIZE;
+    }
+    *pCount = g_mockProcesses.size();
+    for (uint32_t i = 0; i < *pCount; i++) {
+        pProcesses[i] = g_mockProcesses[i];
+    }
+    return ZE_RESULT_SUCCESS;
+}
+
 ze_result_t zesDeviceEnumTemperatureSensors(zes_device_handle_t device, uint32_t* pCount, zes_temp_handle_t* pSensors) {
     if (g_enumSensorsResult != ZE_RESULT_SUCCESS) {
         return g_enumSensorsResult;
@@ -118,12 +343,12 @@ ze_result_t zesDeviceEnumTemperatureSensors(zes_device_handle_t device, uint32_t
 }
 
 ze_result_t zesTemperatureGetState(zes_temp_handle_t hTemperature, double* pTemperature) {
-    if (g_getTempResult != ZE_RESULT_SUCCESS) {
-        return g_getTempResult;
-    }
-
     // Convert the handle back to an index
     uintptr_t index = reinterpret_cast<uintptr_t>(hTemperature) - 1;
+
+    if (g_getTempResult != ZE_RESULT_SUCCESS && (g_failSensorIndex < 0 || (uintptr_t)g_failSensorIndex == index)) {
+        return g_getTempResult;
+    }
     
     if (index < g_mockTemperatures.size()) {
         *pTemperature = g_mockTemperatures[index];
@@ -133,11 +358,105 @@ ze_result_t zesTemperatureGetState(zes_temp_handle_t hTemperature, double* pTemp
     return ZE_RESULT_ERROR_INVALID_ARGUMENT;
 }
 
+// Mock Implementation of `zesTemperatureGetProperties`
+ze_result_t zesTemperatureGetProperties(zes_temp_handle_t hTemperature, zes_temp_properties_t* pProperties) {
+    if (!pProperties) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    if (g_tempPropertiesResult != ZE_RESULT_SUCCESS) return g_tempPropertiesResult;
+    *pProperties = g_mockTempProperties;
+    return ZE_RESULT_SUCCESS;
+}
+
+// Mock Implementation of `zesTemperatureGetConfig`
+ze_result_t zesTemperatureGetConfig(zes_temp_handle_t hTemperature, zes_temp_config_t* pConfig) {
+    if (!pConfig) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    if (g_tempConfigResult != ZE_RESULT_SUCCESS) return g_tempConfigResult;
+    *pConfig = g_mockTempConfig;
+    return ZE_RESULT_SUCCESS;
+}
+
+// Mock Implementation of `zesDeviceEnumFans`
+ze_result_t zesDeviceEnumFans(zes_device_handle_t hDevice, uint32_t* pCount, zes_fan_handle_t* phFan) {
+    if (!pCount) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    if (phFan) {
+        for (uint32_t i = 0; i < *pCount && i < g_fanCount; i++) {
+            phFan[i] = reinterpret_cast<zes_fan_handle_t>(static_cast<uintptr_t>(i + 1));
+        }
+    }
+    *pCount = g_fanCount;
+    return ZE_RESULT_SUCCESS;
+}
+
+// Mock Implementation of `zesFanGetProperties`
+ze_result_t zesFanGetProperties(zes_fan_handle_t hFan, zes_fan_properties_t* pProperties) {
+    if (!pProperties) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    *pProperties = g_mockFanProperties;
+    return ZE_RESULT_SUCCESS;
+}
+
+// Mock Implementation of `zesFanGetState`
+ze_result_t zesFanGetState(zes_fan_handle_t hFan, zes_fan_speed_units_t units, int32_t* pSpeed) {
+    if (!pSpeed) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    if (g_fanStateResult != ZE_RESULT_SUCCESS) return g_fanStateResult;
+    *pSpeed = g_mockFanSpeed;
+    return ZE_RESULT_SUCCESS;
+}
+
 // Helper to reset mocks between tests
+// Mock Implementation of `zesEngineGetProperties`
+ze_result_t zesEngineGetProperties(zes_engine_handle_t hEngine, zes_engine_properties_t* pProperties) {
+    if (!pProperties) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    pProperties->type = ZES_ENGINE_GROUP_COMPUTE_ALL;
+    return ZE_RESULT_SUCCESS;
+}
+
+// Mock Implementation of `zesEngineGetActivity`
+ze_result_t zesEngineGetActivity(zes_engine_handle_t hEngine, zes_engine_stats_t* pStats) {
+    if (!pStats) return ZE_RESULT_ERROR_INVALID_ARGUMENT;
+    if (g_mockEngineStats.empty()) {
+        pStats->activeTime = 0;
+        pStats->timestamp = 0;
+        return ZE_RESULT_SUCCESS;
+    }
+    *pStats = g_mockEngineStats[g_engineStatsIndex];
+    if (g_engineStatsIndex + 1 < g_mockEngineStats.size()) {
+        g_engineStatsIndex++;
+    }
+    return ZE_RESULT_SUCCESS;
+}
+
 void resetMocks() {
     g_enumSensorsResult = ZE_RESULT_SUCCESS;
     g_sensorCount = 3;
     g_getTempResult = ZE_RESULT_SUCCESS;
     g_mockTemperatures = {45.5, 52.8, 39.2};
     g_enumSensorsCalledOnce = false;
+    g_failSensorIndex = -1;
+    g_mockTempProperties = {};
+    g_tempPropertiesResult = ZE_RESULT_SUCCESS;
+    g_mockTempConfig = {};
+    g_tempConfigResult = ZE_RESULT_SUCCESS;
+    g_fanCount = 0;
+    g_mockFanProperties = {};
+    g_mockFanSpeed = 0;
+    g_fanStateResult = ZE_RESULT_SUCCESS;
+    g_mockEngineStats.clear();
+    g_engineStatsIndex = 0;
+    g_memoryBandwidthResult = ZE_RESULT_SUCCESS;
+    g_mockMemoryBandwidth.clear();
+    g_memoryBandwidthIndex = 0;
+    g_mockFrequencyState = {};
+    g_throttleTimeResult = ZE_RESULT_SUCCESS;
+    g_mockThrottleTimes.clear();
+    g_throttleTimeIndex = 0;
+    g_mockPciState = {};
+    g_pciStateResult = ZE_RESULT_SUCCESS;
+    g_pciStatsResult = ZE_RESULT_SUCCESS;
+    g_mockPciStats.clear();
+    g_pciStatsIndex = 0;
+    g_mockEnergyCounters.clear();
+    g_energyCounterIndex = 0;
+    g_mockPowerLimits.clear();
+    g_powerLimitsResult = ZE_RESULT_SUCCESS;
+    g_mockRasState = {};
+    g_mockProcesses.clear();
 }
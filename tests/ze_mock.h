@@ -9,4 +9,43 @@ extern uint32_t g_sensorCount;
 extern ze_result_t g_getTempResult;
 extern std::vector<double> g_mockTemperatures;
 extern bool g_enumSensorsCalledOnce;
+// Sensor whose zesTemperatureGetState fails with g_getTempResult, or -1 for
+// every sensor.
+extern int g_failSensorIndex;
+// Reported by zesTemperatureGetProperties and zesTemperatureGetConfig for
+// every sensor unless their results are errors.
+extern zes_temp_properties_t g_mockTempProperties;
+extern ze_result_t g_tempPropertiesResult;
+extern zes_temp_config_t g_mockTempConfig;
+extern ze_result_t g_tempConfigResult;
+// Fans reported by zesDeviceEnumFans, each with these properties and speed.
+extern uint32_t g_fanCount;
+extern zes_fan_properties_t g_mockFanProperties;
+extern int32_t g_mockFanSpeed;
+extern ze_result_t g_fanStateResult;
+// Successive zesEngineGetActivity results; the last one repeats.
+extern std::vector<zes_engine_stats_t> g_mockEngineStats;
+extern ze_result_t g_memoryBandwidthResult;
+// Successive zesMemoryGetBandwidth results; the last one repeats.
+extern std::vector<zes_mem_bandwidth_t> g_mockMemoryBandwidth;
+// Reported by zesFrequencyGetState.
+extern zes_freq_state_t g_mockFrequencyState;
+extern ze_result_t g_throttleTimeResult;
+// Successive zesFrequencyGetThrottleTime results; the last one repeats.
+extern std::vector<zes_freq_throttle_time_t> g_mockThrottleTimes;
+// Reported by zesDevicePciGetState unless g_pciStateResult is an error.
+extern zes_pci_state_t g_mockPciState;
+extern ze_result_t g_pciStateResult;
+extern ze_result_t g_pciStatsResult;
+// Successive zesDevicePciGetStats results; the last one repeats.
+extern std::vector<zes_pci_stats_t> g_mockPciStats;
+// Successive zesPowerGetEnergyCounter results; the last one repeats.
+extern std::vector<zes_power_energy_counter_t> g_mockEnergyCounters;
+// Reported by zesPowerGetLimitsExt unless g_powerLimitsResult is an error.
+extern std::vector<zes_power_limit_ext_desc_t> g_mockPowerLimits;
+extern ze_result_t g_powerLimitsResult;
+// Reported by zesRasGetState.
+extern zes_ras_state_t g_mockRasState;
+// Reported by zesDeviceProcessesGetState.
+extern std::vector<zes_process_state_t> g_mockProcesses;
 extern void resetMocks();